@@ -39,6 +39,7 @@ import nextflow.dag.NodeMarker
 import nextflow.datasource.SraExplorer
 import nextflow.exception.AbortOperationException
 import nextflow.extension.CH
+import nextflow.extension.FilePairsOp
 import nextflow.extension.GroupTupleOp
 import nextflow.extension.MapOp
 import nextflow.file.DirListener
@@ -267,7 +268,8 @@ class Channel  {
             maxDepth: Integer,
             checkIfExists: Boolean,
             glob: Boolean,
-            relative: Boolean
+            relative: Boolean,
+            parallel: [Boolean, Integer]
     ]
 
     /**
@@ -429,6 +431,7 @@ class Channel  {
      *      - maxDepth: Integer
      *      - glob: Boolean
      *      - relative: Boolean
+     *      - parallel: Boolean or number of threads
      * @param pattern
      *      One or more path patterns eg. `/some/path/*_{1,2}.fastq`
      * @return
@@ -511,12 +514,20 @@ class Channel  {
         def DEF_SIZE = anyPattern ? 2 : 1
         def size = (options?.size ?: DEF_SIZE)
         def isFlat = options?.flat == true
-        def groupOpts = [sort: true, size: size]
         def groupChannel = isFlat ? new DataflowQueue<>() : CH.create()
 
-        new GroupTupleOp(groupOpts, mapChannel)
-                .setTarget(groupChannel)
-                .apply()
+        if( options?.maxPending ) {
+            // bound the number of unmatched files held in memory
+            new FilePairsOp(mapChannel, size as int, options.maxPending as int)
+                    .setTarget(groupChannel)
+                    .apply()
+        }
+        else {
+            def groupOpts = [sort: true, size: size]
+            new GroupTupleOp(groupOpts, mapChannel)
+                    .setTarget(groupChannel)
+                    .apply()
+        }
 
         // -- flat the group resulting tuples
         DataflowWriteChannel result
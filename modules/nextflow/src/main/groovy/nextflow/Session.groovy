@@ -35,6 +35,7 @@ import groovyx.gpars.GParsConfig
 import groovyx.gpars.dataflow.operator.DataflowProcessor
 import nextflow.cache.CacheDB
 import nextflow.cache.CacheFactory
+import nextflow.cache.ResumePrefetcher
 import nextflow.conda.CondaConfig
 import nextflow.config.Manifest
 import nextflow.container.ContainerConfig
@@ -46,11 +47,13 @@ import nextflow.exception.MissingLibraryException
 import nextflow.exception.ScriptCompilationException
 import nextflow.executor.ExecutorFactory
 import nextflow.extension.CH
+import nextflow.extension.ChannelCredits
 import nextflow.file.FileHelper
 import nextflow.file.FilePorter
 import nextflow.util.Threads
 import nextflow.util.ThreadPoolManager
 import nextflow.plugin.Plugins
+import nextflow.processor.CriticalPathRanker
 import nextflow.processor.ErrorStrategy
 import nextflow.processor.TaskFault
 import nextflow.processor.TaskHandler
@@ -65,6 +68,7 @@ import nextflow.script.ScriptRunner
 import nextflow.script.WorkflowMetadata
 import nextflow.spack.SpackConfig
 import nextflow.trace.AnsiLogObserver
+import nextflow.trace.ResourcePredictor
 import nextflow.trace.TraceObserver
 import nextflow.trace.TraceObserverFactory
 import nextflow.trace.TraceRecord
@@ -196,6 +200,12 @@ class Session implements ISession {
 
     private CacheDB cache
 
+    private ResourcePredictor resourcePredictor
+
+    private CriticalPathRanker criticalPathRanker
+
+    private ResumePrefetcher resumePrefetcher
+
     private Barrier processesBarrier = new Barrier()
 
     private Barrier monitorsBarrier = new Barrier()
@@ -292,6 +302,12 @@ class Session implements ISession {
 
     CacheDB getCache() { cache }
 
+    ResourcePredictor getResourcePredictor() { resourcePredictor }
+
+    CriticalPathRanker getCriticalPathRanker() { criticalPathRanker }
+
+    ResumePrefetcher getResumePrefetcher() { resumePrefetcher }
+
     /**
      * Creates a new session using the configuration properties provided
      *
@@ -380,6 +396,9 @@ class Session implements ISession {
         this.disableRemoteBinDir = getExecConfigProp(null, 'disableRemoteBinDir', false)
         this.classesDir = FileHelper.createLocalDir()
         this.executorFactory = new ExecutorFactory(Plugins.manager)
+        // note: the predictor needs to be created before opening the cache of this session
+        this.resourcePredictor = createResourcePredictor(scriptFile)
+        this.criticalPathRanker = createCriticalPathRanker(scriptFile)
         this.observers = createObservers()
         this.statsEnabled = observers.any { it.enableMetrics() }
         this.workflowMetadata = new WorkflowMetadata(this, scriptFile)
@@ -389,6 +408,8 @@ class Session implements ISession {
         binding.setArgs( new ScriptRunner.ArgsList(args) )
 
         cache = CacheFactory.create(uniqueId,runName).open()
+        // start loading the cached tasks of the previous run while the pipeline is being set up
+        this.resumePrefetcher = createResumePrefetcher()
 
         return this
     }
@@ -402,6 +423,33 @@ class Session implements ISession {
         new ProcessFactory(script, this)
     }
 
+    protected CriticalPathRanker createCriticalPathRanker(ScriptFile scriptFile) {
+        final policy = getExecConfigProp(null, 'submitPolicy', 'fifo') as String
+        if( policy == 'fifo' )
+            return null
+        if( policy != CriticalPathRanker.POLICY )
+            throw new AbortOperationException("Unknown executor submitPolicy: '$policy' -- it must be either 'fifo' or '${CriticalPathRanker.POLICY}'")
+        // note: as for the resource predictor the history needs to be loaded before opening the cache of this session
+        final history = HistoryFile.disabled() ? null : HistoryFile.DEFAULT
+        final revisionId = scriptFile ? (scriptFile.commitId ?: scriptFile.scriptId) : null
+        return CriticalPathRanker.create(dag, history, revisionId, runName)
+    }
+
+    protected ResumePrefetcher createResumePrefetcher() {
+        if( !resumeMode || !(getExecConfigProp(null, 'resumePrefetch', false) as boolean) )
+            return null
+        final history = HistoryFile.disabled() ? null : HistoryFile.DEFAULT
+        final previous = ResumePrefetcher.findPreviousRun(history, uniqueId, runName)
+        if( !previous ) {
+            log.debug "Resume prefetcher > unable to find the previous run of session: $uniqueId"
+            return null
+        }
+        final threads = getExecConfigProp(null, 'resumePrefetchThreads', ResumePrefetcher.DEFAULT_THREADS) as Integer
+        final size = getExecConfigProp(null, 'resumePrefetchSize', ResumePrefetcher.DEFAULT_MAX_ENTRIES) as Integer
+        log.debug "Creating resume prefetcher > run: $previous; threads: $threads; size: $size"
+        return new ResumePrefetcher(cache, previous, threads, size).start()
+    }
+
     /**
      * Given the `run` command line options creates the required {@link TraceObserver}s
      *
@@ -425,6 +473,15 @@ class Session implements ISession {
         return result
     }
 
+    protected ResourcePredictor createResourcePredictor(ScriptFile scriptFile) {
+        final opts = config.resourcePredictor as Map
+        if( !opts?.enabled )
+            return null
+        final history = HistoryFile.disabled() ? null : HistoryFile.DEFAULT
+        final revisionId = scriptFile ? (scriptFile.commitId ?: scriptFile.scriptId) : null
+        return ResourcePredictor.create(opts, history, revisionId, runName)
+    }
+
 
     /*
      * intercepts interruption signal i.e. CTRL+C
@@ -497,7 +554,11 @@ class Session implements ISession {
     String dumpNetworkStatus() {
         try {
             def msg = dag.dumpActiveNodes()
-            msg ? "The following nodes are still active:\n" + msg : null
+            def result = msg ? "The following nodes are still active:\n" + msg : null
+            def depths = ChannelCredits.dumpDepths()
+            if( depths )
+                result = (result ? result + '\n' : '') + "Bounded channels depth:\n" + depths
+            return result
         }
         catch( Exception e ) {
             log.debug "Unexpected error while dumping DAG status", e
@@ -655,6 +716,7 @@ class Session implements ISession {
             log.trace "Session > executor shutdown"
 
             // -- close db
+            resumePrefetcher?.close()
             cache?.close()
 
             // -- shutdown plugins
@@ -759,6 +821,7 @@ class Session implements ISession {
             processesBarrier.forceTermination()
             monitorsBarrier.forceTermination()
             operatorsForceTermination()
+            ChannelCredits.closeAll()
         }
         catch( Throwable e ) {
             log.debug "Unexpected error while aborting execution", e
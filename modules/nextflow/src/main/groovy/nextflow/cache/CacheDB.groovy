@@ -17,6 +17,10 @@
 
 package nextflow.cache
 
+import java.util.concurrent.Callable
+import java.util.concurrent.ExecutionException
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Future
 
 import com.google.common.hash.HashCode
 import groovy.transform.CompileStatic
@@ -79,17 +83,28 @@ class CacheDB implements Closeable {
      */
     TaskEntry getTaskEntry(HashCode taskHash, TaskProcessor processor) {
 
-        final payload = store.getEntry(taskHash)
-        if( !payload )
+        final record = getTaskRecord(taskHash)
+        if( record == null )
             return null
 
-        final record = (List)KryoHelper.deserialize(payload)
         TraceRecord trace = TraceRecord.deserialize( (byte[])record[0] )
         TaskContext ctx = record[1]!=null && processor!=null ? TaskContext.deserialize(processor, (byte[])record[1]) : null
 
         return new TaskEntry(trace,ctx)
     }
 
+    /**
+     * Retrieve the raw record of a task from the cache DB i.e. the serialized trace record,
+     * the serialized task context and the reference count
+     *
+     * @param taskHash The {@link HashCode} of the task to retrieve
+     * @return The list of the record fields or {@code null} if a task for the given hash does not exist
+     */
+    List getTaskRecord(HashCode taskHash) {
+        final payload = store.getEntry(taskHash)
+        return payload ? (List)KryoHelper.deserialize(payload) : null
+    }
+
     void incTaskEntry( HashCode hash ) {
         final payload = store.getEntry(hash)
         if( !payload ) {
@@ -126,6 +141,38 @@ class CacheDB implements Closeable {
         }
     }
 
+    /**
+     * Decrement the reference count of a set of task entries, deleting the ones
+     * no longer referenced. All changes are committed with a single batched write
+     *
+     * @param hashes The hash codes of the task entries to remove
+     * @return The hash codes of the entries that have been deleted
+     */
+    Set<HashCode> removeTaskEntries( Collection<HashCode> hashes ) {
+        final updated = new LinkedHashMap<HashCode,byte[]>()
+        final deleted = new LinkedHashSet<HashCode>()
+        for( HashCode hash : hashes ) {
+            final payload = deleted.contains(hash) ? null : (updated.get(hash) ?: store.getEntry(hash))
+            if( !payload ) {
+                log.debug "Can't decrement reference for cached task with key: $hash"
+                continue
+            }
+
+            final record = (List)KryoHelper.deserialize(payload)
+            // third record contains the reference count for this record
+            def count = record[2] = ((Integer)record[2]) -1
+            if( count > 0 ) {
+                updated.put(hash, KryoHelper.serialize(record))
+            }
+            else {
+                updated.remove(hash)
+                deleted.add(hash)
+            }
+        }
+        store.writeBatch(updated, deleted)
+        return deleted
+    }
+
 
     /**
      * Save task runtime information to th cache DB
@@ -181,6 +228,17 @@ class CacheDB implements Closeable {
         store.drop()
     }
 
+    /**
+     * Iterate the index of another run of the same session
+     *
+     * @param runName The name of the run to which the index belongs
+     * @param action The closure invoked with each {@link CacheStore.Index} entry
+     * @return {@code false} if the index of the specified run does not exist, {@code true} otherwise
+     */
+    boolean eachIndex( String runName, Closure action ) {
+        return store.eachIndex(runName, action)
+    }
+
     /**
      * Iterate the tasks cache using the index file
      * @param closure The operation to applied
@@ -223,6 +281,67 @@ class CacheDB implements Closeable {
         return this
     }
 
+    /**
+     * Iterate the tasks cache using the index file, decoding the cache entries concurrently.
+     * Entries are read sequentially from the store and decoded by the given executor, keeping
+     * at most {@code window} entries in flight. Results are passed to the consumer in the index order
+     *
+     * @param executor The {@link ExecutorService} used to decode the cache entries
+     * @param window The max number of entries decoded concurrently
+     * @param transform
+     *      A closure applied by the decoding thread to each {@link TraceRecord}, a {@code null} result
+     *      discards the record
+     * @param consumer
+     *      A closure invoked by the calling thread with the task hash and the transformed record
+     * @return The {@link CacheDB} instance itself
+     */
+    CacheDB eachRecord( ExecutorService executor, int window, Closure transform, Closure consumer ) {
+        assert executor
+        assert window>0
+
+        final keys = new ArrayDeque<HashCode>(window)
+        final results = new ArrayDeque<Future<Object>>(window)
+        final itr = store.iterateIndex()
+        while( itr.hasNext() ) {
+            final index = itr.next()
+
+            final payload = store.getEntry(index.key)
+            if( !payload ) {
+                log.trace "Unable to retrieve cache record for key: ${-> index.key}"
+                continue
+            }
+
+            keys.add(index.key)
+            results.add( executor.submit( { transform.call(decodeTraceRecord(payload, index.cached)) } as Callable<Object> ) )
+            if( results.size() >= window )
+                consume0(keys.poll(), results.poll(), consumer)
+        }
+
+        while( results.size() )
+            consume0(keys.poll(), results.poll(), consumer)
+
+        return this
+    }
+
+    static private void consume0( HashCode key, Future<Object> result, Closure consumer ) {
+        Object value
+        try {
+            value = result.get()
+        }
+        catch( ExecutionException e ) {
+            throw e.cause
+        }
+        if( value != null )
+            consumer.call(key, value)
+    }
+
+    static private TraceRecord decodeTraceRecord( byte[] payload, boolean cached ) {
+        final record = (List<byte[]>)KryoHelper.deserialize(payload)
+        final trace = TraceRecord.deserialize(record[0])
+        trace.setCached(cached)
+        return trace
+    }
+
     TraceRecord getTraceRecord( HashCode hashCode ) {
         final result = getTaskEntry(hashCode, null)
         return result ? result.trace : null
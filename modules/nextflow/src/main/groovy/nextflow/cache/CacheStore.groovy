@@ -17,8 +17,12 @@
 
 package nextflow.cache
 
+import java.nio.file.Files
+import java.nio.file.Path
+
 import com.google.common.hash.HashCode
 import groovy.transform.TupleConstructor
+import nextflow.util.CacheHelper
 
 /**
  * Defines the contract for a pluggable cache storage
@@ -31,6 +35,36 @@ interface CacheStore {
     static class Index {
         final HashCode key
         final boolean cached
+
+        /**
+         * Read an index file, made of a sequence of entries each holding the key bytes followed by the cached flag
+         *
+         * @param file The index file
+         * @param action The closure invoked with each {@link Index} entry
+         * @return {@code false} if the index file does not exist, {@code true} otherwise
+         */
+        static boolean eachEntry(Path file, Closure action) {
+            if( !file.exists() )
+                return false
+            final keySize = CacheHelper.hasher('x').hash().asBytes().size()
+            final stream = new DataInputStream(new BufferedInputStream(Files.newInputStream(file)))
+            try {
+                while( true ) {
+                    final key = new byte[keySize]
+                    try {
+                        stream.readFully(key)
+                    }
+                    catch( EOFException e ) {
+                        break
+                    }
+                    action.call(new Index(HashCode.fromBytes(key), stream.readBoolean()))
+                }
+            }
+            finally {
+                stream.close()
+            }
+            return true
+        }
     }
 
     CacheStore open()
@@ -42,8 +76,25 @@ interface CacheStore {
     void putEntry(HashCode key, byte[] value)
     void deleteEntry(HashCode key)
 
+    /**
+     * Apply a set of updates and deletions as a single write operation
+     *
+     * @param entries The entries to put in the store
+     * @param deleted The keys of the entries to delete
+     */
+    void writeBatch(Map<HashCode,byte[]> entries, Collection<HashCode> deleted)
+
     void writeIndex(HashCode key, boolean cached)
     Iterator<Index> iterateIndex()
+
+    /**
+     * Iterate the index of another run of the same session
+     *
+     * @param runName The name of the run to which the index belongs
+     * @param action The closure invoked with each {@link Index} entry
+     * @return {@code false} if the index of the specified run does not exist, {@code true} otherwise
+     */
+    boolean eachIndex(String runName, Closure action)
     void deleteIndex()
 
 }
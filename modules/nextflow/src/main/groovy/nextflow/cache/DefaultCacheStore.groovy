@@ -172,6 +172,11 @@ class DefaultCacheStore implements CacheStore {
         }
     }
 
+    @Override
+    boolean eachIndex(String name, Closure action) {
+        return Index.eachEntry(dataDir.resolve("index.$name"), action)
+    }
+
     @Override
     byte[] getEntry(HashCode key) {
         return db.get(key.asBytes())
@@ -186,4 +191,19 @@ class DefaultCacheStore implements CacheStore {
     void deleteEntry(HashCode key) {
         db.delete(key.asBytes())
     }
+
+    @Override
+    void writeBatch(Map<HashCode,byte[]> entries, Collection<HashCode> deleted) {
+        final batch = db.createWriteBatch()
+        try {
+            for( Map.Entry<HashCode,byte[]> entry : entries.entrySet() )
+                batch.put(entry.key.asBytes(), entry.value)
+            for( HashCode key : deleted )
+                batch.delete(key.asBytes())
+            db.write(batch)
+        }
+        finally {
+            batch.close()
+        }
+    }
 }
@@ -0,0 +1,334 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.cache
+
+import java.nio.file.Path
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+import java.util.concurrent.Semaphore
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.LongAdder
+
+import com.google.common.hash.HashCode
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+import nextflow.file.FileHelper
+import nextflow.processor.TaskContext
+import nextflow.processor.TaskEntry
+import nextflow.processor.TaskProcessor
+import nextflow.processor.TaskRun
+import nextflow.trace.TraceRecord
+import nextflow.util.CustomThreadFactory
+import nextflow.util.HistoryFile
+/**
+ * Loads the cache entries of the previous run of a resumed session ahead of time.
+ *
+ * The index of the previous run is streamed by a background thread when the session
+ * starts, while a pool of workers fetches each task entry from the cache DB, checks
+ * its work directory and reads the task exit status. The results are kept in a concurrent
+ * map and handed over to the task processors when they check the cache of a task,
+ * so that the lookups of independent tasks overlap instead of running one at a time
+ * on the operator threads.
+ *
+ * The number of entries loaded and not yet requested is bounded. When the bound is reached
+ * and no entry is taken for a while, the oldest entries are evicted so that entries of tasks
+ * never requested by the current run do not stop the prefetching. Entries not available
+ * when requested are looked up by the task processor as usual.
+ */
+@Slf4j
+@CompileStatic
+class ResumePrefetcher implements Closeable {
+
+    static final public int DEFAULT_THREADS = 8
+
+    static final public int DEFAULT_MAX_ENTRIES = 10_000
+
+    /**
+     * A task cache entry loaded ahead of time
+     */
+    @CompileStatic
+    static class Entry {
+
+        final TraceRecord trace
+
+        /** The serialized task context, it can only be decoded by the owning task processor */
+        final byte[] context
+
+        final Path workDir
+
+        final boolean exists
+
+        final private String exitText
+
+        final private IOException exitError
+
+        Entry(TraceRecord trace, byte[] context, Path workDir, boolean exists, String exitText, IOException exitError) {
+            this.trace = trace
+            this.context = context
+            this.workDir = workDir
+            this.exists = exists
+            this.exitText = exitText
+            this.exitError = exitError
+        }
+
+        /**
+         * @return The content of the task exit file as read when the entry was loaded
+         * @throws IOException when the exit file could not be read
+         */
+        String getExitText() throws IOException {
+            if( exitError )
+                throw exitError
+            return exitText
+        }
+
+        TaskEntry toTaskEntry(TaskProcessor processor) {
+            final ctx = context!=null && processor!=null ? TaskContext.deserialize(processor, context) : null
+            return new TaskEntry(trace, ctx)
+        }
+    }
+
+    private final CacheDB cache
+
+    private final String runName
+
+    private final int threads
+
+    private final int maxEntries
+
+    private final Semaphore available
+
+    /** The loaded entries in load order, access is synchronized on the map itself */
+    private final Map<HashCode,Entry> entries = new LinkedHashMap<>()
+
+    private final Set<HashCode> requested = ConcurrentHashMap.<HashCode>newKeySet()
+
+    private final LongAdder loaded = new LongAdder()
+
+    private final LongAdder hits = new LongAdder()
+
+    private final LongAdder misses = new LongAdder()
+
+    private final LongAdder evicted = new LongAdder()
+
+    /**
+     * How long the index reader waits for an entry to be taken before evicting the oldest ones
+     */
+    @PackageScope
+    long evictDelayMillis = 5_000
+
+    private ExecutorService workers
+
+    private Thread reader
+
+    private volatile boolean terminated
+
+    /**
+     * Create the prefetcher
+     *
+     * @param cache The {@link CacheDB} of the current session
+     * @param runName The name of the previous run of the session whose index is loaded
+     * @param threads The number of threads used to load the cache entries
+     * @param maxEntries The max number of entries loaded and not yet requested
+     */
+    ResumePrefetcher(CacheDB cache, String runName, int threads=DEFAULT_THREADS, int maxEntries=DEFAULT_MAX_ENTRIES) {
+        if( threads < 1 )
+            throw new IllegalArgumentException("Invalid resume prefetch threads value: $threads -- it must be a positive integer")
+        if( maxEntries < 1 )
+            throw new IllegalArgumentException("Invalid resume prefetch size value: $maxEntries -- it must be a positive integer")
+        this.cache = cache
+        this.runName = runName
+        this.threads = threads
+        this.maxEntries = maxEntries
+        this.available = new Semaphore(maxEntries)
+    }
+
+    /**
+     * Find the name of the previous run of a session
+     *
+     * @param history The history file, it may be {@code null}
+     * @param sessionId The session unique id
+     * @param runName The name of the current run
+     * @return The name of the latest run of the session other than the current one or {@code null} if not found
+     */
+    static String findPreviousRun(HistoryFile history, UUID sessionId, String runName) {
+        if( !history?.exists() )
+            return null
+        final runs = history.findAll().findAll { HistoryFile.Record it -> it.sessionId == sessionId && it.runName != runName }
+        return runs ? runs.last().runName : null
+    }
+
+    ResumePrefetcher start() {
+        workers = Executors.newFixedThreadPool(threads, new CustomThreadFactory('ResumePrefetcher'))
+        reader = new Thread(this.&readIndex as Runnable, 'Resume prefetcher')
+        reader.setDaemon(true)
+        reader.start()
+        return this
+    }
+
+    protected void readIndex() {
+        try {
+            final found = cache.eachIndex(runName) { CacheStore.Index index -> submit(index.key) }
+            if( !found )
+                log.debug "Resume prefetcher > missing cache index of run: $runName"
+        }
+        catch( InterruptedException e ) {
+            log.trace "Resume prefetcher > interrupted"
+        }
+        catch( Throwable e ) {
+            if( !terminated )
+                log.debug "Resume prefetcher > unable to read cache index of run: $runName", e
+        }
+    }
+
+    protected void submit(HashCode hash) {
+        while( !available.tryAcquire(evictDelayMillis, TimeUnit.MILLISECONDS) ) {
+            if( terminated )
+                throw new InterruptedException()
+            // no entry was taken in the meantime, likely the oldest ones are never going to be requested
+            evict(Math.max(1, maxEntries.intdiv(10)))
+        }
+        if( terminated )
+            throw new InterruptedException()
+        workers.execute({ load0(hash) } as Runnable)
+    }
+
+    /**
+     * Discard the oldest loaded entries not yet requested
+     *
+     * @param count The max number of entries to discard
+     */
+    @PackageScope
+    void evict(int count) {
+        int removed = 0
+        synchronized (entries) {
+            final itr = entries.keySet().iterator()
+            while( removed < count && itr.hasNext() ) {
+                itr.next()
+                itr.remove()
+                removed++
+            }
+        }
+        if( !removed )
+            return
+        available.release(removed)
+        if( evicted.sum() == 0 )
+            log.debug "Resume prefetcher > reached max entries: $maxEntries -- evicting the oldest entries not requested"
+        evicted.add(removed)
+        log.trace "Resume prefetcher > evicted entries: $removed"
+    }
+
+    protected void load0(HashCode hash) {
+        Entry entry = null
+        try {
+            if( !terminated && !requested.contains(hash) )
+                entry = load(hash)
+        }
+        catch( Throwable e ) {
+            log.debug "Resume prefetcher > unable to load cache entry: $hash -- cause: ${e.message ?: e}"
+        }
+
+        if( entry == null ) {
+            available.release()
+            return
+        }
+        synchronized (entries) {
+            // the entry may have been requested in the meantime, in that case nobody is going to take it
+            if( requested.contains(hash) || entries.containsKey(hash) ) {
+                available.release()
+                return
+            }
+            entries.put(hash, entry)
+        }
+        loaded.increment()
+    }
+
+    /**
+     * Load a task cache entry and check the task work directory
+     *
+     * @param hash The task hash code
+     * @return The {@link Entry} object or {@code null} if no entry exists for the given hash
+     */
+    @PackageScope
+    Entry load(HashCode hash) {
+        final record = cache.getTaskRecord(hash)
+        if( record == null )
+            return null
+        final trace = TraceRecord.deserialize((byte[])record[0])
+        final workDir = trace.getWorkDir() ? FileHelper.asPath(trace.getWorkDir()) : null
+        final exists = workDir!=null && workDir.exists()
+        String exitText = null
+        IOException exitError = null
+        if( exists ) {
+            try {
+                exitText = workDir.resolve(TaskRun.CMD_EXIT).text?.trim()
+            }
+            catch( IOException e ) {
+                exitError = e
+            }
+        }
+        return new Entry(trace, (byte[])record[1], workDir, exists, exitText, exitError)
+    }
+
+    /**
+     * Take the prefetched cache entry of a task. Each entry can be taken only once, any
+     * later request for the same hash returns {@code null}
+     *
+     * @param hash The task hash code
+     * @return The prefetched {@link Entry} or {@code null} if the entry is not (yet) available
+     */
+    Entry take(HashCode hash) {
+        requested.add(hash)
+        Entry result
+        synchronized (entries) {
+            result = entries.remove(hash)
+        }
+        if( result != null ) {
+            available.release()
+            hits.increment()
+        }
+        else
+            misses.increment()
+        return result
+    }
+
+    long getLoadedCount() { loaded.sum() }
+
+    long getHitCount() { hits.sum() }
+
+    long getMissCount() { misses.sum() }
+
+    long getEvictedCount() { evicted.sum() }
+
+    /**
+     * Stop loading cache entries and discard the ones not requested
+     */
+    @Override
+    void close() {
+        terminated = true
+        reader?.interrupt()
+        workers?.shutdownNow()
+        workers?.awaitTermination(10, TimeUnit.SECONDS)
+        reader?.join(1_000)
+        synchronized (entries) {
+            log.debug "Resume prefetcher > loaded: ${loaded.sum()}; hits: ${hits.sum()}; misses: ${misses.sum()}; evicted: ${evicted.sum()}; unused: ${entries.size()}"
+            entries.clear()
+        }
+    }
+
+}
@@ -15,13 +15,23 @@
  */
 
 package nextflow.cli
+import java.nio.file.DirectoryStream
+import java.nio.file.FileSystems
 import java.nio.file.FileVisitResult
 import java.nio.file.FileVisitor
 import java.nio.file.Files
+import java.nio.file.LinkOption
 import java.nio.file.NoSuchFileException
+import java.nio.file.NotDirectoryException
 import java.nio.file.Path
 import java.nio.file.Paths
+import java.nio.file.SecureDirectoryStream
+import java.nio.file.attribute.BasicFileAttributeView
 import java.nio.file.attribute.BasicFileAttributes
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.ThreadPoolExecutor
+import java.util.concurrent.TimeUnit
 
 import com.beust.jcommander.Parameter
 import com.beust.jcommander.Parameters
@@ -37,6 +47,7 @@ import nextflow.exception.AbortOperationException
 import nextflow.file.FileHelper
 import nextflow.plugin.Plugins
 import nextflow.trace.TraceRecord
+import nextflow.util.CustomThreadFactory
 import nextflow.util.HistoryFile.Record
 
 /**
@@ -52,6 +63,8 @@ class CmdClean extends CmdBase implements CacheBase {
 
     static final public NAME = 'clean'
 
+    static final private int BATCH_SIZE = 1_000
+
     @Parameter(names=['-q', '-quiet'], description = 'Do not print names of files removed', arity = 0)
     boolean quiet
 
@@ -73,6 +86,9 @@ class CmdClean extends CmdBase implements CacheBase {
     @Parameter(names=['-k', '-keep-logs'], description = 'Removes only temporary files but retains execution log entries and metadata')
     boolean keepLogs
 
+    @Parameter(names=['-t', '-threads'], description = 'Max number of threads used to delete the task work directories (default: number of available cpus)')
+    Integer threads
+
     @Parameter
     List<String> args
 
@@ -80,6 +96,12 @@ class CmdClean extends CmdBase implements CacheBase {
 
     private Map<HashCode, Short> dryHash = new HashMap<>()
 
+    private List<HashCode> batchHashes = new ArrayList<>(BATCH_SIZE)
+
+    private List<TraceRecord> batchRecords = new ArrayList<>(BATCH_SIZE)
+
+    private ExecutorService deleter
+
     /**
      * @return The name of this command {@code clean}
      */
@@ -134,8 +156,19 @@ class CmdClean extends CmdBase implements CacheBase {
      */
     private void cleanup(Record entry) {
         currentCacheDb = cacheFor(entry).openForRead()
+        if( !dryRun )
+            deleter = createDeleter()
         // -- remove each entry and work dir
-        currentCacheDb.eachRecord(this.&removeRecord)
+        try {
+            currentCacheDb.eachRecord(this.&removeRecord)
+            removeBatch()
+        }
+        finally {
+            // -- wait for the work dirs deletion to complete
+            deleter?.shutdown()
+            deleter?.awaitTermination(Long.MAX_VALUE, TimeUnit.MILLISECONDS)
+            deleter = null
+        }
         // -- close the cache
         currentCacheDb.close()
 
@@ -181,7 +214,23 @@ class CmdClean extends CmdBase implements CacheBase {
     }
 
     /**
-     * Delete task cache entry
+     * Create the bounded thread pool deleting the task work directories. When the pool
+     * queue is full the deletion is carried out by the thread reading the cache records,
+     * so that the number of records held in memory is bounded
+     */
+    private ExecutorService createDeleter() {
+        final n = threads ?: Runtime.runtime.availableProcessors()
+        return new ThreadPoolExecutor(
+                n, n,
+                60L, TimeUnit.SECONDS,
+                new LinkedBlockingQueue<Runnable>(BATCH_SIZE),
+                new CustomThreadFactory('CmdClean'),
+                new ThreadPoolExecutor.CallerRunsPolicy())
+    }
+
+    /**
+     * Delete task cache entry. Records are collected in batches of {@link #BATCH_SIZE}
+     * entries, see {@link #removeBatch()}
      *
      * @param hash The task unique hash code
      * @param record The task {@link TraceRecord}
@@ -194,14 +243,40 @@ class CmdClean extends CmdBase implements CacheBase {
             return
         }
 
-        // decrement the ref count in the db
-        def proceed = keepLogs || currentCacheDb.removeTaskEntry(hash)
-        if( proceed ) {
-            // delete folder
-            if( deleteFolder(FileHelper.asPath(record.workDir), keepLogs)) {
-                if(!quiet) printMessage(record.workDir,false)
+        batchHashes.add(hash)
+        batchRecords.add(record)
+        if( batchHashes.size() >= BATCH_SIZE )
+            removeBatch()
+    }
+
+    /**
+     * Decrement the ref count of the current batch of records in the db with a single write
+     * and submit the deletion of the work dirs no longer referenced
+     */
+    private void removeBatch() {
+        if( !batchHashes )
+            return
+        final removed = keepLogs ? null : currentCacheDb.removeTaskEntries(batchHashes)
+        for( int i=0; i<batchHashes.size(); i++ ) {
+            final proceed = keepLogs || removed.contains(batchHashes[i])
+            if( proceed ) {
+                final workDir = batchRecords[i].workDir
+                deleter.execute({ removeWorkDir(workDir) } as Runnable)
             }
+        }
+        batchHashes.clear()
+        batchRecords.clear()
+    }
 
+    private void removeWorkDir(String workDir) {
+        try {
+            if( deleteFolder(FileHelper.asPath(workDir), keepLogs)) {
+                if(!quiet) printMessage(workDir,false)
+            }
+        }
+        catch( Exception e ) {
+            log.debug("Failed to remove path: $workDir", e)
+            if(!quiet) System.err.println "Failed to remove ${workDir}"
         }
     }
 
@@ -223,6 +298,91 @@ class CmdClean extends CmdBase implements CacheBase {
      *      {@code true} in the directory was removed, {@code false}  otherwise
      */
     private boolean deleteFolder( Path folder, boolean keepLogs ) {
+        if( !keepLogs && folder.getFileSystem() == FileSystems.getDefault() )
+            return deleteLocalFolder(folder)
+        return walkAndDelete(folder, keepLogs)
+    }
+
+    /**
+     * Delete a local directory using a {@link SecureDirectoryStream} when supported by the platform,
+     * so that entries are removed with {@code unlinkat} relative to the parent directory descriptor
+     * without resolving the full path of each file
+     *
+     * @param folder
+     *      The directory to delete
+     * @return
+     *      {@code true} in the directory was removed, {@code false}  otherwise
+     */
+    private boolean deleteLocalFolder( Path folder ) {
+        BasicFileAttributes attrs
+        try {
+            attrs = Files.readAttributes(folder, BasicFileAttributes, LinkOption.NOFOLLOW_LINKS)
+        }
+        catch( NoSuchFileException e ) {
+            return true
+        }
+        catch( IOException e ) {
+            return walkAndDelete(folder, false)
+        }
+        // a linked work dir is removed without touching the link target
+        if( !attrs.isDirectory() )
+            return delete0(folder,false)
+
+        DirectoryStream<Path> stream
+        try {
+            stream = Files.newDirectoryStream(folder)
+        }
+        catch( NotDirectoryException | NoSuchFileException e ) {
+            return walkAndDelete(folder, false)
+        }
+
+        if( !(stream instanceof SecureDirectoryStream) ) {
+            stream.close()
+            return walkAndDelete(folder, false)
+        }
+
+        try {
+            deleteContent((SecureDirectoryStream<Path>)stream)
+        }
+        catch( IOException e ) {
+            log.debug("Failed to remove path: ${folder.toUriString()}", e)
+            if(!quiet) System.err.println "Failed to remove ${folder.toUriString()}"
+            return false
+        }
+        finally {
+            stream.close()
+        }
+
+        if( !delete0(folder,true) ) {
+            if(!quiet) System.err.println "Failed to remove ${folder.toUriString()}"
+            return false
+        }
+        return true
+    }
+
+    static private void deleteContent( SecureDirectoryStream<Path> stream ) throws IOException {
+        for( Path entry : stream ) {
+            final name = entry.getFileName()
+            final attrs = stream
+                    .getFileAttributeView(name, BasicFileAttributeView, LinkOption.NOFOLLOW_LINKS)
+                    .readAttributes()
+            if( attrs.isDirectory() ) {
+                final child = stream.newDirectoryStream(name, LinkOption.NOFOLLOW_LINKS)
+                try {
+                    deleteContent(child)
+                }
+                finally {
+                    child.close()
+                }
+                stream.deleteDirectory(name)
+            }
+            else {
+                stream.deleteFile(name)
+            }
+        }
+    }
+
+    private boolean walkAndDelete( Path folder, boolean keepLogs ) {
 
         def result = true
         Files.walkFileTree(folder, new FileVisitor<Path>() {
@@ -16,11 +16,15 @@
 
 package nextflow.cli
 import java.nio.file.Path
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+import java.util.function.Supplier
 
 import ch.artecat.grengine.Grengine
 import com.beust.jcommander.Parameter
 import com.beust.jcommander.Parameters
 import com.google.common.hash.HashCode
+import groovy.json.JsonOutput
 import groovy.text.Template
 import groovy.transform.CompileStatic
 import groovy.util.logging.Slf4j
@@ -31,6 +35,8 @@ import nextflow.processor.TaskRun
 import nextflow.processor.TaskTemplateEngine
 import nextflow.trace.TraceRecord
 import nextflow.ui.TableBuilder
+import nextflow.util.CustomThreadFactory
+import nextflow.util.HistoryFile
 
 import static nextflow.cli.CmdHelper.fixEqualsOp
 
@@ -48,6 +54,8 @@ class CmdLog extends CmdBase implements CacheBase {
 
     static private DEFAULT_FIELDS = 'workdir'
 
+    static private List<String> FILE_FIELDS = ['stdout', 'stderr', 'log']
+
     static {
         ALL_FIELDS = []
         ALL_FIELDS.addAll( TraceRecord.FIELDS.keySet().collect { it.startsWith('%') ? 'p'+it.substring(1) : it } )
@@ -86,17 +94,28 @@ class CmdLog extends CmdBase implements CacheBase {
     @Parameter(names=['-q','-quiet'], description = 'Show only run names', arity = 0)
     boolean quiet
 
+    @Parameter(names=['-json'], description = 'Print each log entry as a JSON object, one per line', arity = 0)
+    boolean json
+
     @Parameter(description = 'Run name or session id')
     List<String> args
 
-    private Script filterScript
+    private Grengine filterEngine
+
+    private String filterCode
+
+    private ThreadLocal<Script> filterScript
 
     private boolean showHistory
 
-    private Template templateScript
+    private ThreadLocal<Template> templateScript
+
+    private List<String> projection
 
     private Map<HashCode,Boolean> printed = new HashMap<>()
 
+    private PrintWriter writer
+
     @Override
     final String getName() { NAME }
 
@@ -109,6 +128,8 @@ class CmdLog extends CmdBase implements CacheBase {
         //
         if( fields && templateStr )
             throw new AbortOperationException("Options `-f` and `-t` cannot be used in the same command")
+        if( json && templateStr )
+            throw new AbortOperationException("Options `-json` and `-t` cannot be used in the same command")
 
         //
         // when no CLI options have been specified, just show the history log
@@ -117,8 +138,11 @@ class CmdLog extends CmdBase implements CacheBase {
         //
         // initialise filter engine
         //
+        // note: scripts are not thread safe, therefore a copy is created for each decoding thread
         if( filterStr ) {
-            filterScript = new Grengine().create("{ it -> ${fixEqualsOp(filterStr)} }")
+            filterEngine = new Grengine()
+            filterCode = "{ it -> ${fixEqualsOp(filterStr)} }".toString()
+            filterScript = ThreadLocal.withInitial({ filterEngine.create(filterCode) } as Supplier<Script>)
         }
 
         //
@@ -126,13 +150,15 @@ class CmdLog extends CmdBase implements CacheBase {
         //
         if( !templateStr ) {
             if( !fields ) fields = DEFAULT_FIELDS
-            templateStr = fields.tokenize(',  \n').collect { '$'+it } .join(sep)
+            projection = fields.tokenize(',  \n')
+            templateStr = projection.collect { '$'+it } .join(sep)
         }
         else if( new File(templateStr).exists() ) {
             templateStr = new File(templateStr).text
         }
 
-        templateScript = new TaskTemplateEngine().createTemplate(templateStr)
+        final text = templateStr
+        templateScript = ThreadLocal.withInitial({ new TaskTemplateEngine().createTemplate(text) } as Supplier<Template>)
     }
 
     /**
@@ -156,43 +182,105 @@ class CmdLog extends CmdBase implements CacheBase {
         }
 
         // -- main
-        listIds().each { entry ->
+        final threads = Runtime.runtime.availableProcessors()
+        final executor = Executors.newFixedThreadPool(threads, new CustomThreadFactory('CmdLog'))
+        writer = new PrintWriter(new BufferedWriter(new OutputStreamWriter(System.out)))
+        try {
+            listIds().each { entry -> printRecords(entry, executor, threads * 64) }
+        }
+        finally {
+            writer.flush()
+            executor.shutdownNow()
+        }
 
-            cacheFor(entry)
-                        .openForRead()
-                        .eachRecord(this.&printRecord)
-                        .close()
+    }
 
+    /**
+     * Print the log records of a run. Cache entries are decoded, filtered and rendered
+     * by the executor threads, while the output is written by the calling thread in the
+     * cache index order
+     */
+    protected void printRecords(HistoryFile.Record entry, ExecutorService executor, int window) {
+        final db = cacheFor(entry).openForRead()
+        try {
+            db.eachRecord(executor, window, this.&renderRecord, this.&printLine)
+        }
+        finally {
+            db.close()
+            writer.flush()
         }
-
     }
 
     /**
-     * Print a log {@link TraceRecord} the the standard output by using the specified {@link #templateStr}
+     * Print a rendered log record unless a record of the same task has already been printed,
+     * since the same task can be reported by more than one run. Records discarded by the
+     * filter are not rendered and therefore do not prevent a later record of the same task
+     * to be printed
      *
-     * @param record A {@link TraceRecord} instance representing a task runtime information
+     * @param hash The task hash
+     * @param line The rendered record
      */
-    protected void printRecord(HashCode hash, TraceRecord record) {
-
+    protected void printLine(HashCode hash, String line) {
         if( printed.containsKey(hash) )
             return
-        else
-            printed.put(hash,Boolean.TRUE)
+        printed.put(hash,Boolean.TRUE)
+        writer.println(line)
+    }
 
-        final adaptor = new TraceAdaptor(record)
+    /**
+     * Apply the filter and render a log {@link TraceRecord}. The filter is evaluated against
+     * the decoded record before projecting the requested fields and formatting the output
+     *
+     * @param record A {@link TraceRecord} instance representing a task runtime information
+     * @return The rendered record or {@code null} when the record does not match the filter
+     */
+    protected String renderRecord(TraceRecord record) {
 
         if( filterScript ) {
-            filterScript.setBinding(adaptor)
+            final script = filterScript.get()
+            script.setBinding(new TraceAdaptor(record))
             // dynamic execution of the filter statement
             // the `run` method interprets the statement groovy closure
             // then the `call` method invokes the closure which returns a bool value
             // if `false` skip this record
-            if( !((Closure)filterScript.run()).call() ) {
-                return
+            if( !((Closure)script.run()).call() ) {
+                return null
             }
         }
 
-        println templateScript.make(adaptor).toString()
+        final adaptor = new TraceAdaptor(project(record))
+        return json
+                ? renderJson(adaptor)
+                : templateScript.get().make(adaptor).toString()
+    }
+
+    /**
+     * Retain only the fields required to render the output
+     */
+    protected TraceRecord project(TraceRecord record) {
+        if( projection == null )
+            return record
+        final result = new LinkedHashMap<String,Object>(projection.size()+1)
+        for( String name : projection ) {
+            // field names are case insensitive as for the template rendering
+            final lower = name.toLowerCase()
+            final key = lower=='pcpu' ? '%cpu' : lower=='pmem' ? '%mem' : lower
+            if( record.store.containsKey(key) )
+                result.put(key, record.store.get(key))
+        }
+        // the work dir is needed to fetch the task output files
+        if( record.store.containsKey('workdir') )
+            result.put('workdir', record.store.get('workdir'))
+        return new TraceRecord(result)
+    }
+
+    protected String renderJson(TraceAdaptor adaptor) {
+        final result = new LinkedHashMap<String,Object>(projection.size())
+        for( String name : projection ) {
+            final key = name.toLowerCase()
+            result.put(name, FILE_FIELDS.contains(key) ? adaptor.get(key) : adaptor.getValue(key))
+        }
+        return JsonOutput.toJson(result)
     }
 
     private void printHistory() {
@@ -284,6 +372,18 @@ class CmdLog extends CmdBase implements CacheBase {
             throw new MissingPropertyException(name)
         }
 
+        /**
+         * @return The raw value of the field or {@code null} when missing
+         */
+        Object getValue(String name) {
+            final key = normaliseKey(name)
+            if( key == 'pcpu' )
+                return record.store.get('%cpu')
+            if( key == 'pmem' )
+                return record.store.get('%mem')
+            return record.store.get(key)
+        }
+
         Map getVariables() {
             new HashMap(record.store)
         }
@@ -15,6 +15,7 @@
  */
 
 package nextflow.dag
+import java.nio.file.Files
 import java.nio.file.Path
 
 /**
@@ -27,20 +28,21 @@ import java.nio.file.Path
  */
 class CytoscapeHtmlRenderer implements DagRenderer {
 
+    static final private String PLACEHOLDER = '/* REPLACE_WITH_NETWORK_DATA */'
+
     @Override
     void renderDocument(DAG dag, Path file) {
-        String tmplPage = readTemplate()
-        String network = CytoscapeJsRenderer.renderNetwork(dag)
-        file.text = tmplPage.replaceAll(~/\/\* REPLACE_WITH_NETWORK_DATA \*\//, network)
+        final String tmplPage = readTemplate()
+        final p = tmplPage.indexOf(PLACEHOLDER)
+        assert p != -1
+        Files.newBufferedWriter(file).withCloseable { Writer writer ->
+            writer.write(tmplPage, 0, p)
+            CytoscapeJsRenderer.renderNetwork(dag, writer)
+            writer.write(tmplPage.substring(p + PLACEHOLDER.length()))
+        }
     }
 
     private String readTemplate() {
-        StringWriter writer = new StringWriter();
-        def res = CytoscapeHtmlRenderer.class.getResourceAsStream('cytoscape.js.dag.template.html')
-        int ch
-        while( (ch=res.read()) != -1 ) {
-            writer.append(ch as char);
-        }
-        writer.toString();
+        CytoscapeHtmlRenderer.class.getResourceAsStream('cytoscape.js.dag.template.html').getText('UTF-8')
     }
 }
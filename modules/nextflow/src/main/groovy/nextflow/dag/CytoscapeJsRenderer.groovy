@@ -15,6 +15,7 @@
  */
 
 package nextflow.dag
+import java.nio.file.Files
 import java.nio.file.Path
 
 /**
@@ -29,28 +30,44 @@ class CytoscapeJsRenderer implements DagRenderer {
 
     @Override
     void renderDocument(DAG dag, Path file) {
-        file.text = renderNetwork(dag)
+        Files.newBufferedWriter(file).withCloseable { Writer writer -> renderNetwork(dag, writer) }
     }
 
     static String renderNetwork(DAG dag) {
-        def result = []
-        result << "elements: {"
+        final result = new StringWriter()
+        renderNetwork(dag, result)
+        return result.toString()
+    }
 
-        result << "nodes: ["
-        dag.vertices.each { vertex -> result << renderVertex( vertex ) }
-        result << "],"
+    /**
+     * Render the DAG streaming it to the given writer
+     *
+     * @param dag The {@link DAG} to render
+     * @param writer The {@link Writer} object where the network elements are written
+     */
+    static void renderNetwork(DAG dag, Writer writer) {
+        final names = dag.vertexNames()
+        writer.write("elements: {\n")
 
-        result << "edges: ["
-        dag.edges.each { edge -> result << renderEdge( edge ) }
-        result << "],"
+        writer.write("nodes: [\n")
+        for( DAG.Vertex vertex : dag.vertices ) {
+            writer.write(renderVertex( vertex, names ))
+            writer.write('\n')
+        }
+        writer.write("],\n")
 
-        result << "},"
+        writer.write("edges: [\n")
+        for( DAG.Edge edge : dag.edges ) {
+            writer.write(renderEdge( edge, names ))
+            writer.write('\n')
+        }
+        writer.write("],\n")
 
-        return result.join('\n')
+        writer.write("},")
     }
 
-    private static String renderVertex(vertex) {
-        String pre = "{ data: { id: '${vertex.getName()}'"
+    private static String renderVertex(DAG.Vertex vertex, Map<DAG.Vertex,String> names) {
+        String pre = "{ data: { id: '${names.get(vertex)}'"
         String post = "}, classes: '${vertex.type.name()}' },"
         if (vertex.label) {
             return pre + ", label: '${vertex.label}'" + post
@@ -60,9 +77,9 @@ class CytoscapeJsRenderer implements DagRenderer {
     }
 
 
-    private static String renderEdge(edge) {
+    private static String renderEdge(DAG.Edge edge, Map<DAG.Vertex,String> names) {
         assert edge.from != null && edge.to != null
-        String dat = "{ data: { source: '${edge.from.name}', target: '${edge.to.name}'"
+        String dat = "{ data: { source: '${names.get(edge.from)}', target: '${names.get(edge.to)}'"
         if ( edge.label ) {
             return dat + ", label: '${edge.label}' } },"
         }
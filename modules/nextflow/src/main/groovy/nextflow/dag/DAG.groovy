@@ -306,6 +306,34 @@ class DAG {
         vertices.indexOf(v)
     }
 
+    /**
+     * Resolve the names of all vertices in a single pass, since {@link Vertex#getName()}
+     * requires a lookup of the vertex position in the vertices list
+     *
+     * @return A map associating each vertex to its unique name
+     */
+    Map<Vertex,String> vertexNames() {
+        final result = new IdentityHashMap<Vertex,String>(vertices.size())
+        for( int i=0; i<vertices.size(); i++ )
+            result.put(vertices.get(i), "p$i".toString())
+        return result
+    }
+
+    /**
+     * Creates an edge connecting two existing vertices and adds it to the DAG
+     *
+     * @param from The vertex from where the edge starts
+     * @param to The vertex where the edge ends
+     * @param label The edge label
+     * @return The {@link Edge} object
+     */
+    @PackageScope
+    Edge createEdge( Vertex from, Vertex to, String label=null ) {
+        final result = new Edge(from: from, to: to, label: label)
+        edges << result
+        return result
+    }
+
     @PackageScope
     void normalizeMissingVertices() {
         for( Edge e : edges ) {
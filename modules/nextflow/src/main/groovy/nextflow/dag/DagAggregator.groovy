@@ -0,0 +1,212 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.dag
+
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+/**
+ * Creates a summary of a (normalized) DAG to render very large graphs.
+ *
+ * Chains of operators, in which each operator is connected only to the next one,
+ * are collapsed into a single node. Then the sibling nodes having the same type and
+ * label, fed only by the same node and feeding the same nodes, are collapsed into a
+ * single fan-out node. The summary is created in linear time with the size of the DAG.
+ */
+@Slf4j
+@CompileStatic
+class DagAggregator {
+
+    /**
+     * Max number of operator labels shown for a collapsed chain
+     */
+    static final int MAX_CHAIN_LABELS = 3
+
+    @PackageScope
+    static class Group {
+        DAG.Type type
+        List<DAG.Vertex> members = new ArrayList<>(1)
+        String chainLabel
+        int count = 1
+
+        String getLabel() {
+            if( count==1 )
+                return chainLabel
+            return chainLabel ? "$chainLabel x$count".toString() : "x$count".toString()
+        }
+    }
+
+    @PackageScope
+    static String chainLabel(List<DAG.Vertex> chain) {
+        final labels = chain.findAll { it.label }.collect { it.label }
+        if( !labels )
+            return null
+        if( chain.size()==1 )
+            return labels.first()
+        if( chain.size() <= MAX_CHAIN_LABELS )
+            return labels.join(', ')
+        return "${chain.size()} operators: ${labels.first()} .. ${labels.last()}".toString()
+    }
+
+    final private DAG dag
+
+    final private Map<DAG.Vertex,List<DAG.Edge>> inbound = new IdentityHashMap<>()
+
+    final private Map<DAG.Vertex,List<DAG.Edge>> outbound = new IdentityHashMap<>()
+
+    final private Map<DAG.Vertex,Group> groups = new IdentityHashMap<>()
+
+    DagAggregator(DAG dag) {
+        this.dag = dag
+    }
+
+    /**
+     * @return A new {@link DAG} object summarising the source one
+     */
+    DAG apply() {
+        index()
+        collapseChains()
+        collapseFanOut()
+        final result = render()
+        log.debug "DAG aggregation > vertices: ${dag.vertices.size()} -> ${result.vertices.size()}; edges: ${dag.edges.size()} -> ${result.edges.size()}"
+        return result
+    }
+
+    private void index() {
+        for( DAG.Vertex it : dag.vertices ) {
+            inbound.put(it, new ArrayList<DAG.Edge>(1))
+            outbound.put(it, new ArrayList<DAG.Edge>(1))
+        }
+        for( DAG.Edge edge : dag.edges ) {
+            assert edge.from != null && edge.to != null
+            outbound.get(edge.from).add(edge)
+            inbound.get(edge.to).add(edge)
+        }
+    }
+
+    /*
+     * the operator only feeds the next operator, which is only fed by it
+     */
+    private DAG.Vertex chainNext(DAG.Vertex vertex) {
+        if( vertex.type != DAG.Type.OPERATOR )
+            return null
+        final out = outbound.get(vertex)
+        if( out.size() != 1 )
+            return null
+        final next = out.get(0).to
+        return next.type == DAG.Type.OPERATOR && inbound.get(next).size()==1 ? next : null
+    }
+
+    private boolean isChainHead(DAG.Vertex vertex) {
+        final ins = inbound.get(vertex)
+        return ins.size() != 1 || chainNext(ins.get(0).from) == null
+    }
+
+    private void collapseChains() {
+        for( DAG.Vertex vertex : dag.vertices ) {
+            if( groups.containsKey(vertex) || !isChainHead(vertex) )
+                continue
+            final group = new Group(type: vertex.type)
+            DAG.Vertex it = vertex
+            while( it != null ) {
+                group.members.add(it)
+                groups.put(it, group)
+                it = chainNext(it)
+            }
+            group.chainLabel = chainLabel(group.members)
+        }
+        // vertices not reachable from a chain head e.g. in a cycle
+        for( DAG.Vertex vertex : dag.vertices ) {
+            if( !groups.containsKey(vertex) ) {
+                final group = new Group(type: vertex.type, chainLabel: vertex.label)
+                group.members.add(vertex)
+                groups.put(vertex, group)
+            }
+        }
+    }
+
+    private Set<Group> targets(Group group) {
+        // groups don't override equals and hashCode, therefore a set of groups is compared by identity
+        final result = new LinkedHashSet<Group>()
+        for( DAG.Vertex it : group.members ) {
+            for( DAG.Edge edge : outbound.get(it) ) {
+                final target = groups.get(edge.to)
+                if( !target.is(group) )
+                    result.add(target)
+            }
+        }
+        return result
+    }
+
+    private List<DAG.Edge> entering(Group group) {
+        final result = new ArrayList<DAG.Edge>(1)
+        for( DAG.Vertex it : group.members ) {
+            for( DAG.Edge edge : inbound.get(it) ) {
+                if( !groups.get(edge.from).is(group) )
+                    result.add(edge)
+            }
+        }
+        return result
+    }
+
+    private void collapseFanOut() {
+        final visited = Collections.<Group>newSetFromMap(new IdentityHashMap<Group,Boolean>())
+        for( DAG.Vertex vertex : dag.vertices ) {
+            final group = groups.get(vertex)
+            if( !visited.add(group) )
+                continue
+            // siblings fed only by this group, having the same type, label and targets
+            final siblings = new LinkedHashMap<List,Group>()
+            for( Group target : targets(group) ) {
+                final ins = entering(target)
+                if( ins.size() != 1 )
+                    continue
+                final key = [target.type, target.label, ins.get(0).label, targets(target)]
+                final first = siblings.get(key)
+                if( first == null ) {
+                    siblings.put(key, target)
+                    continue
+                }
+                first.count += target.count
+                first.members.addAll(target.members)
+                for( DAG.Vertex it : target.members )
+                    groups.put(it, first)
+            }
+        }
+    }
+
+    private DAG render() {
+        final result = new DAG()
+        final vertices = new IdentityHashMap<Group,DAG.Vertex>()
+        for( DAG.Vertex vertex : dag.vertices ) {
+            final group = groups.get(vertex)
+            if( !vertices.containsKey(group) )
+                vertices.put(group, result.createVertex(group.type, group.label))
+        }
+
+        final unique = new HashSet<List>()
+        for( DAG.Edge edge : dag.edges ) {
+            final from = vertices.get(groups.get(edge.from))
+            final to = vertices.get(groups.get(edge.to))
+            if( from.is(to) || !unique.add([from.id, to.id, edge.label]) )
+                continue
+            result.createEdge(from, to, edge.label)
+        }
+        return result
+    }
+
+}
@@ -15,6 +15,7 @@
  */
 
 package nextflow.dag
+import java.nio.file.Files
 import java.nio.file.Path
 
 import groovy.transform.PackageScope
@@ -46,18 +47,32 @@ class DotRenderer implements DagRenderer {
 
     @Override
     void renderDocument(DAG dag, Path file) {
-        file.text = renderNetwork(dag)
+        Files.newBufferedWriter(file).withCloseable { Writer writer -> renderNetwork(dag, writer) }
     }
 
     String renderNetwork(DAG dag) {
-        def result = []
-        result << "digraph \"$name\" {"
-        dag.edges.each { edge -> result << renderEdge( edge ) }
-        result << "}\n"
-        return result.join('\n')
+        final result = new StringWriter()
+        renderNetwork(dag, result)
+        return result.toString()
     }
 
-    private static String renderVertex(DAG.Vertex vertex) {
+    /**
+     * Render the DAG streaming it to the given writer
+     *
+     * @param dag The {@link DAG} to render
+     * @param writer The {@link Writer} object where the DOT document is written
+     */
+    void renderNetwork(DAG dag, Writer writer) {
+        final names = dag.vertexNames()
+        writer.write("digraph \"$name\" {\n")
+        for( DAG.Edge edge : dag.edges ) {
+            writer.write(renderEdge(edge, names))
+            writer.write('\n')
+        }
+        writer.write("}\n")
+    }
+
+    private static String renderVertex(DAG.Vertex vertex, Map<DAG.Vertex,String> names) {
 
         List attrs = []
 
@@ -102,23 +117,24 @@ class DotRenderer implements DagRenderer {
         }
 
 
-        return attrs ? "${vertex.getName()} [${attrs.join(',')}];" : null
+        return attrs ? "${names.get(vertex)} [${attrs.join(',')}];" : null
     }
 
-    private static String renderEdge(DAG.Edge edge) {
+    private static String renderEdge(DAG.Edge edge, Map<DAG.Vertex,String> names) {
         assert edge.from != null && edge.to != null
 
-        String A = renderVertex( edge.from )
-        String B = renderVertex( edge.to )
+        String A = renderVertex( edge.from, names )
+        String B = renderVertex( edge.to, names )
 
         def result = new StringBuilder()
         if( A ) result << A << '\n'
         if( B ) result << B << '\n'
-        result << "${edge.from.name} -> ${edge.to.name}"
+        result << "${names.get(edge.from)} -> ${names.get(edge.to)}"
         if( edge.label ) {
             result << " [label=\"${edge.label}\"]"
         }
         result << ";\n"
+        return result.toString()
     }
 
 }
@@ -82,13 +82,14 @@ class GexfRenderer implements DagRenderer {
 
 
         /* vertex/node */
+        final names = dag.vertexNames()
         w.writeStartElement("nodes")
-        dag.vertices.each { vertex -> renderVertex(w, vertex ) }
+        dag.vertices.each { vertex -> renderVertex(w, vertex, names ) }
         w.writeEndElement()
 
         /* edges */
         w.writeStartElement("edges")
-        dag.edges.each { edge -> renderEdge(w, edge ) }
+        dag.edges.each { edge -> renderEdge(w, edge, names ) }
         w.writeEndElement()
 
         w.writeEndElement()
@@ -98,10 +99,10 @@ class GexfRenderer implements DagRenderer {
         bw.close()
     }
 
-    private void renderVertex(w,vertex) {
+    private void renderVertex(w,vertex,Map names) {
         w.writeStartElement("node")
-        w.writeAttribute("id",vertex.getName())
-        w.writeAttribute("label",vertex.label?vertex.label:vertex.getName())
+        w.writeAttribute("id",names.get(vertex))
+        w.writeAttribute("label",vertex.label?vertex.label:names.get(vertex))
 
         w.writeStartElement("attvalues")
         w.writeEmptyElement("attvalue")
@@ -113,12 +114,12 @@ class GexfRenderer implements DagRenderer {
     }
 
 
-    private void renderEdge(w,edge) {
+    private void renderEdge(w,edge,Map names) {
         assert edge.from != null && edge.to != null
         w.writeStartElement("edge")
         w.writeAttribute("type", "directed")
-        w.writeAttribute("source",edge.from.name)
-        w.writeAttribute("target",edge.to.name)
+        w.writeAttribute("source",names.get(edge.from))
+        w.writeAttribute("target",names.get(edge.to))
         if(edge.label) w.writeAttribute("label",edge.label)
         w.writeEndElement()//edge
     }
@@ -45,7 +45,7 @@ class GraphvizRenderer implements DagRenderer {
         def result = Files.createTempFile('nxf-',".$format")
         def temp = Files.createTempFile('nxf-','.dot')
         // save the DAG as `dot` to a temp file
-        temp.text = new DotRenderer(name).renderNetwork(dag)
+        new DotRenderer(name).renderDocument(dag, temp)
 
         final cmd = "command -v dot &>/dev/null || exit 128 && dot -T${format} ${temp} > ${result}"
         final process = new ProcessBuilder().command("bash","-c", cmd).redirectErrorStream(true).start()
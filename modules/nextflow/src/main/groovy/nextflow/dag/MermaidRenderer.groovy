@@ -15,6 +15,7 @@
  */
 
 package nextflow.dag
+import java.nio.file.Files
 import java.nio.file.Path
 
 /**
@@ -27,28 +28,36 @@ class MermaidRenderer implements DagRenderer {
 
     @Override
     void renderDocument(DAG dag, Path file) {
-        file.text = renderNetwork(dag)
+        Files.newBufferedWriter(file).withCloseable { Writer writer -> renderNetwork(dag, writer) }
     }
 
     String renderNetwork(DAG dag) {
-        def lines = []
-        lines << "flowchart TD"
+        final result = new StringWriter()
+        renderNetwork(dag, result)
+        return result.toString()
+    }
 
-        dag.vertices.each { vertex ->
-            lines << "    ${renderVertex( vertex )}"
+    /**
+     * Render the DAG streaming it to the given writer
+     *
+     * @param dag The {@link DAG} to render
+     * @param writer The {@link Writer} object where the Mermaid document is written
+     */
+    void renderNetwork(DAG dag, Writer writer) {
+        final names = dag.vertexNames()
+        writer.write("flowchart TD\n")
+
+        for( DAG.Vertex vertex : dag.vertices ) {
+            writer.write("    ${renderVertex( vertex, names )}\n")
         }
 
-        dag.edges.each { edge ->
-            lines << "    ${renderEdge( edge )}"
+        for( DAG.Edge edge : dag.edges ) {
+            writer.write("    ${renderEdge( edge, names )}\n")
         }
-
-        lines << ""
-
-        return lines.join('\n')
     }
 
-    private String renderVertex(DAG.Vertex vertex) {
-        final id = vertex.getName()
+    private String renderVertex(DAG.Vertex vertex, Map<DAG.Vertex,String> names) {
+        final id = names.get(vertex)
 
         switch (vertex.type) {
             case DAG.Type.NODE:
@@ -68,11 +77,11 @@ class MermaidRenderer implements DagRenderer {
         }
     }
 
-    private String renderEdge(DAG.Edge edge) {
+    private String renderEdge(DAG.Edge edge, Map<DAG.Vertex,String> names) {
         assert edge.from != null && edge.to != null
 
         String label = edge.label ? "|${edge.label}|" : ""
 
-        return "${edge.from.name} -->${label} ${edge.to.name}"
+        return "${names.get(edge.from)} -->${label} ${names.get(edge.to)}"
     }
 }
@@ -37,6 +37,24 @@ import nextflow.script.ScriptType
 @SupportedScriptTypes( [ScriptType.SCRIPTLET, ScriptType.GROOVY] )
 class LocalExecutor extends Executor {
 
+    private LocalTaskBatcher batcher
+
+    @Override
+    protected void register() {
+        super.register()
+        batcher = LocalTaskBatcher.create(this)
+    }
+
+    /**
+     * @return The {@link LocalTaskBatcher} packing tasks in worker processes or {@code null} when batching is disabled
+     */
+    LocalTaskBatcher getBatcher() { batcher }
+
+    @Override
+    void shutdown() {
+        batcher?.shutdown()
+    }
+
     @Override
     protected TaskMonitor createTaskMonitor() {
         return LocalPollingMonitor.create(session, name)
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.executor.local
+
+import java.util.concurrent.ExecutorService
+
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+import nextflow.Session
+import nextflow.exception.ProcessException
+import nextflow.executor.BashWrapperBuilder
+import nextflow.util.Duration
+import nextflow.util.Threads
+/**
+ * Packs many local tasks into a single worker process to reduce the
+ * launch overhead of tiny tasks.
+ *
+ * Tasks submitted to the batcher are collected until either the batch size is reached
+ * or the batch timeout is elapsed. Then a {@code bash} worker process is launched
+ * which runs the {@code .command.run} wrapper of each task of the batch, either in parallel
+ * or one after the other. Tasks keep their own wrapper, therefore their exit status,
+ * logs and trace files are the same as when launched individually.
+ *
+ * The worker notifies the task start (along with the task PID) and termination (along
+ * with the task exit status) by writing one line per event on the standard output.
+ */
+@Slf4j
+@CompileStatic
+class LocalTaskBatcher {
+
+    static final String WORKER_SCRIPT = '''\
+        nxf_parallel=$1
+        nxf_launch() {
+          (cd "$2" && exec @BASH .command.run) > "$2/.command.log" 2>&1 &
+          local pid=$!
+          echo "S $1 $pid"
+          wait $pid
+          echo "E $1 $?"
+        }
+        while IFS= read -r line; do
+          if [[ $nxf_parallel == true ]]; then
+            nxf_launch "${line%% *}" "${line#* }" &
+          else
+            nxf_launch "${line%% *}" "${line#* }"
+          fi
+        done
+        wait
+        '''.stripIndent()
+
+    static final Duration DEFAULT_TIMEOUT = Duration.of('100ms')
+
+    private final LocalExecutor executor
+
+    private final ExecutorService service
+
+    private final int batchSize
+
+    private final long timeoutMillis
+
+    private final boolean parallel
+
+    private final List<LocalTaskHandler> pending = new ArrayList<>()
+
+    private long firstPendingMillis
+
+    private Thread flusher
+
+    private boolean terminated
+
+    LocalTaskBatcher(LocalExecutor executor, ExecutorService service, int batchSize, Duration timeout, boolean parallel) {
+        assert batchSize > 1
+        this.executor = executor
+        this.service = service
+        this.batchSize = batchSize
+        this.timeoutMillis = timeout.toMillis()
+        this.parallel = parallel
+    }
+
+    int getBatchSize() { batchSize }
+
+    boolean getParallel() { parallel }
+
+    /**
+     * Create the task batcher for the given executor
+     *
+     * @return The {@link LocalTaskBatcher} instance or {@code null} when batching is not enabled
+     */
+    static LocalTaskBatcher create(LocalExecutor executor) {
+        final Session session = executor.session
+        final size = session.getExecConfigProp(executor.name, 'batchSize', 1) as int
+        if( size <= 1 )
+            return null
+        final timeout = session.getExecConfigProp(executor.name, 'batchTimeout', DEFAULT_TIMEOUT) as Duration
+        final mode = session.getExecConfigProp(executor.name, 'batchMode', 'parallel') as String
+        if( mode !in ['parallel', 'sequential'] )
+            throw new IllegalArgumentException("Invalid executor batchMode: '$mode' -- it must be either 'parallel' or 'sequential'")
+        log.debug "Creating local task batcher > size=$size; timeout=$timeout; mode=$mode"
+        return new LocalTaskBatcher(executor, session.getExecService(), size, timeout, mode=='parallel')
+    }
+
+    /**
+     * Add a task to the current batch
+     *
+     * @param handler The {@link LocalTaskHandler} of the task to be executed, its wrapper script must already exist
+     */
+    synchronized void submit(LocalTaskHandler handler) {
+        if( terminated )
+            throw new IllegalStateException("Local task batcher has been shutdown")
+        if( pending.isEmpty() )
+            firstPendingMillis = System.currentTimeMillis()
+        pending.add(handler)
+        if( pending.size() >= batchSize ) {
+            flush0()
+            return
+        }
+        if( flusher == null )
+            flusher = Threads.start('local-task-batcher') { flushLoop() }
+        notifyAll()
+    }
+
+    /**
+     * Launch the pending tasks and stop the batcher
+     */
+    synchronized void shutdown() {
+        flush0()
+        terminated = true
+        notifyAll()
+    }
+
+    protected synchronized void flushLoop() {
+        while( !terminated ) {
+            if( pending.isEmpty() ) {
+                wait()
+                continue
+            }
+            final remaining = firstPendingMillis + timeoutMillis - System.currentTimeMillis()
+            if( remaining > 0 )
+                wait(remaining)
+            else
+                flush0()
+        }
+    }
+
+    private void flush0() {
+        if( pending.isEmpty() )
+            return
+        final batch = new ArrayList<LocalTaskHandler>(pending)
+        pending.clear()
+        service.submit({ runWorker(batch) } as Runnable)
+    }
+
+    @PackageScope ProcessBuilder createWorkerBuilder() {
+        final script = WORKER_SCRIPT.replace('@BASH', BashWrapperBuilder.BASH.join(' '))
+        // the batch mode is given as a script argument so that it's not inherited by the tasks environment
+        return new ProcessBuilder('/bin/bash', '-c', script, 'nxf-batch', String.valueOf(parallel))
+                .redirectError(ProcessBuilder.Redirect.DISCARD)
+    }
+
+    @PackageScope void runWorker(List<LocalTaskHandler> batch) {
+        log.trace "Launching local task batch > size=${batch.size()}; parallel=$parallel"
+        Throwable error = null
+        try {
+            final proc = createWorkerBuilder().start()
+            proc.outputStream.withWriter { writer ->
+                for( int i=0; i<batch.size(); i++ )
+                    writer.write("$i ${batch.get(i).workDirPath}\n")
+            }
+            proc.inputStream.eachLine { String line -> handleEvent(batch, line) }
+            final exit = proc.waitFor()
+            if( exit != 0 )
+                log.debug "Local task batch worker terminated with exit status: $exit"
+        }
+        catch( Throwable e ) {
+            error = e
+        }
+        finally {
+            // any task not yet completed has been lost by the worker
+            final cause = error ?: new ProcessException("Local task batch worker terminated unexpectedly")
+            for( LocalTaskHandler handler : batch )
+                handler.batchFailed(cause)
+            signal()
+        }
+    }
+
+    @PackageScope void handleEvent(List<LocalTaskHandler> batch, String line) {
+        final tokens = line.tokenize(' ')
+        if( tokens.size() != 3 || !tokens[1].isInteger() || !tokens[2].isLong() ) {
+            log.debug "Unexpected local task batch worker output: $line"
+            return
+        }
+        final handler = batch.get(tokens[1] as int)
+        if( tokens[0] == 'S' )
+            handler.batchStarted(tokens[2] as long)
+        else if( tokens[0] == 'E' )
+            handler.batchCompleted(tokens[2] as int)
+        signal()
+    }
+
+    private void signal() {
+        executor.getTaskMonitor()?.signal()
+    }
+
+}
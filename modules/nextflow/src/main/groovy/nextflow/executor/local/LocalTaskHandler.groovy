@@ -23,6 +23,7 @@ import java.nio.file.Path
 
 import groovy.transform.Canonical
 import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
 import groovy.util.logging.Slf4j
 import nextflow.Session
 import nextflow.exception.ProcessException
@@ -80,6 +81,11 @@ class LocalTaskHandler extends TaskHandler implements FusionAwareTask {
 
     private volatile TaskResult result
 
+    /**
+     * The PID of the task process when launched by a batch worker
+     */
+    private volatile Long batchPid
+
     LocalTaskHandler(TaskRun task, LocalExecutor executor) {
         super(task)
         // create the task handler
@@ -97,6 +103,14 @@ class LocalTaskHandler extends TaskHandler implements FusionAwareTask {
         // create the wrapper script
         buildTaskWrapper()
 
+        // pack the task in a batch when enabled
+        final batcher = executor.getBatcher()
+        if( batcher != null && isBatchable() ) {
+            batcher.submit(this)
+            status = TaskStatus.SUBMITTED
+            return
+        }
+
         // create the process builder to run the task in the local computer
         final builder = createLaunchProcessBuilder()
         final logFile = builder.redirectOutput().file()
@@ -122,6 +136,28 @@ class LocalTaskHandler extends TaskHandler implements FusionAwareTask {
         status = TaskStatus.SUBMITTED
     }
 
+    protected boolean isBatchable() {
+        !fusionEnabled() && task.workDir.fileSystem == FileSystems.default
+    }
+
+    @PackageScope String getWorkDirPath() {
+        task.workDir.toString()
+    }
+
+    @PackageScope void batchStarted(long pid) {
+        this.batchPid = pid
+    }
+
+    @PackageScope void batchCompleted(int exitStatus) {
+        if( result == null )
+            result = new TaskResult(exitStatus, task.workDir.resolve(TaskRun.CMD_LOG).toFile())
+    }
+
+    @PackageScope void batchFailed(Throwable error) {
+        if( result == null )
+            result = new TaskResult(error)
+    }
+
     protected void buildTaskWrapper() {
         final wrapper = fusionEnabled()
                 ? fusionLauncher()
@@ -184,7 +220,7 @@ class LocalTaskHandler extends TaskHandler implements FusionAwareTask {
     @Override
     boolean checkIfRunning() {
 
-        if( isSubmitted() && (process || result) ) {
+        if( isSubmitted() && (process || batchPid || result) ) {
             status = TaskStatus.RUNNING
             return true
         }
@@ -208,7 +244,10 @@ class LocalTaskHandler extends TaskHandler implements FusionAwareTask {
             status = TaskStatus.COMPLETED
             destroy()
             // fusion uses a temporary file, clean it up
-            if( fusionEnabled() ) result.logs.delete()
+            if( fusionEnabled() ) {
+                final logs = result.logs
+                deferCleanup("fusion log: $logs") { logs.delete() }
+            }
             return true
         }
 
@@ -237,8 +276,13 @@ class LocalTaskHandler extends TaskHandler implements FusionAwareTask {
      */
     @Override
     void kill() {
-        if( !process ) return
-        final pid = ProcessHelper.pid(process)
+        if( process )
+            kill0(ProcessHelper.pid(process))
+        else if( batchPid )
+            kill0(batchPid)
+    }
+
+    protected void kill0(long pid) {
         log.trace("Killing process with pid: ${pid}")
         def cmd = "kill -TERM $pid"
         def proc = new ProcessBuilder('bash', '-c', cmd ).redirectErrorStream(true).start()
@@ -262,6 +306,10 @@ class LocalTaskHandler extends TaskHandler implements FusionAwareTask {
             process.getErrorStream()?.closeQuietly()
             process.destroy()
         }
+        else if( batchPid && result == null ) {
+            // the task process is owned by the batch worker, terminate it explicitly
+            kill0(batchPid)
+        }
 
         destroyed = true
     }
@@ -274,6 +322,8 @@ class LocalTaskHandler extends TaskHandler implements FusionAwareTask {
         final result = super.getTraceRecord()
         if( process )
             result.put('native_id', ProcessHelper.pid(process))
+        else if( batchPid )
+            result.put('native_id', batchPid)
         return result
     }
 
@@ -54,13 +54,19 @@ class CH {
             broadcast = new DataflowBroadcast()
             bridges.put(queue, broadcast)
         }
-        return broadcast.createReadChannel()
+        return bounded(queue, broadcast.createReadChannel())
     }
 
     static private DataflowReadChannel getRead2(DataflowBroadcast channel) {
         if( !NF.isDsl2() )
             throw new IllegalStateException("Broadcast channel are only allowed in a workflow definition scope")
-        channel.createReadChannel()
+        bounded(channel, channel.createReadChannel())
+    }
+
+    static private DataflowReadChannel bounded(DataflowWriteChannel source, DataflowReadChannel reader) {
+        // readers share the credits of a bounded source channel
+        ChannelCredits.of(source)?.alias(reader)
+        return reader
     }
 
     static synchronized boolean isBridge(DataflowQueue queue) {
@@ -76,7 +82,10 @@ class CH {
         }
     }
 
-    static void init() { bridges.clear() }
+    static void init() {
+        bridges.clear()
+        ChannelCredits.reset()
+    }
 
     @PackageScope
     static DataflowWriteChannel close0(DataflowWriteChannel source) {
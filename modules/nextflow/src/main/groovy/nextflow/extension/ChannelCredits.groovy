@@ -0,0 +1,245 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.extension
+
+import groovy.transform.CompileStatic
+import groovy.util.logging.Slf4j
+import nextflow.Channel
+/**
+ * Implements credit based backpressure for a bounded channel.
+ *
+ * A channel is bounded by registering it with a capacity. The producer acquires a credit
+ * for each item it emits, the consumers (processes) give back the credit once the task
+ * created for the item has completed. When a consumer holds {@code capacity} credits
+ * the producer blocks until the consumer completes some of its tasks. Consumers are
+ * tracked separately, therefore with more than one consumer the slowest one dictates
+ * the producer pace.
+ *
+ * Readers not registered as consumers (ie. operators) do not limit the producer.
+ */
+@Slf4j
+@CompileStatic
+class ChannelCredits {
+
+    static final private long STALL_DUMP_MILLIS = 60_000
+
+    /**
+     * Maps writer channels, reader channels and their aliases to the channel credits
+     */
+    static final private Map<Object,ChannelCredits> registry = new IdentityHashMap<>()
+
+    static final private List<ChannelCredits> all = new ArrayList<>()
+
+    final private String name
+
+    final private int capacity
+
+    final private Map<Object,Integer> inflight = new IdentityHashMap<>()
+
+    final private Map<Object,String> consumerNames = new IdentityHashMap<>()
+
+    private long emitted
+
+    private boolean closed
+
+    private ChannelCredits(String name, int capacity) {
+        this.name = name
+        this.capacity = capacity
+    }
+
+    String getName() { name }
+
+    int getCapacity() { capacity }
+
+    /**
+     * Bound a channel to the given capacity
+     *
+     * @param channel The channel to which the items are written
+     * @param capacity The max number of items not yet completed by each consumer
+     * @param name A descriptive name used by the debug dump
+     * @return The {@link ChannelCredits} instance for the channel
+     */
+    static ChannelCredits register(Object channel, int capacity, String name=null) {
+        if( capacity<1 )
+            throw new IllegalArgumentException("Channel capacity must be a positive integer -- offending value: $capacity")
+        synchronized (registry) {
+            final result = new ChannelCredits(name ?: "channel-${all.size()+1}", capacity)
+            registry.put(channel, result)
+            all.add(result)
+            return result
+        }
+    }
+
+    /**
+     * @return The {@link ChannelCredits} associated with the given channel or {@code null} if it's not bounded
+     */
+    static ChannelCredits of(Object channel) {
+        if( channel == null )
+            return null
+        synchronized (registry) {
+            return registry.get(channel)
+        }
+    }
+
+    /**
+     * Associate another channel (either a reader of this channel or an intermediate channel
+     * written on behalf of it) to these credits
+     */
+    ChannelCredits alias(Object channel) {
+        synchronized (registry) {
+            registry.put(channel, this)
+        }
+        return this
+    }
+
+    /**
+     * Register a consumer of the channel items
+     *
+     * @param consumer The consumer object eg. the {@link nextflow.processor.TaskProcessor} instance
+     * @param name The consumer name used by the debug dump
+     */
+    synchronized void addConsumer(Object consumer, String name) {
+        if( !inflight.containsKey(consumer) ) {
+            inflight.put(consumer, 0)
+            consumerNames.put(consumer, name)
+        }
+    }
+
+    /**
+     * Deregister a consumer, eg. because the process has terminated. The items not yet
+     * processed by it do not block the producer any longer
+     *
+     * @param consumer The consumer object
+     */
+    synchronized void removeConsumer(Object consumer) {
+        if( inflight.remove(consumer) != null ) {
+            consumerNames.remove(consumer)
+            notifyAll()
+        }
+    }
+
+    /**
+     * Stop blocking the producer eg. when the execution is aborted
+     */
+    synchronized void close() {
+        closed = true
+        notifyAll()
+    }
+
+    /**
+     * Acquire a credit on behalf of all consumers, blocking until all consumers have room
+     * for a new item. The producer must not run on a thread of the dataflow pool, otherwise
+     * the blocked producers may starve the consumers that would give back the credits
+     */
+    synchronized void acquire() {
+        long last = System.currentTimeMillis()
+        while( !closed && isFull() ) {
+            wait(1_000)
+            final now = System.currentTimeMillis()
+            if( now-last > STALL_DUMP_MILLIS ) {
+                log.debug "Producer of bounded channel '$name' is waiting for consumers -- ${dump0()}"
+                last = now
+            }
+        }
+        for( Map.Entry<Object,Integer> entry : inflight.entrySet() )
+            entry.value = entry.value + 1
+        emitted++
+    }
+
+    private boolean isFull() {
+        for( Integer count : inflight.values() ) {
+            if( count >= capacity )
+                return true
+        }
+        return false
+    }
+
+    /**
+     * Give back a credit
+     *
+     * @param consumer The consumer object that completed the processing of an item
+     */
+    synchronized void release(Object consumer) {
+        final count = inflight.get(consumer)
+        if( count ) {
+            inflight.put(consumer, count-1)
+            notifyAll()
+        }
+    }
+
+    /**
+     * @return The number of items not yet completed by the specified consumer
+     */
+    synchronized int depth(Object consumer) {
+        inflight.get(consumer) ?: 0
+    }
+
+    private String dump0() {
+        final result = new StringBuilder()
+        result << "$name (capacity=$capacity; emitted=$emitted)"
+        for( Map.Entry<Object,Integer> entry : inflight.entrySet() )
+            result << "; ${consumerNames.get(entry.key)}=${entry.value}"
+        return result.toString()
+    }
+
+    synchronized String dump() { dump0() }
+
+    /**
+     * Acquire a credit for the given channel when it's bounded, otherwise it's a no-op
+     *
+     * @param channel The channel to which an item is going to be written
+     * @param value The item to be written, the stop signal does not require any credit
+     */
+    static void acquire(Object channel, Object value) {
+        if( value.is(Channel.STOP) )
+            return
+        of(channel)?.acquire()
+    }
+
+    /**
+     * @return A text describing the depth of the bounded channels for debugging purposes or
+     *  {@code null} if no channel is bounded
+     */
+    static String dumpDepths() {
+        final List<ChannelCredits> copy
+        synchronized (registry) {
+            copy = new ArrayList<>(all)
+        }
+        if( !copy )
+            return null
+        return copy.collect { '  ' + it.dump() }.join('\n')
+    }
+
+    /**
+     * Release all the producers waiting on a bounded channel
+     */
+    static void closeAll() {
+        final List<ChannelCredits> copy
+        synchronized (registry) {
+            copy = new ArrayList<>(all)
+        }
+        for( ChannelCredits it : copy )
+            it.close()
+    }
+
+    static void reset() {
+        synchronized (registry) {
+            registry.clear()
+            all.clear()
+        }
+    }
+}
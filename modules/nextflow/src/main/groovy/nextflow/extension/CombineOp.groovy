@@ -16,20 +16,44 @@
 
 package nextflow.extension
 
+import java.util.concurrent.BlockingQueue
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.Semaphore
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicBoolean
 import java.util.concurrent.atomic.AtomicInteger
 
 import groovy.transform.CompileDynamic
 import groovy.transform.CompileStatic
 import groovy.transform.PackageScope
 import groovy.util.logging.Slf4j
+import groovyx.gpars.actor.impl.MessageStream
+import groovyx.gpars.dataflow.DataflowQueue
 import groovyx.gpars.dataflow.DataflowReadChannel
+import groovyx.gpars.dataflow.DataflowVariable
 import groovyx.gpars.dataflow.DataflowWriteChannel
 import nextflow.Channel
+import nextflow.Global
+import nextflow.Session
+import nextflow.util.Threads
 import static nextflow.extension.DataflowHelper.addToList
 import static nextflow.extension.DataflowHelper.makeKey
 /**
  * Implements the {@link OperatorImpl#spread(groovyx.gpars.dataflow.DataflowReadChannel, java.lang.Object)} operator
  *
+ * When the {@code parallel} option is specified the combination is carried out by a number
+ * of partitions, each of them running in a separate thread. Items are assigned to a partition
+ * by the hash of their matching key when the {@code by} option is used, otherwise the left
+ * items are distributed round-robin and the right items are sent to all partitions.
+ * The items of the same partition are combined in the same order as the sequential operator,
+ * however the order of the items emitted by different partitions is not deterministic.
+ *
+ * The {@code buffer} option limits the number of combined items waiting to be consumed
+ * by the downstream operator or process; when the limit is reached the partitions stop
+ * emitting until the downstream catches up. This applies only to the parallel mode.
+ * The upstream items are handed over to a dedicated dispatcher thread, so that the
+ * dataflow pool threads are never blocked waiting for the partitions.
+ *
  * @author Paolo Di Tommaso <paolo.ditommaso@gmail.com>
  */
 @Slf4j
@@ -54,6 +78,16 @@ class CombineOp {
 
     private List<Integer> pivot = NONE
 
+    private int parallel
+
+    private int buffer
+
+    private List<Partition> partitions
+
+    private AtomicInteger roundRobin = new AtomicInteger()
+
+    private BlockingQueue<Item> inbox
+
     CombineOp(DataflowReadChannel left, Object right) {
 
         leftChannel = left
@@ -79,6 +113,16 @@ class CombineOp {
         return this
     }
 
+    CombineOp setParallel( int value ) {
+        this.parallel = value
+        return this
+    }
+
+    CombineOp setBuffer( int value ) {
+        this.buffer = value
+        return this
+    }
+
 
     List<DataflowReadChannel> getInputs() {
         def result = [leftChannel]
@@ -147,6 +191,8 @@ class CombineOp {
     }
 
     DataflowWriteChannel apply() {
+        if( parallel > 1 )
+            return applyParallel()
 
         target = CH.create()
 
@@ -166,4 +212,228 @@ class CombineOp {
 
         return target
     }
+
+    /**
+     * A message sent to the dispatcher or to a partition
+     */
+    @CompileStatic
+    static private class Item {
+        final int index
+        final List keys
+        final Object value
+        Item(int index, List keys, Object value) {
+            this.index = index
+            this.keys = keys
+            this.value = value
+        }
+    }
+
+    static final private Item STOP_ITEM = new Item(-1, NONE, null)
+
+    /**
+     * Holds the left and right values of the keys assigned to a partition. Items are consumed
+     * by a dedicated thread, therefore the partition state is never accessed concurrently
+     */
+    @CompileStatic
+    private class Partition {
+        final BlockingQueue<Item> queue
+        final Map<Object,List> left = new HashMap<>()
+        final Map<Object,List> right = new HashMap<>()
+
+        Partition(int capacity) {
+            queue = new LinkedBlockingQueue<>(capacity)
+        }
+
+        void run(AtomicInteger running) {
+            try {
+                int stops = 0
+                while( stops < 2 ) {
+                    final item = queue.take()
+                    if( item.is(STOP_ITEM) )
+                        stops++
+                    else
+                        combine(item)
+                }
+            }
+            catch( InterruptedException e ) {
+                log.trace "Interrupted combine partition thread"
+                return
+            }
+            catch( Throwable e ) {
+                log.error("@unknown", e)
+                (Global.session as Session)?.abort(e)
+                return
+            }
+            if( running.decrementAndGet()==0 )
+                target.bind(Channel.STOP)
+        }
+
+        void combine(Item item) {
+            final p = item.keys
+            List lefts = left.get(p)
+            if( lefts == null ) left.put(p, lefts = [])
+            List rights = right.get(p)
+            if( rights == null ) right.put(p, rights = [])
+
+            if( item.index == LEFT ) {
+                for( Object x : rights )
+                    bind0( tuple(p, item.value, x) )
+                lefts.add(item.value)
+            }
+            else {
+                for( Object x : lefts )
+                    bind0( tuple(p, x, item.value) )
+                rights.add(item.value)
+            }
+        }
+    }
+
+    /**
+     * A queue channel holding a permit for each item not yet taken by the downstream.
+     * The queue creates a variable for each bound item and for each pending read, the
+     * permit is given back when the variable is read
+     */
+    @CompileStatic
+    static private class BufferedQueue extends DataflowQueue {
+        final Semaphore permits
+
+        BufferedQueue(int buffer) {
+            permits = new Semaphore(buffer)
+        }
+
+        @Override
+        protected DataflowVariable createVariable() {
+            return new ReleasingVariable(permits)
+        }
+    }
+
+    @CompileStatic
+    static private class ReleasingVariable extends DataflowVariable {
+        final private Semaphore permits
+        final private AtomicBoolean read = new AtomicBoolean()
+
+        ReleasingVariable(Semaphore permits) {
+            this.permits = permits
+        }
+
+        private void release() {
+            if( read.compareAndSet(false, true) )
+                permits.release()
+        }
+
+        @Override
+        Object getVal() throws InterruptedException {
+            release()
+            return super.getVal()
+        }
+
+        @Override
+        Object getVal(long timeout, TimeUnit units) throws InterruptedException {
+            release()
+            return super.getVal(timeout, units)
+        }
+
+        @Override
+        void getValAsync(Object attachment, MessageStream callback) {
+            release()
+            super.getValAsync(attachment, callback)
+        }
+    }
+
+    /**
+     * Bind a combined item to the target channel, blocking the partition thread when
+     * the number of items not yet taken by the downstream reaches the {@code buffer} size
+     */
+    private void bind0( Object value ) {
+        if( target instanceof BufferedQueue )
+            ((BufferedQueue)target).permits.acquire()
+        target.bind(value)
+    }
+
+    private void dispatch( int index, Object value ) {
+        List keys
+        Object item
+        if( pivot ) {
+            final pair = makeKey(pivot, value)
+            keys = pair.keys
+            item = pair.values
+        }
+        else {
+            keys = NONE
+            item = value
+        }
+
+        final message = new Item(index, keys, item)
+        if( pivot ) {
+            // route by matching key so that left and right values sharing a key meet in the same partition
+            partitions[Math.floorMod(keys.hashCode(), partitions.size())].queue.put(message)
+        }
+        else if( index == LEFT ) {
+            partitions[Math.floorMod(roundRobin.getAndIncrement(), partitions.size())].queue.put(message)
+        }
+        else {
+            // cartesian product -- every partition needs all right values
+            for( Partition it : partitions )
+                it.queue.put(message)
+        }
+    }
+
+    private Map parallelHandler(int index) {
+        // the inbox is unbounded, therefore the dataflow pool threads are never blocked
+        def opts = new LinkedHashMap(2)
+        opts.onNext = { inbox.put(new Item(index, NONE, it)) }
+        opts.onComplete = { inbox.put(STOP_ITEM) }
+        return opts
+    }
+
+    /**
+     * Route the upstream items to the partitions, blocking when the partition queues
+     * are full. It runs on a dedicated thread instead of holding a thread of the dataflow pool
+     */
+    private void dispatchLoop() {
+        try {
+            int stops = 0
+            while( stops < 2 ) {
+                final item = inbox.take()
+                if( item.is(STOP_ITEM) )
+                    stops++
+                else
+                    dispatch(item.index, item.value)
+            }
+            for( Partition it : partitions )
+                it.queue.put(STOP_ITEM)
+        }
+        catch( InterruptedException e ) {
+            log.trace "Interrupted combine dispatcher thread"
+        }
+        catch( Throwable e ) {
+            log.error("@unknown", e)
+            (Global.session as Session)?.abort(e)
+        }
+    }
+
+    protected DataflowWriteChannel applyParallel() {
+        if( !rightChannel )
+            throw new IllegalArgumentException("Not a valid spread operator state -- Missing right operand")
+
+        final channel = CH.create()
+        // the buffer can only be enforced when the downstream reads from the queue itself
+        target = buffer>0 && channel instanceof DataflowQueue ? new BufferedQueue(buffer) : channel
+        // the partitions input queues are bounded -- when full the dispatcher thread is blocked
+        final capacity = buffer>0 ? buffer : 10_000
+        final running = new AtomicInteger(parallel)
+        partitions = new ArrayList<Partition>(parallel)
+        for( int i=0; i<parallel; i++ ) {
+            final partition = new Partition(capacity)
+            partitions.add(partition)
+            Threads.start("combine-partition-$i") { partition.run(running) }
+        }
+        inbox = new LinkedBlockingQueue<>()
+        Threads.start("combine-dispatcher") { dispatchLoop() }
+
+        DataflowHelper.subscribeImpl( leftChannel, parallelHandler(LEFT) )
+        DataflowHelper.subscribeImpl( rightChannel, parallelHandler(RIGHT) )
+        return target
+    }
+
 }
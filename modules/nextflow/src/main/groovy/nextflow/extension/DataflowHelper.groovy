@@ -30,10 +30,14 @@ import groovyx.gpars.dataflow.operator.ChainWithClosure
 import groovyx.gpars.dataflow.operator.DataflowEventAdapter
 import groovyx.gpars.dataflow.operator.DataflowEventListener
 import groovyx.gpars.dataflow.operator.DataflowProcessor
+import groovyx.gpars.group.DefaultPGroup
+import groovyx.gpars.group.PGroup
 import nextflow.Channel
 import nextflow.Global
 import nextflow.Session
 import nextflow.dag.NodeMarker
+import nextflow.util.Threads
+import nextflow.util.VirtualThreadPool
 import static java.util.Arrays.asList
 /**
  * This class provides helper methods to implement nextflow operators
@@ -130,6 +134,35 @@ class DataflowHelper {
         return params
     }
 
+    /**
+     * The parallel group running operators on virtual threads, see {@link Threads#useVirtualOperators()}
+     */
+    static private volatile PGroup virtualGroup
+
+    /**
+     * @return The parallel group running operators on virtual threads or {@code null} when it's not enabled
+     */
+    static protected PGroup operatorGroup() {
+        if( !Threads.useVirtualOperators() )
+            return null
+        if( virtualGroup == null ) {
+            synchronized (DataflowHelper) {
+                if( virtualGroup == null ) {
+                    log.debug "Creating virtual threads operators group"
+                    virtualGroup = new DefaultPGroup(new VirtualThreadPool(Thread.ofVirtual().name('nf-operator-', 0).factory()))
+                }
+            }
+        }
+        return virtualGroup
+    }
+
+    static private DataflowProcessor createOperator( Map params, Closure code ) {
+        final group = operatorGroup()
+        return group != null
+                ? group.operator(params, code)
+                : Dataflow.operator(params, code)
+    }
+
     /**
      * Creates a new {@code Dataflow.operator} adding the created instance to the current session list
      *
@@ -146,7 +179,7 @@ class DataflowHelper {
             params.listeners = [ DEF_ERROR_LISTENER ]
         }
 
-        final op = Dataflow.operator(params, code)
+        final op = createOperator(params, code)
         NodeMarker.appendOperator(op)
         if( session && session.allOperators != null ) {
             session.allOperators.add(op)
@@ -201,7 +234,7 @@ class DataflowHelper {
         params.outputs = [output]
         params.listeners = [listener]
 
-        final op = Dataflow.operator(params, code)
+        final op = createOperator(params, code)
         NodeMarker.appendOperator(op)
         if( session && session.allOperators != null ) {
             session.allOperators << op
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.extension
+
+import java.nio.file.Files
+import java.nio.file.Path
+
+import com.esotericsoftware.kryo.io.Input
+import com.esotericsoftware.kryo.io.Output
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+import groovyx.gpars.dataflow.DataflowReadChannel
+import groovyx.gpars.dataflow.DataflowWriteChannel
+import nextflow.Channel
+import nextflow.file.FileHelper
+import nextflow.util.ArrayBag
+import nextflow.util.KryoHelper
+/**
+ * Groups the {@code (key, path)} pairs produced by {@code Channel.fromFilePairs}
+ * holding in memory at most {@code maxPending} unmatched files.
+ *
+ * A group is emitted as soon as it contains {@code size} files. When the number of files
+ * waiting for their mates exceeds {@code maxPending}, the pending groups are spilled to
+ * disk, partitioned by key hash. Any further file having the key of a spilled group is
+ * spilled as well. Spilled partitions are grouped one at time when the source is complete.
+ */
+@Slf4j
+@CompileStatic
+class FilePairsOp {
+
+    static final int SPILL_PARTITIONS = 16
+
+    private DataflowReadChannel source
+
+    private DataflowWriteChannel target
+
+    private int size
+
+    private int maxPending
+
+    private Map<Object,List<Path>> groups = new LinkedHashMap<>()
+
+    private int pending
+
+    private Set<Integer> spilledKeys
+
+    private Path spillDir
+
+    private Output[] spillFiles
+
+    private long spilled
+
+    FilePairsOp(DataflowReadChannel source, int size, int maxPending) {
+        if( maxPending < 1 )
+            throw new IllegalArgumentException("Invalid fromFilePairs maxPending value: $maxPending -- it must be a positive integer")
+        this.source = source
+        this.size = size
+        this.maxPending = maxPending
+    }
+
+    FilePairsOp setTarget(DataflowWriteChannel target) {
+        this.target = target
+        return this
+    }
+
+    DataflowWriteChannel apply() {
+        if( target == null )
+            target = CH.create()
+        DataflowHelper.subscribeImpl(source, [onNext: this.&collect, onComplete: this.&finalise])
+        return target
+    }
+
+    @PackageScope long getSpilled() { spilled }
+
+    @PackageScope int getPending() { pending }
+
+    @PackageScope void collect(List pair) {
+        final key = pair[0]
+        final path = (Path)pair[1]
+        if( spilledKeys != null && spilledKeys.contains(key.hashCode()) ) {
+            spill(key, path)
+            return
+        }
+
+        final group = groups.computeIfAbsent(key, { k -> new ArrayList<Path>(size>0 ? size : 2) })
+        group.add(path)
+        pending++
+        if( size>0 && group.size()==size ) {
+            groups.remove(key)
+            pending -= size
+            bindGroup(key, group)
+        }
+        else if( pending > maxPending ) {
+            spillGroups()
+        }
+    }
+
+    @PackageScope void finalise(nop) {
+        try {
+            for( Map.Entry<Object,List<Path>> entry : groups.entrySet() )
+                bindRemainder(entry.key, entry.value)
+            groups.clear()
+            pending = 0
+            if( spillFiles != null )
+                mergeSpilled()
+        }
+        finally {
+            if( spillDir != null )
+                FileHelper.deletePath(spillDir)
+            target.bind(Channel.STOP)
+        }
+    }
+
+    /*
+     * move all the pending groups to disk
+     */
+    private void spillGroups() {
+        log.debug "File pairs pending limit exceeded ($maxPending) -- spilling ${groups.size()} groups to disk"
+        if( spilledKeys == null )
+            spilledKeys = new HashSet<>()
+        for( Map.Entry<Object,List<Path>> entry : groups.entrySet() ) {
+            spilledKeys.add(entry.key.hashCode())
+            for( Path it : entry.value )
+                spill(entry.key, it)
+        }
+        groups.clear()
+        pending = 0
+    }
+
+    private void spill(Object key, Path path) {
+        if( spillFiles == null ) {
+            spillDir = FileHelper.createLocalDir('nxf-pairs-')
+            spillFiles = new Output[SPILL_PARTITIONS]
+        }
+        final index = Math.floorMod(key.hashCode(), SPILL_PARTITIONS)
+        if( spillFiles[index] == null )
+            spillFiles[index] = new Output(Files.newOutputStream(spillDir.resolve("part-$index")))
+        final kryo = KryoHelper.kryo()
+        kryo.writeClassAndObject(spillFiles[index], key)
+        kryo.writeClassAndObject(spillFiles[index], path)
+        spilled++
+    }
+
+    /*
+     * group the spilled files one partition at time
+     */
+    private void mergeSpilled() {
+        log.debug "Merging $spilled spilled file pairs entries"
+        final kryo = KryoHelper.kryo()
+        for( int i=0; i<SPILL_PARTITIONS; i++ ) {
+            if( spillFiles[i] == null )
+                continue
+            spillFiles[i].close()
+            final partition = new LinkedHashMap<Object,List<Path>>()
+            final input = new Input(Files.newInputStream(spillDir.resolve("part-$i")))
+            try {
+                while( !input.eof() ) {
+                    final key = kryo.readClassAndObject(input)
+                    final path = (Path)kryo.readClassAndObject(input)
+                    partition.computeIfAbsent(key, { k -> new ArrayList<Path>() }).add(path)
+                }
+            }
+            finally {
+                input.close()
+            }
+            for( Map.Entry<Object,List<Path>> entry : partition.entrySet() )
+                bindRemainder(entry.key, entry.value)
+        }
+    }
+
+    /*
+     * bind a group when the source is complete, incomplete groups are discarded
+     */
+    private void bindRemainder(Object key, List<Path> group) {
+        if( size<=0 ) {
+            bindGroup(key, group)
+            return
+        }
+        // spilled groups may exceed the expected size, emit them in chunks as done when streaming
+        for( int i=0; i+size<=group.size(); i+=size )
+            bindGroup(key, new ArrayList<Path>(group.subList(i, i+size)))
+    }
+
+    private void bindGroup(Object key, List<Path> group) {
+        Collections.sort(group)
+        final tuple = new ArrayList(2)
+        tuple.add(key)
+        tuple.add(new ArrayBag(group))
+        target.bind(tuple)
+    }
+
+}
@@ -712,11 +712,13 @@ class OperatorImpl {
     }
 
     DataflowWriteChannel combine( DataflowReadChannel left, Map params, Object right ) {
-        checkParams('combine', params, [flat:Boolean, by: [List,Integer]])
+        checkParams('combine', params, [flat:Boolean, by: [List,Integer], parallel: Integer, buffer: Integer])
 
         final op = new CombineOp(left,right)
         OpCall.current.get().inputs.addAll(op.inputs)
         if( params?.by != null ) op.pivot = params.by
+        if( params?.parallel != null ) op.parallel = params.parallel as int
+        if( params?.buffer != null ) op.buffer = params.buffer as int
         final target = op.apply()
         return target
     }
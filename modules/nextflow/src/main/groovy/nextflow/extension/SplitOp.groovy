@@ -16,6 +16,9 @@
 
 package nextflow.extension
 
+import java.util.concurrent.BlockingQueue
+import java.util.concurrent.LinkedBlockingQueue
+
 import groovy.transform.CompileStatic
 import groovy.transform.PackageScope
 import groovy.util.logging.Slf4j
@@ -23,9 +26,12 @@ import groovyx.gpars.dataflow.DataflowQueue
 import groovyx.gpars.dataflow.DataflowReadChannel
 import groovyx.gpars.dataflow.DataflowWriteChannel
 import nextflow.Channel
+import nextflow.Global
+import nextflow.Session
 import nextflow.splitter.AbstractSplitter
 import nextflow.splitter.FastqSplitter
 import nextflow.splitter.SplitterFactory
+import nextflow.util.Threads
 /**
  * Implements splitter operators:
  * - splitCsv
@@ -70,6 +76,11 @@ class SplitOp {
      */
     @PackageScope String methodName
 
+    /**
+     * Max number of chunks not yet processed by each consuming process, or {@code null} when unbounded
+     */
+    @PackageScope Integer capacity
+
     /**
      * Creates a splitter operator
      *
@@ -99,6 +110,14 @@ class SplitOp {
             multiSplit = true
         }
 
+        // -- the capacity is handled by the operator and it's not passed to the splitter
+        if( params.containsKey('capacity') ) {
+            final value = params.remove('capacity')
+            if( !(value instanceof Integer) || (value as Integer)<1 )
+                throw new IllegalArgumentException("Parameter `capacity` must be a positive integer -- offending value: $value")
+            capacity = value as Integer
+        }
+
         // -- validate options
         if( params.containsKey('autoClose') )
             throw new IllegalArgumentException('Parameter `autoClose` is not supported')
@@ -131,6 +150,10 @@ class SplitOp {
         // -- creates a copy of `source` channel for each element to split
         def copies = createSourceCopies(source, cardinality)
 
+        // -- the resulting channel, when bounded the credits are acquired by the first splitter
+        def output = CH.create()
+        def credits = capacity ? ChannelCredits.register(output, capacity, methodName) : null
+
         // -- applies the splitter the each channel copy
         def splitted = new ArrayList(cardinality)
         for( int i=0; i<cardinality; i++ ) {
@@ -139,12 +162,13 @@ class SplitOp {
             opts.remove('pe')
             opts.elem = indexes.get(i)
             opts.into = createInto0()
+            if( i==0 )
+                credits?.alias(opts.into)
             def result = splitSingleEntry(channel as DataflowReadChannel, opts)
             splitted.add( result )
         }
 
         // -- now merge the result
-        def output = CH.create()
         applyMergingOperator(splitted, output, indexes)
         return output
     }
@@ -162,6 +186,8 @@ class SplitOp {
         final output = getOrCreateWriteChannel(params)
         // -- the output channel is passed to the splitter by using the `into` parameter
         params.into = output
+        if( capacity && !multiSplit )
+            ChannelCredits.register(output, capacity, methodName)
 
         // -- create the splitter and set the options
         def splitter = createSplitter(methodName, params)
@@ -187,11 +213,40 @@ class SplitOp {
     @PackageScope
     void applySplittingOperator( DataflowReadChannel origin, DataflowWriteChannel output, AbstractSplitter splitter ) {
         final events = new HashMap(2)
-        events.onNext = { entry -> splitter.target(entry).apply() }
-        events.onComplete = { output << Channel.STOP }
+        if( capacity ) {
+            // a bounded splitter blocks waiting for credits, therefore it runs on a dedicated
+            // thread instead of holding a thread of the dataflow pool
+            final entries = new LinkedBlockingQueue()
+            Threads.start("$methodName-splitter") { splitLoop(entries, output, splitter) }
+            events.onNext = { entry -> entries.put(entry) }
+            events.onComplete = { entries.put(Channel.STOP) }
+        }
+        else {
+            events.onNext = { entry -> splitter.target(entry).apply() }
+            events.onComplete = { output << Channel.STOP }
+        }
         DataflowHelper.subscribeImpl ( origin, events )
     }
 
+    private void splitLoop( BlockingQueue entries, DataflowWriteChannel output, AbstractSplitter splitter ) {
+        try {
+            while( true ) {
+                final entry = entries.take()
+                if( entry.is(Channel.STOP) )
+                    break
+                splitter.target(entry).apply()
+            }
+            output << Channel.STOP
+        }
+        catch( InterruptedException e ) {
+            log.trace "Interrupted $methodName splitter thread"
+        }
+        catch( Throwable e ) {
+            log.error("@unknown", e)
+            (Global.session as Session)?.abort(e)
+        }
+    }
+
     @PackageScope
     AbstractSplitter createSplitter(String methodName, Map params) {
         SplitterFactory
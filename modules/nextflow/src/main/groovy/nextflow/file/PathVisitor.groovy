@@ -25,6 +25,7 @@ import java.nio.file.Path
 import java.util.concurrent.CompletableFuture
 import java.util.concurrent.ExecutorService
 import java.util.concurrent.Executors
+import java.util.concurrent.atomic.AtomicInteger
 import java.util.regex.Pattern
 
 import groovy.transform.CompileStatic
@@ -158,10 +159,11 @@ class PathVisitor {
         if( !opts.type )
             opts.type = 'file'
 
-        int count=0
+        // the visit may run concurrently when the `parallel` option is specified
+        final count = new AtomicInteger()
         try {
             visitFiles(opts, path, pattern) { Path file ->
-                count++
+                count.incrementAndGet()
                 emit0(file)
             }
         }
@@ -169,7 +171,7 @@ class PathVisitor {
             log.debug "No such file or directory: $folder -- Skipping visit"
         }
         finally {
-            if( !count && opts.checkIfExists as boolean )
+            if( !count.get() && opts.checkIfExists as boolean )
                 throw new IllegalArgumentException("No files match pattern `$pattern` at path: $folder")
             close0()
         }
@@ -119,6 +119,39 @@ class K8sConfig implements Map<String,Object> {
         target.cleanup == null ? defValue : Boolean.valueOf( target.cleanup as String )
     }
 
+    /**
+     * @return When {@code true} the pods of completed tasks are deleted in the background by the {@link K8sPodReaper}
+     */
+    boolean getAsyncCleanup() {
+        Boolean.valueOf( target.asyncCleanup as String )
+    }
+
+    /**
+     * @return When {@code true} the pod spec settings shared by the tasks of a process are computed once
+     *      and reused for all of them (default: {@code true})
+     */
+    boolean getPodTemplateCache() {
+        target.podTemplateCache == null ? true : Boolean.valueOf( target.podTemplateCache as String )
+    }
+
+    int getCleanupBatchSize() {
+        target.cleanupBatchSize ? target.cleanupBatchSize as int : 50
+    }
+
+    /**
+     * @return The max number of pod deletions per second sent by the background cleanup
+     */
+    double getCleanupRateLimit() {
+        target.cleanupRateLimit ? target.cleanupRateLimit as double : 20d
+    }
+
+    /**
+     * @return The max number of pending pod deletions after which pods are deleted inline
+     */
+    int getCleanupQueueSize() {
+        target.cleanupQueueSize ? target.cleanupQueueSize as int : 10_000
+    }
+
     String getUserName() {
         target.userName ?: System.properties.get('user.name')
     }
@@ -261,6 +294,16 @@ class K8sConfig implements Map<String,Object> {
         if( target.maxErrorRetry )
             result.maxErrorRetry = target.maxErrorRetry as Integer
 
+        if( target.httpPool != null )
+            result.httpPool = Boolean.valueOf( target.httpPool as String )
+
+        if( target.httpMaxConcurrency instanceof Map ) {
+            final limits = new HashMap<String,Integer>()
+            for( Map.Entry entry : (target.httpMaxConcurrency as Map).entrySet() )
+                limits.put(entry.key.toString().toUpperCase(), entry.value as Integer)
+            result.httpMaxConcurrency = limits
+        }
+
         return result
     }
 
@@ -409,7 +452,7 @@ class K8sConfig implements Map<String,Object> {
         Collection<String> localClaims
 
         Storage(Map<String,Object> scheduler, Collection<String> localClaims ) {
-            this.target = scheduler
+            this.target = scheduler ?: new HashMap<String,Object>()
             this.localClaims = localClaims
         }
 
@@ -433,6 +476,41 @@ class K8sConfig implements Map<String,Object> {
             target.deleteIntermediateData as Boolean ?: false
         }
 
+        /**
+         * @return {@code true} when the outputs of the tasks that can be resumed are deleted as well by {@link #deleteIntermediateData()}
+         */
+        boolean deleteResumableData(){
+            target.deleteResumableData as Boolean ?: false
+        }
+
+        /**
+         * @return The max number of task outputs deleted in a batch when {@link #deleteIntermediateData()} is enabled
+         */
+        int getDeleteBatchSize() {
+            target.deleteBatchSize as Integer ?: 50
+        }
+
+        /**
+         * @return The number of tasks reading a file stored on the node local claims above which the file is replicated to other nodes, or {@code 0} when replication is disabled
+         */
+        int getReplicationThreshold() {
+            target.replicationThreshold as Integer ?: 0
+        }
+
+        /**
+         * @return The number of nodes a file is replicated to when reaching the {@link #getReplicationThreshold()}
+         */
+        int getReplicationFactor() {
+            target.replicationFactor as Integer ?: 3
+        }
+
+        /**
+         * @return The max time a pod copying a replicated file is waited for before giving up the copy
+         */
+        Duration getReplicationTimeout() {
+            target.replicationTimeout ? target.replicationTimeout as Duration : Duration.of('10 min')
+        }
+
         String getImageName() {
             target.imageName ?: 'fondahub/vsftpd:latest'
         }
@@ -31,6 +31,7 @@ import nextflow.k8s.client.K8sSchedulerClient
 import nextflow.k8s.model.PodHostMount
 import nextflow.k8s.model.PodMountConfig
 import nextflow.k8s.model.PodOptions
+import nextflow.k8s.model.PodSpecTemplate
 import nextflow.k8s.model.PodVolumeClaim
 import nextflow.processor.TaskHandler
 import nextflow.processor.TaskMonitor
@@ -43,6 +44,7 @@ import nextflow.util.ServiceName
 import java.nio.file.NoSuchFileException
 import java.nio.file.Path
 import java.nio.file.Paths
+import java.util.concurrent.ConcurrentHashMap
 
 /**
  * Implement the Kubernetes executor
@@ -70,12 +72,44 @@ class K8sExecutor extends Executor {
      */
     private String daemonSet = null
 
+    /**
+     * Pod spec of the created daemonSet
+     */
+    private Map daemonPodSpec = null
+
     private K8sSchedulerBatch schedulerBatch = null
 
+    /**
+     * Deletes the pods of completed tasks in the background when `asyncCleanup` is enabled
+     */
+    private K8sPodReaper podReaper
+
+    /**
+     * Replicates the high fan-out files stored on the node local claims when `storage.replicationThreshold` is set
+     */
+    private K8sReplicationPlanner replicationPlanner
+
+    /**
+     * Pod spec templates shared by the tasks of the same process
+     */
+    private Map<List,PodSpecTemplate> podTemplates
+
     protected K8sClient getClient() {
         client
     }
 
+    @PackageScope K8sPodReaper getPodReaper() {
+        podReaper
+    }
+
+    @PackageScope K8sReplicationPlanner getReplicationPlanner() {
+        replicationPlanner
+    }
+
+    @PackageScope Map<List,PodSpecTemplate> getPodTemplates() {
+        podTemplates
+    }
+
     @PackageScope K8sSchedulerClient getSchedulerClient() {
         schedulerClient
     }
@@ -99,6 +133,12 @@ class K8sExecutor extends Executor {
         this.client = new K8sClient(clientConfig)
         log.debug "[K8s] config=$k8sConfig; API client config=$clientConfig"
 
+        if( k8sConfig.getPodTemplateCache() )
+            this.podTemplates = new ConcurrentHashMap<>()
+
+        if( k8sConfig.getCleanup() && k8sConfig.getAsyncCleanup() )
+            this.podReaper = new K8sPodReaper(client, k8sConfig, session.runName).start()
+
         //Create Daemonset to access local path on every node, maybe there is a better point to do this
         if( k8sConfig.locationAwareScheduling() ) {
             createDaemonSet()
@@ -126,6 +166,11 @@ class K8sExecutor extends Executor {
             ]
 
             schedulerClient.registerScheduler( data )
+
+            final storage = k8sConfig.getStorage()
+            if( daemonSet && storage.getReplicationThreshold() > 0 )
+                this.replicationPlanner = new K8sReplicationPlanner(client, "name=$daemonSet", storage.getWorkdir(),
+                        storage.getReplicationThreshold(), storage.getReplicationFactor(), daemonPodSpec, storage.getReplicationTimeout(), session.runName).start()
         }
 
     }
@@ -244,6 +289,7 @@ class K8sExecutor extends Executor {
         ]
 
         daemonSet = name
+        daemonPodSpec = spec
         client.daemonSetCreate(pod, Paths.get('.nextflow-daemonset.yaml') )
         log.trace "Created daemonSet: $name"
 
@@ -251,6 +297,20 @@ class K8sExecutor extends Executor {
 
     @Override
     void shutdown() {
+        try {
+            podReaper?.shutdown()
+        }
+        catch (Exception e) {
+            log.debug "Unable to shutdown K8s pod reaper -- cause: ${e.message ?: e}"
+        }
+
+        try {
+            replicationPlanner?.shutdown()
+        }
+        catch (Exception e) {
+            log.debug "Unable to shutdown K8s replication planner -- cause: ${e.message ?: e}"
+        }
+
         final K8sConfig.K8sScheduler schedulerConfig = k8sConfig.getScheduler()
         if( schedulerConfig ) {
             try{
@@ -268,6 +328,7 @@ class K8sExecutor extends Executor {
                 log.error("Couldn't delete daemonset: $daemonSet", e)
             }
         }
+        client?.close()
         log.trace "Close K8s Executor"
     }
 
@@ -0,0 +1,415 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s
+
+import java.nio.file.Path
+import java.util.concurrent.BlockingQueue
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.LongAdder
+
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+import nextflow.Session
+import nextflow.dag.DAG
+import nextflow.file.LocalFileWalker
+import nextflow.file.OutfilesListing
+import nextflow.k8s.client.K8sSchedulerClient
+import nextflow.k8s.localdata.LocalPath
+import nextflow.processor.ErrorStrategy
+import nextflow.processor.TaskHandler
+import nextflow.processor.TaskProcessor
+import nextflow.processor.TaskRun
+import nextflow.script.params.FileOutParam
+import nextflow.trace.TraceObserver
+import nextflow.trace.TraceRecord
+import nextflow.util.Duration
+import nextflow.util.MemoryUnit
+import nextflow.util.Threads
+import nextflow.util.Throttle
+/**
+ * Deletes the intermediate outputs stored on the node local claims as soon as
+ * they are no longer needed, instead of waiting for the end of the run.
+ *
+ * The consumers of the outputs of each process are the downstream processes in the
+ * workflow DAG, connected either directly or through operators. The outputs of a task
+ * hold a reference for each consumer process, released when the consumer process
+ * terminates i.e. when its last task completes. Since operators can emit the same
+ * value more than once, a consumer process is not known to be done with an output
+ * until then. When no reference is left the outputs are deleted in batches by the
+ * daemon running on the node where they are stored.
+ *
+ * Outputs are never deleted when they reach the workflow outputs or an operator other
+ * than a process, or when they are published or stored. The outputs of the tasks that
+ * can be resumed are kept as well, unless deleting them is explicitly enabled. In that
+ * case the outputs consumed by a process having a failed task are retained, because
+ * that task runs again when the pipeline execution is resumed.
+ */
+@Slf4j
+@CompileStatic
+class K8sIntermediateDataCleaner implements TraceObserver {
+
+    /**
+     * The outputs of a completed task waiting to be deleted
+     */
+    @CompileStatic
+    static class Output {
+        final String task
+        final Path workDir
+        final List<Path> files
+        final Set<String> consumers
+
+        Output(String task, Path workDir, List<Path> files, Set<String> consumers) {
+            this.task = task
+            this.workDir = workDir
+            this.files = files
+            this.consumers = new HashSet<>(consumers)
+        }
+    }
+
+    private final int batchSize
+
+    private final boolean deleteResumable
+
+    private DAG dag
+
+    private int dagSize = -1
+
+    private Map<String,Set<String>> graph = Collections.<String,Set<String>>emptyMap()
+
+    private final Set<String> terminated = new HashSet<>()
+
+    private final Set<String> retained = new HashSet<>()
+
+    private final List<Output> waiting = new LinkedList<>()
+
+    private final BlockingQueue<Output> queue = new LinkedBlockingQueue<>()
+
+    private final LongAdder reclaimed = new LongAdder()
+
+    private final LongAdder deleted = new LongAdder()
+
+    private final LongAdder failed = new LongAdder()
+
+    private final Duration dumpInterval = Duration.of('1 min')
+
+    private volatile boolean completed
+
+    private Thread cleaner
+
+    K8sIntermediateDataCleaner(int batchSize, boolean deleteResumable=false) {
+        if( batchSize < 1 )
+            throw new IllegalArgumentException("Invalid intermediate data delete batch size: $batchSize -- it must be a positive integer")
+        this.batchSize = batchSize
+        this.deleteResumable = deleteResumable
+    }
+
+    long getReclaimedBytes() { reclaimed.sum() }
+
+    long getDeletedCount() { deleted.sum() }
+
+    long getFailedCount() { failed.sum() }
+
+    /**
+     * @return The number of task outputs ready to be deleted
+     */
+    int getPendingCount() { queue.size() }
+
+    /**
+     * @return The number of task outputs still referenced by a consumer process
+     */
+    synchronized int getWaitingCount() { waiting.size() }
+
+    @Override
+    void onFlowCreate(Session session) {
+        this.dag = session.getDag()
+        this.cleaner = Threads.start('K8s intermediate data cleaner', this.&cleanLoop)
+    }
+
+    @Override
+    void onProcessComplete(TaskHandler handler, TraceRecord trace) {
+        final task = handler.task
+        // the inputs of a task failed for good are needed to run it again on resume
+        if( !task.isSuccess() && task.errorAction != ErrorStrategy.RETRY )
+            retain(task.processor.name)
+        if( !isDeletable(task) )
+            return
+        final files = outputFiles(task)
+        if( !files )
+            return
+        final consumers = consumersOf(task.processor.name)
+        if( consumers == null ) {
+            log.trace "[K8s] intermediate data cleaner > outputs of task ${task.name} reach the workflow outputs -- skip"
+            return
+        }
+        register(new Output(task.name, task.workDir, files, consumers))
+    }
+
+    @Override
+    void onProcessTerminate(TaskProcessor process) {
+        release(process.name)
+    }
+
+    @Override
+    void onFlowComplete() {
+        completed = true
+        cleaner?.join()
+        log.info "[K8s] intermediate data cleaner > deleted files: ${deleted.sum()}; reclaimed: ${MemoryUnit.of(reclaimed.sum())}; failed: ${failed.sum()}"
+    }
+
+    /**
+     * The outputs of cached or resumable tasks may be reused by a later run, unless their
+     * deletion is enabled. Published and stored outputs are copied or moved in the background
+     */
+    @PackageScope
+    boolean isDeletable(TaskRun task) {
+        if( !task.isSuccess() || task.cached )
+            return false
+        if( !deleteResumable && task.processor.isCacheable() )
+            return false
+        return !task.config.getPublishDir() && !task.config.getStoreDir()
+    }
+
+    @PackageScope
+    List<Path> outputFiles(TaskRun task) {
+        final result = new ArrayList<Path>()
+        for( Object value : task.getOutputsByType(FileOutParam).values() ) {
+            if( value instanceof Path )
+                result.add((Path)value)
+            else if( value instanceof Collection ) {
+                for( Object it : (Collection)value ) {
+                    if( it instanceof Path )
+                        result.add((Path)it)
+                }
+            }
+        }
+        return result
+    }
+
+    @PackageScope
+    synchronized void register(Output output) {
+        if( output.consumers.any { String it -> retained.contains(it) } ) {
+            log.trace "[K8s] intermediate data cleaner > outputs of task ${output.task} are consumed by a failed process -- skip"
+            return
+        }
+        output.consumers.removeAll(terminated)
+        if( output.consumers )
+            waiting.add(output)
+        else
+            queue.offer(output)
+    }
+
+    @PackageScope
+    synchronized void release(String process) {
+        terminated.add(process)
+        final itr = waiting.iterator()
+        while( itr.hasNext() ) {
+            final output = itr.next()
+            output.consumers.remove(process)
+            if( !output.consumers ) {
+                itr.remove()
+                queue.offer(output)
+            }
+        }
+    }
+
+    /**
+     * Keep the outputs consumed by a process, they are needed to run its tasks again
+     * when the pipeline execution is resumed
+     *
+     * @param process The process name
+     */
+    @PackageScope
+    synchronized void retain(String process) {
+        if( !retained.add(process) )
+            return
+        final itr = waiting.iterator()
+        while( itr.hasNext() ) {
+            if( itr.next().consumers.contains(process) )
+                itr.remove()
+        }
+        log.debug "[K8s] intermediate data cleaner > process $process has a failed task -- its inputs are retained"
+    }
+
+    /**
+     * @param process The process name
+     * @return The names of the processes consuming the outputs of the given process or
+     *      {@code null} if the outputs reach the workflow outputs or an operator other than a process
+     */
+    @PackageScope
+    Set<String> consumersOf(String process) {
+        synchronized (this) {
+            final size = dag.vertices.size() + dag.edges.size()
+            if( size != dagSize ) {
+                graph = consumersGraph(dag)
+                dagSize = size
+            }
+            return graph.get(process)
+        }
+    }
+
+    /**
+     * Find the consumer processes of each process, operators and channels are not
+     * taken into account other than to connect the processes
+     *
+     * @param dag The workflow {@link DAG}
+     * @return
+     *      A map associating each process name to the names of the downstream processes,
+     *      or to {@code null} when an output does not lead to a process
+     */
+    @PackageScope
+    static Map<String,Set<String>> consumersGraph(DAG dag) {
+        final outbound = new IdentityHashMap<DAG.Vertex,List<DAG.Edge>>()
+        for( DAG.Edge edge : new ArrayList<DAG.Edge>(dag.edges) ) {
+            if( edge.from != null )
+                outbound.computeIfAbsent(edge.from, { k -> new ArrayList<DAG.Edge>() }).add(edge)
+        }
+
+        final result = new HashMap<String,Set<String>>()
+        for( DAG.Vertex vertex : new ArrayList<DAG.Vertex>(dag.vertices) ) {
+            if( vertex.process == null )
+                continue
+            final targets = new HashSet<String>()
+            boolean sink = !outbound.containsKey(vertex)
+            final visited = Collections.<DAG.Vertex>newSetFromMap(new IdentityHashMap<DAG.Vertex,Boolean>())
+            final stack = new ArrayDeque<DAG.Edge>(outbound.getOrDefault(vertex, Collections.<DAG.Edge>emptyList()))
+            while( stack && !sink ) {
+                final edge = stack.pop()
+                final it = edge.to
+                if( it == null || (it.process == null && it.type != DAG.Type.OPERATOR) ) {
+                    sink = true
+                }
+                else if( it.process != null ) {
+                    targets.add(it.process.name)
+                }
+                else if( visited.add(it) ) {
+                    final next = outbound.get(it)
+                    if( next )
+                        stack.addAll(next)
+                    else
+                        sink = true
+                }
+            }
+            result.put(vertex.process.name, sink ? null : targets)
+        }
+        return result
+    }
+
+    protected void cleanLoop() {
+        final batch = new ArrayList<Output>(batchSize)
+        while( !completed || queue.size() ) {
+            final head = queue.poll(1, TimeUnit.SECONDS)
+            if( head != null ) {
+                batch.add(head)
+                queue.drainTo(batch, batchSize-1)
+                delete(batch)
+                batch.clear()
+            }
+            Throttle.after(dumpInterval) { dumpStatus() }
+        }
+    }
+
+    /**
+     * Delete a batch of task outputs, the files stored on the same node
+     * are deleted with a single request to the node daemon
+     */
+    protected void delete(List<Output> outputs) {
+        final Map<String,NodeBatch> nodes = new HashMap<>()
+        for( Output output : outputs ) {
+            try {
+                collect(output, nodes)
+            }
+            catch( Exception e ) {
+                log.debug "[K8s] intermediate data cleaner > unable to find outputs of task ${output.task} -- cause: ${e.message ?: e}"
+            }
+        }
+
+        for( Map.Entry<String,NodeBatch> entry : nodes.entrySet() ) {
+            final batch = entry.value
+            try {
+                final errors = new HashSet<String>(deleteOnNode(entry.key, batch.files, batch.sortedDirectories()))
+                long bytes = 0
+                for( int i=0; i<batch.files.size(); i++ ) {
+                    if( !errors.contains(batch.files[i]) )
+                        bytes += batch.sizes[i]
+                }
+                final count = batch.files.size() + batch.directories.size() - errors.size()
+                deleted.add(count)
+                failed.add(errors.size())
+                reclaimed.add(bytes)
+                log.debug "[K8s] intermediate data cleaner > node: ${entry.key}; deleted: $count; failed: ${errors.size()}; reclaimed: ${MemoryUnit.of(bytes)}; total reclaimed: ${MemoryUnit.of(reclaimed.sum())}"
+            }
+            catch( Exception e ) {
+                failed.add(batch.files.size() + batch.directories.size())
+                log.warn "Unable to delete intermediate data on node: ${entry.key} -- see the log file for details", e
+            }
+        }
+    }
+
+    @CompileStatic
+    static private class NodeBatch {
+        final List<String> files = new ArrayList<>()
+        final List<Long> sizes = new ArrayList<>()
+        final Set<String> directories = new HashSet<>()
+
+        List<String> sortedDirectories() {
+            // delete the nested directories first
+            new ArrayList<String>(directories).sort { String a, String b -> b.length() <=> a.length() }
+        }
+    }
+
+    protected void collect(Output output, Map<String,NodeBatch> nodes) {
+        final listing = OutfilesListing.read(output.workDir)
+        if( listing == null )
+            return
+        for( Path file : output.files ) {
+            final entries = listing.walk(file)
+            // outputs linking other data are not deleted, the target may be used by other tasks
+            if( !entries || entries.any { String[] it -> it[LocalFileWalker.FILE_EXISTS] != '1' || it[LocalFileWalker.REAL_PATH] } )
+                continue
+            final regular = entries.find { String[] it -> it[LocalFileWalker.FILE_TYPE] != 'directory' }
+            final node = nodeOf(regular ? regular[LocalFileWalker.VIRTUAL_PATH] : entries[0][LocalFileWalker.VIRTUAL_PATH])
+            if( !node )
+                continue
+            final batch = nodes.computeIfAbsent(node, { k -> new NodeBatch() })
+            for( String[] it : entries ) {
+                if( it[LocalFileWalker.FILE_TYPE] == 'directory' )
+                    batch.directories.add(it[LocalFileWalker.VIRTUAL_PATH])
+                else {
+                    batch.files.add(it[LocalFileWalker.VIRTUAL_PATH])
+                    batch.sizes.add(it[LocalFileWalker.SIZE] as Long)
+                }
+            }
+        }
+    }
+
+    protected String nodeOf(String path) {
+        final client = K8sExecutor.getK8sSchedulerClient() as K8sSchedulerClient
+        final location = client?.getFileLocation(path)
+        return location?.node as String
+    }
+
+    protected List<String> deleteOnNode(String node, List<String> files, List<String> directories) {
+        return LocalPath.deleteOnNode(node, files, directories)
+    }
+
+    protected void dumpStatus() {
+        log.debug "[K8s] intermediate data cleaner > waiting: ${getWaitingCount()}; pending: ${queue.size()}; deleted: ${deleted.sum()}; failed: ${failed.sum()}; reclaimed: ${MemoryUnit.of(reclaimed.sum())}"
+    }
+
+}
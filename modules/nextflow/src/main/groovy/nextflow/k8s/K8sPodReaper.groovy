@@ -0,0 +1,212 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s
+
+import java.util.concurrent.BlockingQueue
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.LongAdder
+
+import com.google.common.util.concurrent.RateLimiter
+import groovy.transform.CompileStatic
+import groovy.util.logging.Slf4j
+import nextflow.k8s.client.K8sClient
+import nextflow.k8s.client.K8sResponseException
+import nextflow.util.Duration
+import nextflow.util.Threads
+import nextflow.util.Throttle
+/**
+ * Deletes the pods (or jobs) of completed tasks in the background.
+ *
+ * Deletions are queued by the task handlers and sent to the API server in
+ * batches at a paced rate, yielding to pod creation requests which are given
+ * priority. When the queue of pending deletions is full the caller deletes the
+ * pod inline, slowing down the monitor loop until the backlog is drained.
+ * On shutdown the remaining backlog is removed by the reaper thread with a single
+ * collection delete request selecting the succeeded pods of the current run.
+ */
+@Slf4j
+@CompileStatic
+class K8sPodReaper {
+
+    static final private long MAX_CREATE_WAIT_MILLIS = 1_000
+
+    private final K8sClient client
+
+    private final boolean useJobResource
+
+    private final String runName
+
+    private final int batchSize
+
+    private final RateLimiter rateLimiter
+
+    private final BlockingQueue<String> queue
+
+    private final AtomicInteger inflightCreates = new AtomicInteger()
+
+    private final LongAdder deleted = new LongAdder()
+
+    private final LongAdder failed = new LongAdder()
+
+    private final Duration dumpInterval
+
+    private volatile boolean terminated
+
+    private Thread reaper
+
+    K8sPodReaper(K8sClient client, K8sConfig config, String runName) {
+        this.client = client
+        this.runName = runName
+        this.useJobResource = config.useJobResource()
+        this.batchSize = config.getCleanupBatchSize()
+        this.rateLimiter = RateLimiter.create(config.getCleanupRateLimit())
+        this.queue = new LinkedBlockingQueue<>(config.getCleanupQueueSize())
+        this.dumpInterval = Duration.of('1 min')
+    }
+
+    K8sPodReaper start() {
+        reaper = Threads.start('K8s pod reaper', this.&reapLoop)
+        return this
+    }
+
+    /**
+     * @return The number of pod deletions not yet sent to the API server
+     */
+    int getPendingCount() { queue.size() }
+
+    long getDeletedCount() { deleted.sum() }
+
+    long getFailedCount() { failed.sum() }
+
+    /**
+     * Signal a pod creation request is going to be sent
+     */
+    void createStarted() { inflightCreates.incrementAndGet() }
+
+    /**
+     * Signal a pod creation request has been completed
+     */
+    void createCompleted() { inflightCreates.decrementAndGet() }
+
+    /**
+     * Queue the deletion of the specified pod. When the queue of pending deletions is full
+     * the pod is deleted by the calling thread to apply backpressure
+     *
+     * @param podName The name of the pod (or job) to delete
+     */
+    void delete(String podName) {
+        if( terminated || !queue.offer(podName) ) {
+            log.trace "[K8s] pod reaper queue full (${queue.size()}) -- deleting ${podName} inline"
+            delete0(podName)
+        }
+    }
+
+    protected void reapLoop() {
+        final batch = new ArrayList<String>(batchSize)
+        while( !terminated || queue.size() ) {
+            if( terminated && !useJobResource && queue.size() > batchSize ) {
+                deleteCollection()
+                continue
+            }
+            final head = queue.poll(1, TimeUnit.SECONDS)
+            if( head == null ) {
+                Throttle.after(dumpInterval) { dumpStatus() }
+                continue
+            }
+            batch.add(head)
+            queue.drainTo(batch, batchSize-1)
+            awaitCreates()
+            for( String name : batch ) {
+                rateLimiter.acquire()
+                delete0(name)
+            }
+            batch.clear()
+            Throttle.after(dumpInterval) { dumpStatus() }
+        }
+    }
+
+    /**
+     * Give priority to pod creations -- wait for in-flight creation
+     * requests up to a max time to avoid starving the deletions
+     */
+    protected void awaitCreates() {
+        final deadline = System.currentTimeMillis() + MAX_CREATE_WAIT_MILLIS
+        while( inflightCreates.get()>0 && System.currentTimeMillis()<deadline )
+            sleep 10
+    }
+
+    protected void delete0(String podName) {
+        try {
+            if( useJobResource )
+                client.jobDelete(podName)
+            else
+                client.podDelete(podName)
+            deleted.increment()
+        }
+        catch( K8sResponseException e ) {
+            if( e.errorCode == 404 ) {
+                log.trace "[K8s] unable to delete ${podName} -- already gone"
+                return
+            }
+            failed.increment()
+            log.warn "Unable to cleanup ${useJobResource ? 'job' : 'pod'}: $podName -- see the log file for details", e
+        }
+        catch( Exception e ) {
+            failed.increment()
+            log.warn "Unable to cleanup ${useJobResource ? 'job' : 'pod'}: $podName -- see the log file for details", e
+        }
+    }
+
+    protected void dumpStatus() {
+        log.debug "[K8s] pod reaper > pending deletions: ${queue.size()}; deleted: ${deleted.sum()}; failed: ${failed.sum()}"
+    }
+
+    /**
+     * Stop the reaper thread once the remaining queued pods are deleted. When the
+     * reaper was not started the backlog is deleted by the calling thread
+     */
+    void shutdown() {
+        terminated = true
+        if( reaper )
+            reaper.join()
+        else
+            reapLoop()
+        dumpStatus()
+    }
+
+    /**
+     * Delete the queued pods with a single collection request, falling back
+     * to deleting them one by one when the request fails. Only invoked by the
+     * reaper loop so that the queue is not drained concurrently
+     */
+    protected void deleteCollection() {
+        final pending = new ArrayList<String>(queue.size())
+        queue.drainTo(pending)
+        try {
+            client.podDeleteCollection("nextflow.io/runName=$runName", 'status.phase=Succeeded')
+            deleted.add(pending.size())
+        }
+        catch( Exception e ) {
+            log.debug "[K8s] unable to delete succeeded pods for run: $runName -- cause: ${e.message ?: e}"
+            for( String name : pending )
+                delete0(name)
+        }
+    }
+
+}
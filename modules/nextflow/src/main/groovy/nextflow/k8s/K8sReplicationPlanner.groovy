@@ -0,0 +1,448 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s
+
+import java.util.concurrent.BlockingQueue
+import java.util.concurrent.Callable
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+import java.util.concurrent.Future
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.AtomicLong
+import java.util.concurrent.atomic.LongAdder
+
+import groovy.transform.CompileStatic
+import groovy.transform.EqualsAndHashCode
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+import nextflow.k8s.client.K8sClient
+import nextflow.k8s.client.K8sSchedulerClient
+import nextflow.k8s.localdata.LocalPath
+import nextflow.util.CustomThreadFactory
+import nextflow.util.Duration
+import nextflow.util.MemoryUnit
+import nextflow.util.Threads
+import nextflow.util.Throttle
+/**
+ * Replicates the files stored on the node local claims which are read by many tasks,
+ * so that the tasks consuming them are not all served by the node storing the file.
+ *
+ * The fan-out of a file is the number of tasks registered with the scheduler having
+ * it as input. When it reaches the replication threshold, the file is copied to other
+ * nodes running the storage daemon, up to the replication factor. Copies are made
+ * in rounds following a tree: in each round every node holding the file serves one
+ * of the remaining nodes, doubling the number of replicas at each round instead of
+ * reading all of them from the node storing the file. Each copy is made by a short-lived
+ * pod scheduled on the target node, pulling the file from the daemon running on the
+ * source node, so that the data does not flow through the pipeline head job. The new
+ * locations are registered with the scheduler with a single request once the copies complete.
+ *
+ * A file is tracked until it is replicated or the tasks reading it are completed.
+ */
+@Slf4j
+@CompileStatic
+class K8sReplicationPlanner {
+
+    /**
+     * A copy of a file from a node to another
+     */
+    @CompileStatic
+    @EqualsAndHashCode
+    static class Copy {
+        final String source
+        final String target
+
+        Copy(String source, String target) {
+            this.source = source
+            this.target = target
+        }
+
+        @Override
+        String toString() { "$source -> $target" }
+    }
+
+    /**
+     * Pulls a file from the FTP daemon of the source node, the arguments are the daemon
+     * address, the file path and its last modified time in milliseconds
+     */
+    static final private String PULL_SCRIPT = '''\
+        import ftplib, os, sys
+        host, _, port = sys.argv[1].partition(':')
+        path, mtime = sys.argv[2], int(sys.argv[3]) / 1000
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        tmp = path + '.replica'
+        ftp = ftplib.FTP()
+        ftp.connect(host, int(port or 21))
+        ftp.login('root', 'password')
+        with open(tmp, 'wb') as out:
+            ftp.retrbinary('RETR ' + path, out.write)
+        ftp.quit()
+        os.utime(tmp, (mtime, mtime))
+        os.rename(tmp, path)
+        '''.stripIndent()
+
+    private final K8sClient client
+
+    private final String daemonSelector
+
+    private final String workDir
+
+    private final int threshold
+
+    private final int factor
+
+    private final Map podSpec
+
+    private final Duration copyTimeout
+
+    private final String runName
+
+    private final Map<String,AtomicInteger> fanOut = new ConcurrentHashMap<>()
+
+    private final Set<String> planned = ConcurrentHashMap.<String>newKeySet()
+
+    private final BlockingQueue<String> queue = new LinkedBlockingQueue<>()
+
+    private final LongAdder replicated = new LongAdder()
+
+    private final LongAdder copies = new LongAdder()
+
+    private final LongAdder copiedBytes = new LongAdder()
+
+    private final LongAdder failed = new LongAdder()
+
+    private final AtomicLong copyPods = new AtomicLong()
+
+    private final Duration dumpInterval = Duration.of('1 min')
+
+    private final Duration pollInterval = Duration.of('1 sec')
+
+    private ExecutorService transfers
+
+    private Thread planner
+
+    private volatile boolean terminated
+
+    /**
+     * Create the replication planner
+     *
+     * @param client The Kubernetes client used to find the nodes running the storage daemon
+     * @param daemonSelector The label selector of the storage daemon pods
+     * @param workDir The path of the node local work directory, only files stored under it are replicated
+     * @param threshold The number of tasks reading a file above which the file is replicated
+     * @param factor The max number of nodes a file is replicated to
+     * @param podSpec The pod spec of the storage daemon, used as template for the pods copying the files
+     * @param copyTimeout The max time a pod copying a file is waited for, the copy fails when expired
+     * @param runName The name of the current run, used to name and label the pods copying the files
+     */
+    K8sReplicationPlanner(K8sClient client, String daemonSelector, String workDir, int threshold, int factor, Map podSpec=null, Duration copyTimeout=Duration.of('10 min'), String runName=null) {
+        if( threshold < 1 )
+            throw new IllegalArgumentException("Invalid replication threshold: $threshold -- it must be a positive integer")
+        if( factor < 1 )
+            throw new IllegalArgumentException("Invalid replication factor: $factor -- it must be a positive integer")
+        this.client = client
+        this.daemonSelector = daemonSelector
+        this.workDir = workDir
+        this.threshold = threshold
+        this.factor = factor
+        this.podSpec = podSpec
+        this.copyTimeout = copyTimeout
+        this.runName = runName
+    }
+
+    K8sReplicationPlanner start() {
+        // each round of copies runs at most `factor` transfers in parallel
+        this.transfers = Executors.newFixedThreadPool(factor, new CustomThreadFactory('K8sReplication'))
+        this.planner = Threads.start('K8s replication planner', this.&planLoop)
+        return this
+    }
+
+    long getReplicatedCount() { replicated.sum() }
+
+    long getCopyCount() { copies.sum() }
+
+    long getCopiedBytes() { copiedBytes.sum() }
+
+    long getFailedCount() { failed.sum() }
+
+    /**
+     * @return The number of files waiting to be replicated
+     */
+    int getPendingCount() { queue.size() }
+
+    /**
+     * Account the input files of a task registered with the scheduler, the files
+     * reaching the replication threshold are queued for replication
+     *
+     * @param files The paths of the task input files
+     */
+    void register(Collection<String> files) {
+        if( terminated )
+            return
+        for( String path : new HashSet<String>(files) ) {
+            if( (workDir && !path.startsWith(workDir)) || planned.contains(path) )
+                continue
+            final count = fanOut.computeIfAbsent(path, { k -> new AtomicInteger() }).incrementAndGet()
+            if( count >= threshold && planned.add(path) ) {
+                log.trace "[K8s] replication planner > file $path reached fan-out: $count"
+                queue.offer(path)
+            }
+        }
+    }
+
+    /**
+     * Release the input files of a completed task, the files no longer read by any
+     * registered task are not tracked anymore
+     *
+     * @param files The paths of the task input files
+     */
+    void release(Collection<String> files) {
+        for( String path : new HashSet<String>(files) ) {
+            fanOut.computeIfPresent(path, { String k, AtomicInteger v -> v.decrementAndGet() > 0 ? v : null })
+        }
+    }
+
+    /**
+     * @param path The file path
+     * @return The number of registered and not completed tasks reading the file
+     */
+    int fanOutOf(String path) {
+        fanOut.get(path)?.get() ?: 0
+    }
+
+    void shutdown() {
+        terminated = true
+        queue.clear()
+        transfers?.shutdownNow()
+        planner?.join()
+        log.debug "[K8s] replication planner > replicated files: ${replicated.sum()}; copies: ${copies.sum()}; copied: ${MemoryUnit.of(copiedBytes.sum())}; failed: ${failed.sum()}"
+    }
+
+    protected void planLoop() {
+        while( !terminated ) {
+            final path = queue.poll(1, TimeUnit.SECONDS)
+            if( path != null ) {
+                try {
+                    replicate(path)
+                }
+                catch( Exception e ) {
+                    failed.increment()
+                    log.debug "[K8s] replication planner > unable to replicate file $path -- cause: ${e.message ?: e}"
+                }
+                finally {
+                    // the file is not planned again, so there's no need to keep counting its readers
+                    fanOut.remove(path)
+                }
+            }
+            Throttle.after(dumpInterval) { dumpStatus() }
+        }
+    }
+
+    /**
+     * Replicate a file to the nodes chosen by {@link #targetsOf} following the copy
+     * rounds planned by {@link #planRounds}, then register the new locations
+     */
+    protected void replicate(String path) {
+        final location = locationOf(path)
+        final source = location?.node as String
+        if( !source ) {
+            log.trace "[K8s] replication planner > no location for file $path -- skip"
+            return
+        }
+        final targets = targetsOf(source)
+        if( !targets ) {
+            log.trace "[K8s] replication planner > no target node for file $path -- skip"
+            return
+        }
+
+        final holders = new LinkedHashSet<String>([source])
+        final registered = new ArrayList<Map>(targets.size())
+        for( List<Copy> round : planRounds(source, targets) ) {
+            // copies from nodes that failed to receive the file in a previous round are skipped
+            final List<Copy> feasible = round.findAll { Copy it -> holders.contains(it.source) }
+            final futures = new ArrayList<Future<Map>>(feasible.size())
+            for( Copy it : feasible ) {
+                final Copy request = it
+                futures.add(transfers.submit({ copy(path, request.source, request.target) } as Callable<Map>))
+            }
+            for( int i=0; i<feasible.size(); i++ ) {
+                final Copy it = feasible[i]
+                try {
+                    final result = futures[i].get()
+                    holders.add(it.target)
+                    copies.increment()
+                    copiedBytes.add(result.get('size') as long)
+                    registered.add([
+                            path: path,
+                            size: result.get('size'),
+                            timestamp: result.get('timestamp'),
+                            locationWrapperID: location.get('locationWrapperID'),
+                            node: it.target ])
+                }
+                catch( Exception e ) {
+                    failed.increment()
+                    log.debug "[K8s] replication planner > unable to copy file $path ($it) -- cause: ${e.cause?.message ?: e.message ?: e}"
+                }
+            }
+        }
+
+        if( !registered )
+            return
+        addLocations(registered)
+        replicated.increment()
+        log.debug "[K8s] replication planner > file $path with fan-out: ${fanOutOf(path)} replicated to: ${registered.collect { Map it -> it.node }}"
+    }
+
+    /**
+     * Plan the copies of a file stored on the source node to the target nodes. In each round
+     * every node holding the file, either the source or a node served in a previous round,
+     * copies it to one of the remaining targets
+     *
+     * @param source The node storing the file
+     * @param targets The nodes where the file is copied
+     * @return The list of rounds, each round is a list of copies which can run in parallel
+     */
+    @PackageScope
+    static List<List<Copy>> planRounds(String source, List<String> targets) {
+        final result = new ArrayList<List<Copy>>()
+        final holders = new ArrayList<String>([source])
+        int next = 0
+        while( next < targets.size() ) {
+            final round = new ArrayList<Copy>()
+            for( String holder : new ArrayList<String>(holders) ) {
+                if( next == targets.size() )
+                    break
+                final target = targets[next++]
+                round.add(new Copy(holder, target))
+                holders.add(target)
+            }
+            result.add(round)
+        }
+        return result
+    }
+
+    /**
+     * @param source The node storing the file
+     * @return The nodes where the file is replicated, picked at random to spread the copies across the cluster
+     */
+    protected List<String> targetsOf(String source) {
+        final candidates = new ArrayList<String>(nodes())
+        candidates.remove(source)
+        Collections.shuffle(candidates)
+        return candidates.size() > factor ? candidates.subList(0, factor) : candidates
+    }
+
+    protected List<String> nodes() {
+        return client.podNodes(daemonSelector)
+    }
+
+    protected Map locationOf(String path) {
+        return schedulerClient().getFileLocation(path)
+    }
+
+    /**
+     * Copy a file to the same path on another node, the file is pulled from the daemon
+     * running on the source node by a pod running on the target node
+     *
+     * @return A map holding the {@code size} and the {@code timestamp} of the copied file
+     */
+    protected Map copy(String path, String source, String target) {
+        final stat = LocalPath.statOnNode(path, source)
+        final daemon = schedulerClient().getDaemonOnNode(source)
+        final name = createCopyPod(path, daemon, target, stat.get('timestamp') as long)
+        try {
+            awaitCopyPod(name)
+        }
+        finally {
+            try {
+                client.podDelete(name)
+            }
+            catch( Exception e ) {
+                log.debug "[K8s] replication planner > unable to delete pod $name -- cause: ${e.message ?: e}"
+            }
+        }
+        return stat
+    }
+
+    protected String createCopyPod(String path, String daemon, String target, long timestamp) {
+        if( !podSpec )
+            throw new IllegalStateException("Missing storage daemon pod spec")
+        final container = new LinkedHashMap((podSpec.containers as List<Map>)[0])
+        final name = copyPodName(copyPods.incrementAndGet())
+        container.name = name
+        container.command = ['python3', '-c', PULL_SCRIPT, daemon, path, String.valueOf(timestamp)]
+        final spec = new LinkedHashMap(podSpec)
+        spec.remove('nodeSelector')
+        spec.containers = [container]
+        spec.nodeName = target
+        spec.restartPolicy = 'Never'
+        final pod = [
+                apiVersion: 'v1',
+                kind: 'Pod',
+                metadata: [ name: name, labels: [ app: 'nextflow', 'nextflow.io/app': 'nextflow', 'nextflow.io/runName': runName ] ],
+                spec: spec ]
+        client.podCreate(pod)
+        log.trace "[K8s] replication planner > created pod $name to copy file $path to node $target"
+        return name
+    }
+
+    /**
+     * @return The name of a pod copying a file, including the run name so that the pods of different runs do not clash
+     */
+    @PackageScope
+    String copyPodName(long count) {
+        if( !runName )
+            throw new IllegalStateException("Missing run name")
+        final suffix = "-copy-$count"
+        // pod names must be valid DNS labels, at most 63 characters long
+        final prefix = "nf-${runName.toLowerCase().replaceAll(/[^a-z0-9-]/, '-')}"
+        return (prefix.length() + suffix.length() > 63 ? prefix.substring(0, 63 - suffix.length()) : prefix) + suffix
+    }
+
+    protected void awaitCopyPod(String name) {
+        // a pod never scheduled or unable to pull the image would otherwise block the following replications
+        final deadline = System.currentTimeMillis() + copyTimeout.toMillis()
+        while( true ) {
+            final done = client.podState(name).terminated as Map
+            if( done ) {
+                if( done.exitCode as Integer != 0 )
+                    throw new IOException("Copy pod $name terminated with exit status: ${done.exitCode}; reason: ${done.reason ?: '-'}")
+                return
+            }
+            if( System.currentTimeMillis() > deadline )
+                throw new IOException("Copy pod $name did not complete within $copyTimeout")
+            // note: interrupted when the planner is shutdown
+            Thread.sleep(pollInterval.toMillis())
+        }
+    }
+
+    protected void addLocations(List<Map> locations) {
+        schedulerClient().addFileLocations(locations)
+    }
+
+    private K8sSchedulerClient schedulerClient() {
+        K8sExecutor.getK8sSchedulerClient() as K8sSchedulerClient
+    }
+
+    protected void dumpStatus() {
+        log.debug "[K8s] replication planner > tracked files: ${fanOut.size()}; pending: ${queue.size()}; replicated: ${replicated.sum()}; copies: ${copies.sum()}; copied: ${MemoryUnit.of(copiedBytes.sum())}; failed: ${failed.sum()}"
+    }
+
+}
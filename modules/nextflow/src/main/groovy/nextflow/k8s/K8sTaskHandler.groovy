@@ -39,6 +39,7 @@ import nextflow.k8s.client.K8sResponseException
 import nextflow.k8s.model.PodEnv
 import nextflow.k8s.model.PodOptions
 import nextflow.k8s.model.PodSpecBuilder
+import nextflow.k8s.model.PodSpecTemplate
 import nextflow.k8s.model.ResourceType
 import nextflow.processor.TaskHandler
 import nextflow.processor.TaskRun
@@ -110,6 +111,12 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
 
     private long submitToK8sTime = -1
 
+    private int podDeletionBacklog = -1
+
+    private PodSpecTemplate podTemplate
+
+    private List<String> replicationInputs
+
     K8sTaskHandler( TaskRun task, K8sExecutor executor ) {
         super(task)
         this.executor = executor
@@ -219,6 +226,10 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
 
     protected Map newSubmitRequest0(TaskRun task, String imageName) {
 
+        final templates = executor?.getPodTemplates()
+        if( templates != null && !fusionEnabled() && !k8sConfig.getAutoMountHostPaths() )
+            return newSubmitRequestFromTemplate(task, imageName, templates)
+
         final launcher = getSubmitCommand(task)
         final taskCfg = task.getConfig()
 
@@ -302,6 +313,92 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
             : builder.build()
     }
 
+    /**
+     * Creates the pod specification patching the per-task fields on the
+     * base spec shared by all tasks of the same process
+     *
+     * @param task A {@link TaskRun} instance representing the task to execute
+     * @param imageName The container image name
+     * @param templates The templates cache
+     * @return A {@link Map} object modeling a pod (or job) specification
+     */
+    protected Map newSubmitRequestFromTemplate(TaskRun task, String imageName, Map<List,PodSpecTemplate> templates) {
+        final launcher = getSubmitCommand(task)
+        final taskCfg = task.getConfig()
+        final podOptions = getPodOptions()
+        final owner = fixOwnership()
+        final storage = k8sConfig.getStorage()
+        final withInit = storage && storage.withInitContainers() && !storage.separateCopy()
+        if( storage ) {
+            task.initialized = !storage.withInitContainers() || storage.separateCopy()
+            task.withInit = withInit
+        }
+
+        final key = [task.processor.name, imageName, podOptions, owner]
+        this.podTemplate = templates.computeIfAbsent(key, (List it) -> createPodTemplate(imageName, podOptions, owner, withInit))
+
+        final builder = new PodSpecBuilder()
+            .withPodName(getSyntheticPodName(task))
+            .withLabels(getLabels(task))
+
+        if( !entrypointOverride() )
+            builder.withArgs(launcher)
+        else
+            builder.withCommand(launcher)
+
+        if( withInit )
+            builder.withInitWorkDir( task.workDir )
+
+        final cpus = taskCfg.getCpus()
+        final mem = taskCfg.getMemory()
+        final disk = taskCfg.getDisk()
+        final acc = taskCfg.getAccelerator()
+        if( cpus )
+            builder.withCpus(cpus)
+        if( mem )
+            builder.withMemory(mem)
+        if( disk )
+            builder.withDisk(disk)
+        if( acc )
+            builder.withAccelerator(acc)
+        if( taskCfg.time )
+            builder.withActiveDeadline(taskCfg.getTime().toSeconds() as int)
+
+        return useJobResource()
+            ? podTemplate.buildAsJob(builder)
+            : podTemplate.build(builder)
+    }
+
+    protected PodSpecTemplate createPodTemplate(String imageName, PodOptions podOptions, boolean fixOwnership, boolean withInit) {
+        final clientConfig = client.config
+        final builder = new PodSpecBuilder()
+            .withImageName(imageName)
+            .withPodName('nf-template')
+            .withNamespace(clientConfig.namespace)
+            .withServiceAccount(clientConfig.serviceAccount)
+            .withAnnotations(getAnnotations())
+            .withPodOptions(podOptions)
+
+        final schedulerConf = k8sConfig.getScheduler()
+        if ( schedulerConf )
+            builder.withScheduler( "${schedulerConf.getName()}-${getRunName()}" )
+
+        if( withInit ) {
+            final storage = k8sConfig.getStorage()
+            builder.withInitImageName( storage.getImageName() )
+            Boolean traceEnabled = Boolean.valueOf( executor.session.config.navigate('trace.enabled') as String )
+            builder.withInitCommand( ['bash',"-c", "${storage.getCmd().strip()} $traceEnabled".toString()] )
+        }
+
+        if( fixOwnership )
+            builder.withEnv(PodEnv.value('NXF_OWNER', getOwner()))
+
+        if( SysEnv.containsKey('NXF_DEBUG') )
+            builder.withEnv(PodEnv.value('NXF_DEBUG', SysEnv.get('NXF_DEBUG')))
+
+        return new PodSpecTemplate(builder)
+    }
+
     protected PodOptions getPodOptions() {
         // merge the pod options provided in the k8s config
         // with the ones in process config
@@ -400,7 +497,15 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
         ]
 
 
-        return schedulerClient.registerTask( config, task.id.intValue() )
+        final response = schedulerClient.registerTask( config, task.id.intValue() )
+
+        final planner = executor.getReplicationPlanner()
+        if( planner ) {
+            replicationInputs = fileInputs.collect { ((it as Map).value as Map).storePath as String }
+            planner.register( replicationInputs )
+        }
+
+        return response
 
     }
 
@@ -426,9 +531,22 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
         }
 
         start = System.currentTimeMillis()
-        final resp = useJobResource()
-                ? client.jobCreate(req, yamlDebugPath())
-                : client.podCreate(req, yamlDebugPath())
+        final reaper = executor.getPodReaper()
+        reaper?.createStarted()
+        def resp
+        try {
+            if( podTemplate )
+                resp = useJobResource()
+                        ? client.jobCreate(req, podTemplate.toJson(req), yamlDebugPath())
+                        : client.podCreate(req, podTemplate.toJson(req), yamlDebugPath())
+            else
+                resp = useJobResource()
+                        ? client.jobCreate(req, yamlDebugPath())
+                        : client.podCreate(req, yamlDebugPath())
+        }
+        finally {
+            reaper?.createCompleted()
+        }
         submitToK8sTime = System.currentTimeMillis() - start
 
         if( !resp.metadata?.name )
@@ -545,6 +663,7 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
             task.exitStatus = initError
             task.stdout = initLogs
             status = TaskStatus.COMPLETED
+            releaseReplicationInputs()
             return true
         }
         if( state && state.terminated && ( !k8sConfig?.locationAwareScheduling() || schedulerPostProcessingHasFinished() ) ) {
@@ -566,12 +685,20 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
             deletePodIfSuccessful(task)
             updateTimestamps(state.terminated as Map)
             determineNode()
+            releaseReplicationInputs()
             return true
         }
 
         return false
     }
 
+    private void releaseReplicationInputs() {
+        if( replicationInputs == null )
+            return
+        executor.getReplicationPlanner()?.release( replicationInputs )
+        replicationInputs = null
+    }
+
     protected void savePodLogOnError(TaskRun task) {
         if( task.isSuccess() )
             return
@@ -640,14 +767,24 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
             return
         }
 
-        try {
-            if ( useJobResource() )
-                client.jobDelete(podName)
-            else
-                client.podDelete(podName)
+        final reaper = executor?.getPodReaper()
+        if( reaper ) {
+            reaper.delete(podName)
+            podDeletionBacklog = reaper.getPendingCount()
+            return
         }
-        catch( Exception e ) {
-            log.warn "Unable to cleanup ${resourceType.lower()}: $podName -- see the log file for details", e
+
+        final name = podName
+        deferCleanup("${resourceType.lower()}: $name") {
+            try {
+                if ( useJobResource() )
+                    client.jobDelete(name)
+                else
+                    client.podDelete(name)
+            }
+            catch( Exception e ) {
+                log.warn "Unable to cleanup ${resourceType.lower()}: $name -- see the log file for details", e
+            }
         }
     }
 
@@ -668,6 +805,8 @@ class K8sTaskHandler extends TaskHandler implements FusionAwareTask {
         result.put(  "create_request_time", createRequestTime )
         result.put(  "submit_to_scheduler_time", submitToSchedulerTime )
         result.put(  "submit_to_k8s_time", submitToK8sTime )
+        if( podDeletionBacklog >= 0 )
+            result.put( 'pod_deletion_backlog', podDeletionBacklog )
         return result
     }
 
@@ -114,7 +114,9 @@ class K8sWrapperBuilder extends BashWrapperBuilder {
         cmd += super.getLaunchCommand(interpreter, env)
         if( storage && localWorkDir && isTraceRequired() ){
             cmd += "\nlocal exitCode=\$?"
-            cmd += """\necho \"infiles_time=\${INFILESTIME}" >> ${TaskRun.CMD_TRACE}\n"""
+            // the scanner prints the elapsed time followed by the scan strategy used
+            cmd += """\necho \"infiles_time=\${INFILESTIME%% *}" >> ${TaskRun.CMD_TRACE}"""
+            cmd += """\necho \"infiles_strategy=\${INFILESTIME#* }" >> ${TaskRun.CMD_TRACE}\n"""
             cmd += "return \$exitCode\n"
         }
         return cmd
@@ -127,7 +129,8 @@ class K8sWrapperBuilder extends BashWrapperBuilder {
             cmd += "mkdir -p \"${localWorkDir.toString()}/\" || true\n"
             cmd += "local OUTFILESTIME=\$(/etc/nextflow/getStatsAndResolveSymlinks outfiles \"${workDir.toString()}/.command.outfiles\" \"${getStorageLocalWorkDir()}\" \"${localWorkDir.toString()}/\" || true)\n"
             if ( isTraceRequired() ) {
-                cmd += "echo \"outfiles_time=\${OUTFILESTIME}\" >> ${workDir.resolve(TaskRun.CMD_TRACE)}"
+                cmd += "echo \"outfiles_time=\${OUTFILESTIME%% *}\" >> ${workDir.resolve(TaskRun.CMD_TRACE)}\n"
+                cmd += "echo \"outfiles_strategy=\${OUTFILESTIME#* }\" >> ${workDir.resolve(TaskRun.CMD_TRACE)}"
             }
         }
         return cmd
@@ -69,6 +69,18 @@ class ClientConfig {
      */
     Duration httpConnectTimeout
 
+    /**
+     * When true API requests are sent through a shared, pooled HTTP client which reuses
+     * connections and TLS sessions across requests (see {@link K8sHttpTransport})
+     */
+    boolean httpPool
+
+    /**
+     * Max number of in-flight requests per HTTP verb when using the pooled HTTP client
+     * e.g. {@code [GET: 64, POST: 32]}
+     */
+    Map<String,Integer> httpMaxConcurrency
+
     /**
      * When true signal that the configuration was retrieved from within a K8s cluster
      */
@@ -81,7 +93,7 @@ class ClientConfig {
     }
 
     String toString() {
-        "${this.class.getSimpleName()}[ server=$server, namespace=$namespace, serviceAccount=$serviceAccount, token=${cut(token)}, sslCert=${cut(sslCert)}, clientCert=${cut(clientCert)}, clientKey=${cut(clientKey)}, verifySsl=$verifySsl, fromFile=$isFromCluster, httpReadTimeout=$httpReadTimeout, httpConnectTimeout=$httpConnectTimeout, maxErrorRetry=$maxErrorRetry ]"
+        "${this.class.getSimpleName()}[ server=$server, namespace=$namespace, serviceAccount=$serviceAccount, token=${cut(token)}, sslCert=${cut(sslCert)}, clientCert=${cut(clientCert)}, clientKey=${cut(clientKey)}, verifySsl=$verifySsl, fromFile=$isFromCluster, httpReadTimeout=$httpReadTimeout, httpConnectTimeout=$httpConnectTimeout, httpPool=$httpPool, maxErrorRetry=$maxErrorRetry ]"
     }
 
     private String cut(String str) {
@@ -62,6 +62,10 @@ class K8sClient {
 
     private HostnameVerifier hostnameVerifier
 
+    private volatile SSLContext sslContext
+
+    private volatile K8sHttpTransport transport
+
     K8sClient() {
         this(new ClientConfig())
     }
@@ -152,15 +156,36 @@ class K8sClient {
     }
 
     K8sResponseJson podCreate(Map req, Path saveYamlPath=null, namespace = config.namespace) {
+        saveRequestYaml(req, saveYamlPath)
+        podCreate(JsonOutput.toJson(req), namespace)
+    }
+
+    /**
+     * Create a pod using an already serialized request
+     *
+     * @param req The pod spec object, used to save the request yaml
+     * @param json The pod spec JSON to be sent
+     * @param saveYamlPath The path where to save the request yaml or {@code null}
+     * @return
+     */
+    K8sResponseJson podCreate(Map req, String json, Path saveYamlPath) {
+        saveRequestYaml(req, saveYamlPath)
+        podCreate(json)
+    }
 
+    /**
+     * Save the request spec as YAML, failures are only logged as the request can still be sent
+     *
+     * @param req The request spec object
+     * @param saveYamlPath The path where to save the request yaml or {@code null} to skip it
+     */
+    private void saveRequestYaml(Map req, Path saveYamlPath) {
         if( saveYamlPath ) try {
             saveYamlPath.text = new Yaml().dump(req).toString()
         }
         catch( Exception e ) {
             log.debug "WARN: unable to save request yaml -- cause: ${e.message ?: e}"
         }
-
-        podCreate(JsonOutput.toJson(req), namespace)
     }
 
     /**
@@ -180,6 +205,26 @@ class K8sClient {
         new K8sResponseJson(resp.text)
     }
 
+    /**
+     * Delete all the pods matching the specified selectors with a single request
+     *
+     * See
+     *   https://kubernetes.io/docs/reference/kubernetes-api/workload-resources/pod-v1/#delete-delete-collection-of-pod
+     *
+     * @param labelSelector The label selector e.g. {@code app=nextflow}
+     * @param fieldSelector The field selector e.g. {@code status.phase=Succeeded} or {@code null}
+     * @return
+     */
+    K8sResponseJson podDeleteCollection(String labelSelector, String fieldSelector=null) {
+        assert labelSelector
+        String action = "/api/v1/namespaces/$config.namespace/pods?labelSelector=${URLEncoder.encode(labelSelector,'UTF-8')}"
+        if( fieldSelector )
+            action += "&fieldSelector=${URLEncoder.encode(fieldSelector,'UTF-8')}"
+        final resp = delete(action)
+        trace('DELETE', action, resp.text)
+        new K8sResponseJson(resp.text)
+    }
+
     /**
      * Create a job
      *
@@ -199,17 +244,15 @@ class K8sClient {
     }
 
     K8sResponseJson jobCreate(Map req, Path saveYamlPath=null) {
-
-        if( saveYamlPath ) try {
-            saveYamlPath.text = new Yaml().dump(req).toString()
-        }
-        catch( Exception e ) {
-            log.debug "WARN: unable to save request yaml -- cause: ${e.message ?: e}"
-        }
-
+        saveRequestYaml(req, saveYamlPath)
         jobCreate(JsonOutput.toJson(req))
     }
 
+    K8sResponseJson jobCreate(Map req, String json, Path saveYamlPath) {
+        saveRequestYaml(req, saveYamlPath)
+        jobCreate(json)
+    }
+
     /**
      * Delete a job
      *
@@ -274,6 +317,27 @@ class K8sClient {
         new K8sResponseJson(resp.text)
     }
 
+    /**
+     * Find the nodes running the pods matching the specified label selector
+     *
+     * @param labelSelector The label selector e.g. {@code app=nextflow}
+     * @return The names of the nodes where the matching pods are scheduled
+     */
+    List<String> podNodes(String labelSelector) {
+        assert labelSelector
+        final action = "/api/v1/namespaces/$config.namespace/pods?labelSelector=${URLEncoder.encode(labelSelector,'UTF-8')}"
+        final resp = get(action)
+        trace('GET', action, resp.text)
+        final podList = new K8sResponseJson(resp.text)
+        final result = new LinkedHashSet<String>()
+        for( Object item : (podList.items as List) ) {
+            final node = ((item as Map).spec as Map)?.nodeName as String
+            if( node )
+                result.add(node)
+        }
+        return new ArrayList<String>(result)
+    }
+
     /*
      * https://v1-8.docs.kubernetes.io/docs/api-reference/v1.8/#read-status-69
      */
@@ -522,15 +586,7 @@ class K8sClient {
     }
 
     K8sResponseJson daemonSetCreate(Map req, Path saveYamlPath=null) {
-
-        if( saveYamlPath )
-            try {
-                saveYamlPath.text = new Yaml().dump(req).toString()
-            }
-            catch( Exception e ) {
-                log.debug "WARN: unable to save request yaml -- cause: ${e.message ?: e}"
-            }
-
+        saveRequestYaml(req, saveYamlPath)
         daemonSetCreate(JsonOutput.toJson(req))
     }
 
@@ -637,16 +693,64 @@ class K8sClient {
         if (config.httpConnectTimeout != null) {
             conn.setConnectTimeout(config.httpConnectTimeout.toMillis() as int)
         }
-        if (config.keyManagers != null || trustManagers != null) {
-            SSLContext sslContext = SSLContext.getInstance("TLS");
-            sslContext.init(config.keyManagers, trustManagers, new SecureRandom());
-            conn.setSSLSocketFactory(sslContext.getSocketFactory())
-        }
+        final context = getSslContext()
+        if( context )
+            conn.setSSLSocketFactory(context.getSocketFactory())
 
         if( hostnameVerifier )
             conn.setHostnameVerifier(hostnameVerifier)
     }
 
+    /**
+     * @return
+     *      The SSL context shared by all API requests, so that TLS sessions can be resumed
+     *      instead of requiring a full handshake for each connection. It returns {@code null}
+     *      when no custom key or trust managers are defined and the default context can be used
+     */
+    protected SSLContext getSslContext() {
+        if( config.keyManagers == null && trustManagers == null )
+            return null
+        if( sslContext == null ) {
+            synchronized (this) {
+                if( sslContext == null ) {
+                    final result = SSLContext.getInstance("TLS")
+                    result.init(config.keyManagers, trustManagers, new SecureRandom())
+                    sslContext = result
+                }
+            }
+        }
+        return sslContext
+    }
+
+    /**
+     * @return
+     *      The pooled HTTP transport when the {@code httpPool} option is enabled or {@code null} otherwise.
+     *      Note: the pooled transport is not used when SSL verification is disabled because
+     *      the JDK HTTP client does not allow a custom hostname verifier
+     */
+    protected K8sHttpTransport getTransport() {
+        if( !config.httpPool || hostnameVerifier )
+            return null
+        if( transport == null ) {
+            synchronized (this) {
+                if( transport == null )
+                    transport = new K8sHttpTransport(config, getSslContext())
+            }
+        }
+        return transport
+    }
+
+    /**
+     * Release the pooled HTTP transport, if any. The client can still be used afterwards,
+     * in which case a new transport is created
+     */
+    void close() {
+        synchronized (this) {
+            transport?.close()
+            transport = null
+        }
+    }
+
     /**
      * Makes a HTTP(S) request the kubernetes master
      *
@@ -683,6 +787,13 @@ class K8sClient {
         assert path.startsWith('/'), 'Kubernetes API request path must starts with a `/` character'
 
         final prefix = config.server.contains("://") ? config.server : "https://$config.server"
+        if( !method ) method = body ? 'POST' : 'GET'
+        final pooled = getTransport()
+        if( pooled ) {
+            log.trace "[K8s] API request $method $path ${body ? '\n'+prettyPrint(body).indent() : ''}"
+            return pooled.send(method, prefix.toString(), path, body)
+        }
+
         final conn = createConnection0(prefix + path)
         conn.setRequestProperty("Content-Type", "application/json")
         if( config.token ) {
@@ -693,7 +804,6 @@ class K8sClient {
             setupHttpsConn(conn)
         }
 
-        if( !method ) method = body ? 'POST' : 'GET'
         conn.setRequestMethod(method)
         log.trace "[K8s] API request $method $path ${body ? '\n'+prettyPrint(body).indent() : ''}"
 
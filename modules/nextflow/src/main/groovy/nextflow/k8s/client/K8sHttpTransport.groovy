@@ -0,0 +1,247 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s.client
+
+import javax.net.ssl.SSLContext
+import java.net.http.HttpClient
+import java.net.http.HttpRequest
+import java.net.http.HttpResponse
+import java.net.http.HttpTimeoutException
+import java.util.concurrent.CompletableFuture
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.ExecutionException
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+import java.util.concurrent.Semaphore
+import java.util.concurrent.ThreadFactory
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.LongAdder
+
+import groovy.transform.CompileStatic
+import groovy.util.logging.Slf4j
+/**
+ * Pooled HTTP transport for the Kubernetes API client.
+ *
+ * A single {@link HttpClient} instance is shared by all requests so that
+ * connections (HTTP/2 when supported by the API server) and TLS sessions
+ * are reused across calls. The number of in-flight requests is bounded
+ * per HTTP verb, and identical concurrent {@code GET} requests are
+ * coalesced into a single call whose response is shared by all the callers.
+ *
+ * A {@code GET} request only joins an identical request which is in flight
+ * and not yet answered, therefore the shared response may reflect the state
+ * of the API server when the first request was received rather than when the
+ * joining request was issued. Once a response is received, following requests
+ * are sent to the API server again.
+ *
+ * The transport must be closed with {@link #close()} to release the threads
+ * used by the HTTP client.
+ */
+@Slf4j
+@CompileStatic
+class K8sHttpTransport {
+
+    static final public Map<String,Integer> DEFAULT_MAX_CONCURRENCY = [GET: 64, POST: 32, DELETE: 32].asImmutable()
+
+    static final private int DEFAULT_OTHER_CONCURRENCY = 16
+
+    /**
+     * Model a fully read response which can be shared by coalesced requests
+     */
+    @CompileStatic
+    static protected class BufferedResponse {
+        final int code
+        final byte[] body
+
+        BufferedResponse(int code, byte[] body) {
+            this.code = code
+            this.body = body
+        }
+    }
+
+    private final ClientConfig config
+
+    private final ExecutorService executor
+
+    private volatile HttpClient httpClient
+
+    private final Map<String,Semaphore> permits = new ConcurrentHashMap<>()
+
+    private final Map<String,CompletableFuture<BufferedResponse>> inflight = new ConcurrentHashMap<>()
+
+    private final LongAdder requestsCount = new LongAdder()
+
+    private final LongAdder coalescedCount = new LongAdder()
+
+    K8sHttpTransport(ClientConfig config, SSLContext sslContext) {
+        this.config = config
+        this.executor = createExecutor()
+        final builder = HttpClient.newBuilder()
+                .version(HttpClient.Version.HTTP_2)
+                .followRedirects(HttpClient.Redirect.NEVER)
+                .executor(executor)
+        if( sslContext )
+            builder.sslContext(sslContext)
+        if( config.httpConnectTimeout )
+            builder.connectTimeout(java.time.Duration.ofMillis(config.httpConnectTimeout.toMillis()))
+        this.httpClient = builder.build()
+    }
+
+    /**
+     * The HTTP client threads are daemon so that a transport not closed does not prevent the JVM exit
+     */
+    static private ExecutorService createExecutor() {
+        final count = new AtomicInteger()
+        final factory = { Runnable r ->
+            final thread = new Thread(r, "K8sHttpTransport-${count.incrementAndGet()}".toString())
+            thread.setDaemon(true)
+            return thread
+        } as ThreadFactory
+        return Executors.newCachedThreadPool(factory)
+    }
+
+    /**
+     * Release the HTTP client and the threads handling its connections,
+     * requests sent afterwards fail with an {@link IllegalStateException}
+     */
+    void close() {
+        httpClient = null
+        executor.shutdownNow()
+    }
+
+    /**
+     * @return The number of requests actually sent to the API server
+     */
+    long getRequestsCount() { requestsCount.sum() }
+
+    /**
+     * @return The number of {@code GET} requests served by another in-flight identical request
+     */
+    long getCoalescedCount() { coalescedCount.sum() }
+
+    /**
+     * Send a request to the Kubernetes API server
+     *
+     * @param method The HTTP verb to use eg. {@code GET}, {@code POST}, etc
+     * @param server The API server base URL including the protocol prefix
+     * @param path The API action path
+     * @param body The request payload or {@code null} when no payload is sent
+     * @return The {@link K8sResponseApi} response object
+     * @throws K8sResponseException when the API server returns an error code
+     */
+    K8sResponseApi send(String method, String server, String path, String body=null) throws K8sResponseException {
+        if( method=='GET' && isCoalescable(path) )
+            return coalesce(server, path)
+
+        final resp = execute(method, server+path, body, HttpResponse.BodyHandlers.ofInputStream())
+        final code = resp.statusCode()
+        if( code >= 400 )
+            throw new K8sResponseException("Request $method $path returned an error code=$code", resp.body(), code)
+        return new K8sResponseApi(code, resp.body())
+    }
+
+    /**
+     * Log requests return a (potentially large) stream which is consumed by
+     * the caller and therefore cannot be shared across requests
+     */
+    protected boolean isCoalescable(String path) {
+        final p = path.indexOf('?')
+        final action = p==-1 ? path : path.substring(0,p)
+        return !action.endsWith('/log')
+    }
+
+    protected K8sResponseApi coalesce(String server, String path) {
+        final result = new CompletableFuture<BufferedResponse>()
+        final other = inflight.putIfAbsent(path, result)
+        final resp = other!=null ? await(other) : fetch(server, path, result)
+        if( resp.code >= 400 )
+            throw new K8sResponseException("Request GET $path returned an error code=$resp.code", new ByteArrayInputStream(resp.body), resp.code)
+        return new K8sResponseApi(resp.code, new ByteArrayInputStream(resp.body))
+    }
+
+    private BufferedResponse fetch(String server, String path, CompletableFuture<BufferedResponse> result) {
+        final HttpResponse<byte[]> resp
+        try {
+            resp = execute('GET', server+path, null, HttpResponse.BodyHandlers.ofByteArray())
+        }
+        catch( Throwable e ) {
+            inflight.remove(path, result)
+            result.completeExceptionally(e)
+            throw e
+        }
+        // stop accepting joining requests before sharing the response, requests
+        // issued after it was received must get a response of their own
+        inflight.remove(path, result)
+        final buffered = new BufferedResponse(resp.statusCode(), resp.body())
+        result.complete(buffered)
+        return buffered
+    }
+
+    private BufferedResponse await(CompletableFuture<BufferedResponse> other) {
+        coalescedCount.increment()
+        try {
+            return other.get()
+        }
+        catch( ExecutionException e ) {
+            throw e.cause
+        }
+    }
+
+    protected <T> HttpResponse<T> execute(String method, String url, String body, HttpResponse.BodyHandler<T> handler) {
+        final client = httpClient
+        if( client == null )
+            throw new IllegalStateException("K8s HTTP transport has been closed")
+        final request = createRequest(method, url, body)
+        final semaphore = getPermits(method)
+        semaphore.acquire()
+        try {
+            requestsCount.increment()
+            return client.send(request, handler)
+        }
+        catch( HttpTimeoutException e ) {
+            // report it as socket timeout so that the client retry policy is applied
+            throw new SocketTimeoutException(e.message)
+        }
+        finally {
+            semaphore.release()
+        }
+    }
+
+    protected HttpRequest createRequest(String method, String url, String body) {
+        final builder = HttpRequest.newBuilder()
+                .uri(URI.create(url))
+                .header('Content-Type', 'application/json')
+        if( config.token )
+            builder.header('Authorization', "Bearer $config.token".toString())
+        if( config.httpReadTimeout )
+            builder.timeout(java.time.Duration.ofMillis(config.httpReadTimeout.toMillis()))
+        final publisher = body!=null
+                ? HttpRequest.BodyPublishers.ofString(body)
+                : HttpRequest.BodyPublishers.noBody()
+        return builder.method(method, publisher).build()
+    }
+
+    protected Semaphore getPermits(String method) {
+        permits.computeIfAbsent(method, (String it) -> new Semaphore(maxConcurrency(it), true))
+    }
+
+    protected int maxConcurrency(String method) {
+        final result = config.httpMaxConcurrency?.get(method) ?: DEFAULT_MAX_CONCURRENCY.get(method)
+        return result ?: DEFAULT_OTHER_CONCURRENCY
+    }
+
+}
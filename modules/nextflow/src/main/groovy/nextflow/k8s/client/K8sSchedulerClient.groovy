@@ -315,6 +315,32 @@ class K8sSchedulerClient {
 
     }
 
+    /**
+     * Register new locations of existing files with a single request, each location is a map
+     * with the same fields of {@link #addFileLocation} and the {@code node} storing the file.
+     * Falls back to one request per location when the scheduler does not support bulk updates
+     */
+    void addFileLocations( List<Map> locations ){
+        if ( !locations ) return
+
+        HttpURLConnection post = new URL("${getDNS()}/file/$runName/locations/add").openConnection() as HttpURLConnection
+        post.setRequestMethod( "POST" )
+        post.setDoOutput(true)
+        String message = JsonOutput.toJson( locations )
+        post.setRequestProperty("Content-Type", "application/json")
+        post.getOutputStream().write(message.getBytes("UTF-8"));
+        int responseCode = post.getResponseCode()
+        if ( responseCode == 404 || responseCode == 405 ){
+            log.trace "Bulk file location update not supported by the scheduler (code: $responseCode)"
+            for ( Map location : locations ) {
+                addFileLocation( location.path as String, location.size as long, location.timestamp as long,
+                        location.locationWrapperID as long, false, location.node as String )
+            }
+        } else if( responseCode != 200 ){
+            throw new IllegalStateException( "Got code: ${responseCode} from nextflow scheduler, while adding ${locations.size()} file locations (${post.responseMessage})" )
+        }
+    }
+
     ///* DAG */
 
     private submitVertices( List vertices ){
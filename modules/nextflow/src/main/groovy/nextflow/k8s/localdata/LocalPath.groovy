@@ -47,7 +47,7 @@ class LocalPath implements Path {
         else throw new IllegalStateException("Client was already set.")
     }
 
-    private FtpClient getConnection( final String node, String daemon ){
+    private static FtpClient getConnection( final String node, String daemon ){
         int trial = 0
         while ( true ) {
             try {
@@ -64,6 +64,51 @@ class LocalPath implements Path {
         }
     }
 
+    /**
+     * Delete a batch of files stored on a node, using a single connection to the daemon running on it
+     *
+     * @param node The node where the files are stored
+     * @param files The absolute paths of the files to delete
+     * @param directories The absolute paths of the directories to delete, deepest first, they must be empty once the files are deleted
+     * @return The paths that could not be deleted
+     */
+    static List<String> deleteOnNode( String node, List<String> files, List<String> directories ){
+        final failed = new ArrayList<String>()
+        try (FtpClient ftpClient = getConnection( node, client.getDaemonOnNode( node ) )) {
+            for ( String file : files ) {
+                try {
+                    ftpClient.deleteFile( file )
+                } catch ( Exception e ) {
+                    log.trace("Unable to delete $file on $node: ${e.message}")
+                    failed << file
+                }
+            }
+            for ( String dir : directories ) {
+                try {
+                    ftpClient.removeDirectory( dir )
+                } catch ( Exception e ) {
+                    log.trace("Unable to delete directory $dir on $node: ${e.message}")
+                    failed << dir
+                }
+            }
+        }
+        return failed
+    }
+
+    /**
+     * Read the size and the last modified time of a file stored on a node, from the daemon running on it
+     *
+     * @param path The absolute path of the file on the node
+     * @param node The node storing the file
+     * @return A map holding the {@code size} and the {@code timestamp} of the file
+     */
+    static Map statOnNode( String path, String node ){
+        try (FtpClient ftpClient = getConnection( node, client.getDaemonOnNode( node ) )) {
+            final Date modified = ftpClient.getLastModified( path )
+            return [ size : ftpClient.getSize( path ), timestamp : modified ? modified.time : System.currentTimeMillis() ]
+        }
+    }
+
     private Map getLocation( String absolutePath ){
         Map response = client.getFileLocation( absolutePath )
         synchronized ( createSymlinkHelper ) {
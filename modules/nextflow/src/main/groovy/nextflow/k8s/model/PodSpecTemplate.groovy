@@ -0,0 +1,200 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s.model
+
+import groovy.json.JsonOutput
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+/**
+ * Immutable pod specification shared by all the tasks of a process.
+ *
+ * The template is created once from a {@link PodSpecBuilder} holding the settings
+ * that do not change across tasks (image, pod options, volumes, mounts, env, etc).
+ * Tasks only provide the per-task fields (pod name, command, labels, resources,
+ * time limit) which are patched on a shallow copy of the base spec. The shared
+ * parts of the spec are serialized to JSON once and reused by {@link #toJson(Map)}.
+ */
+@CompileStatic
+class PodSpecTemplate {
+
+    private final PodSpecBuilder base
+
+    private final Map<String,Object> metadata
+
+    private final Map<String,Object> spec
+
+    private final Map<String,Object> container
+
+    private final Map<String,Object> initContainer
+
+    private final Map<String,String> labels
+
+    /**
+     * Pre-serialized JSON of the shared spec fragments, indexed by object identity
+     */
+    private final IdentityHashMap<Object,String> fragments = new IdentityHashMap<>()
+
+    PodSpecTemplate(PodSpecBuilder base) {
+        this.base = base
+        final pod = base.build()
+        this.metadata = freeze(pod.metadata) as Map<String,Object>
+        this.spec = freeze(pod.spec) as Map<String,Object>
+        this.container = (spec.containers as List<Map<String,Object>>).get(0)
+        this.initContainer = spec.initContainers ? (spec.initContainers as List<Map<String,Object>>).get(0) : null
+        this.labels = metadata.labels as Map<String,String>
+        // pre-serialize the fragments shared by all pods
+        addFragment(metadata.annotations)
+        for( Map.Entry<String,Object> entry : spec ) {
+            if( entry.key != 'containers' && entry.key != 'initContainers' )
+                addFragment(entry.value)
+        }
+        for( Map.Entry<String,Object> entry : container )
+            addFragment(entry.value)
+        if( initContainer ) {
+            for( Map.Entry<String,Object> entry : initContainer )
+                addFragment(entry.value)
+        }
+    }
+
+    private void addFragment(Object value) {
+        if( value instanceof Map || value instanceof List )
+            fragments.put(value, JsonOutput.toJson(value))
+    }
+
+    static private Object freeze(Object value) {
+        if( value instanceof Map ) {
+            final result = new LinkedHashMap<Object,Object>()
+            for( Map.Entry entry : (value as Map).entrySet() )
+                result.put(entry.key, freeze(entry.value))
+            return Collections.unmodifiableMap(result)
+        }
+        if( value instanceof List ) {
+            final result = new ArrayList<Object>()
+            for( Object it : (value as List) )
+                result.add(freeze(it))
+            return Collections.unmodifiableList(result)
+        }
+        return value
+    }
+
+    @PackageScope Map<String,Object> getSpec() { spec }
+
+    /**
+     * Create the pod specification for a task
+     *
+     * @param task
+     *      A {@link PodSpecBuilder} holding the per-task fields ie. pod name, command or args,
+     *      labels, cpus, memory, disk, accelerator, active deadline and init container work dir
+     * @return A {@link Map} object modeling the pod specification
+     */
+    Map build(PodSpecBuilder task) {
+        assert task.podName, 'Missing K8s podName parameter'
+
+        final meta = new LinkedHashMap<String,Object>(metadata)
+        meta.name = task.podName
+        if( task.labels ) {
+            final result = new LinkedHashMap<String,Object>(base.sanitize(task.labels, PodSpecBuilder.MetaType.LABEL))
+            if( labels )
+                result.putAll(labels)
+            meta.labels = result
+        }
+
+        final main = new LinkedHashMap<String,Object>(container)
+        main.name = task.podName
+        if( task.command )
+            main.command = task.command
+        if( task.args )
+            main.args = task.args
+        Map res = null
+        if( task.cpus )
+            res = base.addCpuResources(task.cpus, res)
+        if( task.memory )
+            res = base.addMemoryResources(task.memory, res)
+        if( task.accelerator )
+            res = base.addAcceleratorResources(task.accelerator, res)
+        if( task.disk )
+            res = base.addDiskResources(task.disk, res)
+        if( res )
+            main.resources = res
+
+        final result = new LinkedHashMap<String,Object>(spec)
+        result.containers = [ main ]
+        if( initContainer && task.initWorkDir ) {
+            final init = new LinkedHashMap<String,Object>(initContainer)
+            init.workingDir = task.initWorkDir
+            result.initContainers = [ init ]
+        }
+        if( task.activeDeadlineSeconds > 0 )
+            result.activeDeadlineSeconds = task.activeDeadlineSeconds
+
+        return [
+                apiVersion: 'v1',
+                kind: 'Pod',
+                metadata: meta,
+                spec: result
+        ]
+    }
+
+    /**
+     * Create the job specification for a task
+     *
+     * @param task A {@link PodSpecBuilder} holding the per-task fields, see {@link #build(PodSpecBuilder)}
+     * @return A {@link Map} object modeling the job specification
+     */
+    Map buildAsJob(PodSpecBuilder task) {
+        final pod = build(task)
+        final spec = new LinkedHashMap<String,Object>()
+        spec.backoffLimit = 0
+        spec.template = [spec: pod.spec]
+        return [
+                apiVersion: 'batch/v1',
+                kind: 'Job',
+                metadata: pod.metadata,
+                spec: spec ]
+    }
+
+    /**
+     * Serialize a pod (or job) spec created by this template, reusing
+     * the pre-serialized JSON of the shared fragments
+     *
+     * @param request The spec returned by {@link #build(PodSpecBuilder)} or {@link #buildAsJob(PodSpecBuilder)}
+     * @return The spec JSON string
+     */
+    String toJson(Map request) {
+        JsonOutput.toJson(substitute(request))
+    }
+
+    protected Object substitute(Object value) {
+        final json = fragments.get(value)
+        if( json != null )
+            return JsonOutput.unescaped(json)
+        if( value instanceof Map ) {
+            final result = new LinkedHashMap<Object,Object>()
+            for( Map.Entry entry : (value as Map).entrySet() )
+                result.put(entry.key, substitute(entry.value))
+            return result
+        }
+        if( value instanceof List ) {
+            final result = new ArrayList<Object>()
+            for( Object it : (value as List) )
+                result.add(substitute(it))
+            return result
+        }
+        return value
+    }
+
+}
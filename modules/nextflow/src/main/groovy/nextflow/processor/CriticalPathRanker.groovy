@@ -0,0 +1,342 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import java.util.concurrent.ConcurrentSkipListMap
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.AtomicLong
+
+import com.google.common.hash.HashCode
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+import nextflow.cache.CacheDB
+import nextflow.cache.CacheFactory
+import nextflow.dag.DAG
+import nextflow.trace.TraceRecord
+import nextflow.util.HistoryFile
+/**
+ * Ranks the pending tasks by the estimated length of the critical path from their
+ * process to the end of the workflow, i.e. the upward rank used by the HEFT scheduling
+ * heuristic, so that the tasks of long process chains are not delayed by wide fan-outs
+ * of short tasks.
+ *
+ * The upward rank of a process is its mean task duration plus the max upward rank of
+ * the downstream processes. The durations are taken from the trace records of the previous
+ * runs of the same pipeline, the processes without history use the mean of the known
+ * durations or a unit duration when there's no history at all.
+ */
+@Slf4j
+@CompileStatic
+class CriticalPathRanker {
+
+    static final public String POLICY = 'critical-path'
+
+    static final public int DEF_HISTORY = 5
+
+    final private DAG dag
+
+    final private Map<String,Double> durations
+
+    final private double defaultDuration
+
+    private int dagSize = -1
+
+    private volatile Map<String,Double> ranks = Collections.<String,Double>emptyMap()
+
+    CriticalPathRanker(DAG dag, Map<String,Double> durations) {
+        this.dag = dag
+        this.durations = durations ?: Collections.<String,Double>emptyMap()
+        this.defaultDuration = this.durations ? this.durations.values().sum() as double / this.durations.size() : 1d
+    }
+
+    /**
+     * Create the ranker loading the task durations from the previous runs
+     *
+     * @param dag The workflow {@link DAG}
+     * @param history The executions history file
+     * @param revisionId The pipeline revision id, only the runs of the same revision are used
+     * @param runName The current run name, which is excluded from the history
+     * @return The {@link CriticalPathRanker} instance
+     */
+    static CriticalPathRanker create(DAG dag, HistoryFile history, String revisionId, String runName) {
+        Map<String,Double> durations = null
+        if( history?.exists() ) {
+            final runs = history.findAll()
+                    .findAll { HistoryFile.Record it -> it.runName != runName && (!revisionId || it.revisionId == revisionId) }
+            durations = loadDurations(runs.takeRight(DEF_HISTORY))
+        }
+        log.debug "Creating critical path ranker > known process durations: ${durations?.size() ?: 0}"
+        return new CriticalPathRanker(dag, durations)
+    }
+
+    /**
+     * Load the mean duration of the tasks of each process
+     *
+     * @param runs The previous runs
+     * @return A map associating each process name to the mean duration of its tasks in millis
+     */
+    static protected Map<String,Double> loadDurations(List<HistoryFile.Record> runs) {
+        final visited = new HashSet<HashCode>()
+        final total = new HashMap<String,Long>()
+        final count = new HashMap<String,Integer>()
+        for( HistoryFile.Record run : runs ) {
+            CacheDB db = null
+            try {
+                db = CacheFactory.create(run.sessionId, run.runName).openForRead()
+                db.eachRecord { HashCode hash, TraceRecord trace ->
+                    if( !visited.add(hash) || trace.isCached() || trace.get('status') != 'COMPLETED' )
+                        return
+                    final process = trace.get('process') as String
+                    final realtime = trace.get('realtime') as Long
+                    if( !process || realtime == null )
+                        return
+                    total.put(process, total.getOrDefault(process, 0L) + realtime)
+                    count.put(process, count.getOrDefault(process, 0) + 1)
+                }
+            }
+            catch( Exception e ) {
+                log.debug "Unable to load task durations of run: ${run.runName} -- cause: ${e.message ?: e}"
+            }
+            finally {
+                db?.close()
+            }
+        }
+
+        final result = new HashMap<String,Double>(total.size())
+        for( Map.Entry<String,Long> entry : total.entrySet() )
+            result.put(entry.key, entry.value / (double)count.get(entry.key))
+        return result
+    }
+
+    /**
+     * @param process The process name
+     * @return The mean duration of the process tasks
+     */
+    double duration(String process) {
+        final result = durations.get(process)
+        return result != null ? result : defaultDuration
+    }
+
+    /**
+     * @param process The process name
+     * @return The upward rank of the process or zero if it's not found in the DAG
+     */
+    double rank(String process) {
+        final result = getRanks().get(process)
+        return result != null ? result : 0d
+    }
+
+    /**
+     * @return A queue of pending tasks ordered by decreasing rank, see {@link RankedQueue}
+     */
+    Queue<TaskHandler> createQueue() {
+        return new RankedQueue(this)
+    }
+
+    /**
+     * A queue holding the pending tasks ordered by decreasing rank, tasks having the same rank
+     * retain their insertion order. The rank of a task is taken when it's added to the queue,
+     * therefore the tasks are not sorted again when the queue is visited.
+     *
+     * It can be added concurrently, while only a single thread is expected to remove the tasks.
+     */
+    @CompileStatic
+    static class RankedQueue extends AbstractQueue<TaskHandler> {
+
+        @CompileStatic
+        static private class Key implements Comparable<Key> {
+            final double rank
+            final long seq
+
+            Key(double rank, long seq) {
+                this.rank = rank
+                this.seq = seq
+            }
+
+            @Override
+            int compareTo(Key other) {
+                final result = Double.compare(other.rank, rank)
+                return result != 0 ? result : Long.compare(seq, other.seq)
+            }
+        }
+
+        @CompileStatic
+        static private class Itr implements Iterator<TaskHandler> {
+            final private ConcurrentSkipListMap<Key,TaskHandler> entries
+            final private AtomicInteger count
+            final private Iterator<Map.Entry<Key,TaskHandler>> delegate
+            private Map.Entry<Key,TaskHandler> last
+
+            Itr(ConcurrentSkipListMap<Key,TaskHandler> entries, AtomicInteger count) {
+                this.entries = entries
+                this.count = count
+                this.delegate = entries.entrySet().iterator()
+            }
+
+            @Override
+            boolean hasNext() { delegate.hasNext() }
+
+            @Override
+            TaskHandler next() {
+                last = delegate.next()
+                return last.value
+            }
+
+            @Override
+            void remove() {
+                if( last == null )
+                    throw new IllegalStateException()
+                if( entries.remove(last.key) != null )
+                    count.decrementAndGet()
+                last = null
+            }
+        }
+
+        final private CriticalPathRanker ranker
+
+        final private ConcurrentSkipListMap<Key,TaskHandler> entries = new ConcurrentSkipListMap<>()
+
+        final private AtomicLong sequence = new AtomicLong()
+
+        final private AtomicInteger count = new AtomicInteger()
+
+        RankedQueue(CriticalPathRanker ranker) {
+            this.ranker = ranker
+        }
+
+        @Override
+        boolean offer(TaskHandler handler) {
+            final key = new Key(ranker.rank(handler.task?.processor?.name), sequence.getAndIncrement())
+            entries.put(key, handler)
+            count.incrementAndGet()
+            return true
+        }
+
+        @Override
+        TaskHandler poll() {
+            final entry = entries.pollFirstEntry()
+            if( entry == null )
+                return null
+            count.decrementAndGet()
+            return entry.value
+        }
+
+        @Override
+        TaskHandler peek() {
+            return entries.firstEntry()?.value
+        }
+
+        @Override
+        int size() {
+            // the size of the skip list is not constant time
+            return count.get()
+        }
+
+        @Override
+        Iterator<TaskHandler> iterator() {
+            return new Itr(entries, count)
+        }
+    }
+
+    /*
+     * the DAG is extended while the workflow is evaluated, the ranks are updated when it changes
+     */
+    private Map<String,Double> getRanks() {
+        final size = dag.vertices.size() + dag.edges.size()
+        if( size != dagSize ) {
+            synchronized (this) {
+                if( size != dagSize ) {
+                    ranks = upwardRanks(processGraph(dag), this.&duration)
+                    dagSize = size
+                    log.trace "Critical path ranks: $ranks"
+                }
+            }
+        }
+        return ranks
+    }
+
+    /**
+     * Reduce the DAG to the graph of the processes, operators and channels are not
+     * taken into account other than to connect the processes
+     *
+     * @param dag The workflow {@link DAG}
+     * @return A map associating each process name to the names of the downstream processes
+     */
+    @PackageScope
+    static Map<String,Set<String>> processGraph(DAG dag) {
+        final outbound = new IdentityHashMap<DAG.Vertex,List<DAG.Vertex>>()
+        for( DAG.Edge edge : new ArrayList<DAG.Edge>(dag.edges) ) {
+            if( edge.from != null && edge.to != null )
+                outbound.computeIfAbsent(edge.from, { k -> new ArrayList<DAG.Vertex>() }).add(edge.to)
+        }
+
+        final result = new LinkedHashMap<String,Set<String>>()
+        for( DAG.Vertex vertex : new ArrayList<DAG.Vertex>(dag.vertices) ) {
+            if( vertex.process == null )
+                continue
+            final targets = new LinkedHashSet<String>()
+            // visit the downstream vertices until a process is found
+            final visited = Collections.<DAG.Vertex>newSetFromMap(new IdentityHashMap<DAG.Vertex,Boolean>())
+            final stack = new ArrayDeque<DAG.Vertex>(outbound.getOrDefault(vertex, Collections.<DAG.Vertex>emptyList()))
+            while( stack ) {
+                final it = stack.pop()
+                if( !visited.add(it) )
+                    continue
+                if( it.process != null )
+                    targets.add(it.process.name)
+                else
+                    stack.addAll(outbound.getOrDefault(it, Collections.<DAG.Vertex>emptyList()))
+            }
+            result.put(vertex.process.name, targets)
+        }
+        return result
+    }
+
+    /**
+     * Compute the upward rank of each process
+     *
+     * @param graph The processes graph, see {@link #processGraph(nextflow.dag.DAG)}
+     * @param duration A closure returning the duration of a process given its name
+     * @return A map associating each process name to its rank
+     */
+    @PackageScope
+    static Map<String,Double> upwardRanks(Map<String,Set<String>> graph, Closure<Double> duration) {
+        final result = new HashMap<String,Double>(graph.size())
+        final visiting = new HashSet<String>()
+        for( String it : graph.keySet() )
+            upwardRank0(it, graph, duration, result, visiting)
+        return result
+    }
+
+    static private double upwardRank0(String process, Map<String,Set<String>> graph, Closure<Double> duration, Map<String,Double> ranks, Set<String> visiting) {
+        final rank = ranks.get(process)
+        if( rank != null )
+            return rank
+        // a cycle (e.g. a recursive workflow) does not add to the rank
+        if( !visiting.add(process) )
+            return 0d
+        double max = 0
+        for( String it : graph.getOrDefault(process, Collections.<String>emptySet()) )
+            max = Math.max(max, upwardRank0(it, graph, duration, ranks, visiting))
+        visiting.remove(process)
+        final result = duration.call(process) + max
+        ranks.put(process, result)
+        return result
+    }
+
+}
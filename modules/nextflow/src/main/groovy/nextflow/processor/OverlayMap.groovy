@@ -0,0 +1,234 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import groovy.transform.CompileStatic
+/**
+ * A copy-on-write map layered on top of a shared base map.
+ *
+ * Reads fall through to the base map unless the entry has been overridden
+ * or removed. Writes only modify the local layer, which is allocated on the first
+ * write, therefore the base map is never modified and can be shared by many instances.
+ * The base map must not change once the overlay is created, as the size is tracked
+ * incrementally on each write.
+ */
+@CompileStatic
+class OverlayMap extends AbstractMap<String,Object> {
+
+    final private Map<String,Object> base
+
+    private Map<String,Object> local
+
+    private Set<String> removed
+
+    private int size
+
+    OverlayMap(Map<String,Object> base) {
+        assert base != null
+        this.base = base
+        this.size = base.size()
+    }
+
+    private OverlayMap(Map<String,Object> base, Map<String,Object> local, Set<String> removed, int size) {
+        this.base = base
+        this.local = local
+        this.removed = removed
+        this.size = size
+    }
+
+    /**
+     * @return A copy of this map sharing the same base map
+     */
+    OverlayMap copy() {
+        new OverlayMap(base,
+                local != null ? new HashMap<String,Object>(local) : null,
+                removed != null ? new HashSet<String>(removed) : null,
+                size)
+    }
+
+    /**
+     * @return The number of entries overridden or removed, mostly for testing purposes
+     */
+    int getOverrides() {
+        (local != null ? local.size() : 0) + (removed != null ? removed.size() : 0)
+    }
+
+    @Override
+    Object get(Object key) {
+        if( local != null && local.containsKey(key) )
+            return local.get(key)
+        if( removed != null && removed.contains(key) )
+            return null
+        return base.get(key)
+    }
+
+    @Override
+    boolean containsKey(Object key) {
+        if( local != null && local.containsKey(key) )
+            return true
+        if( removed != null && removed.contains(key) )
+            return false
+        return base.containsKey(key)
+    }
+
+    @Override
+    Object put(String key, Object value) {
+        if( !containsKey(key) )
+            size++
+        final result = get(key)
+        if( local == null )
+            local = new HashMap<>()
+        local.put(key, value)
+        removed?.remove(key)
+        return result
+    }
+
+    @Override
+    Object remove(Object key) {
+        if( containsKey(key) )
+            size--
+        final result = get(key)
+        local?.remove(key)
+        if( base.containsKey(key) ) {
+            if( removed == null )
+                removed = new HashSet<>()
+            removed.add(key as String)
+        }
+        return result
+    }
+
+    @Override
+    void clear() {
+        local = null
+        removed = new HashSet<>(base.keySet())
+        size = 0
+    }
+
+    @Override
+    int size() {
+        return size
+    }
+
+    @Override
+    boolean isEmpty() {
+        return size == 0
+    }
+
+    /**
+     * @return A live view of the merged entries, the base entries first. Removing an entry
+     *      or setting its value writes through to the local layer
+     */
+    @Override
+    Set<Map.Entry<String,Object>> entrySet() {
+        return new EntrySet()
+    }
+
+    @CompileStatic
+    private class EntrySet extends AbstractSet<Map.Entry<String,Object>> {
+        @Override
+        Iterator<Map.Entry<String,Object>> iterator() { new EntryIterator() }
+
+        @Override
+        int size() { OverlayMap.this.size() }
+    }
+
+    @CompileStatic
+    private class OverlayEntry implements Map.Entry<String,Object> {
+        final private String key
+
+        OverlayEntry(String key) {
+            this.key = key
+        }
+
+        @Override
+        String getKey() { key }
+
+        @Override
+        Object getValue() { OverlayMap.this.get(key) }
+
+        @Override
+        Object setValue(Object value) { OverlayMap.this.put(key, value) }
+
+        @Override
+        boolean equals(Object other) {
+            if( !(other instanceof Map.Entry) )
+                return false
+            final that = (Map.Entry)other
+            return key == that.getKey() && getValue() == that.getValue()
+        }
+
+        @Override
+        int hashCode() { key.hashCode() ^ (getValue()?.hashCode() ?: 0) }
+
+        @Override
+        String toString() { "$key=${getValue()}" }
+    }
+
+    /**
+     * Iterates the base keys not removed, then the keys only defined in the local layer.
+     * The base map is never modified and the local keys are iterated on a copy, therefore
+     * the map can be modified while iterating
+     */
+    @CompileStatic
+    private class EntryIterator implements Iterator<Map.Entry<String,Object>> {
+        final private Iterator<String> baseKeys = base.keySet().iterator()
+        private Iterator<String> localKeys
+        private String next
+        private String last
+
+        private String advance() {
+            while( baseKeys.hasNext() ) {
+                final key = baseKeys.next()
+                if( containsKey(key) )
+                    return key
+            }
+            if( localKeys == null )
+                localKeys = local != null ? new ArrayList<String>(local.keySet()).iterator() : Collections.<String>emptyIterator()
+            while( localKeys.hasNext() ) {
+                final key = localKeys.next()
+                if( !base.containsKey(key) && containsKey(key) )
+                    return key
+            }
+            return null
+        }
+
+        @Override
+        boolean hasNext() {
+            if( next == null )
+                next = advance()
+            return next != null
+        }
+
+        @Override
+        Map.Entry<String,Object> next() {
+            if( !hasNext() )
+                throw new NoSuchElementException()
+            last = next
+            next = null
+            return new OverlayEntry(last)
+        }
+
+        @Override
+        void remove() {
+            if( last == null )
+                throw new IllegalStateException()
+            OverlayMap.this.remove(last)
+            last = null
+        }
+    }
+
+}
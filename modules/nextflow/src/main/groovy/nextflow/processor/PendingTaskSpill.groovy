@@ -0,0 +1,217 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import java.nio.ByteBuffer
+import java.nio.channels.FileChannel
+import java.nio.file.Path
+import java.nio.file.StandardOpenOption
+
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+import nextflow.file.FileHelper
+import nextflow.script.params.InParam
+import nextflow.util.KryoHelper
+/**
+ * Moves the data of the tasks waiting for submission to a local append-only log,
+ * to bound the memory used by the pending tasks queue.
+ *
+ * The task handler and run objects are retained in the pending queue, therefore its
+ * ordering is not affected, while the task input values, context variables and script
+ * are serialized to the log and released. They are restored just before the task is
+ * submitted. The log index only holds the offset of each spilled task record.
+ *
+ * The resource directives are evaluated before the task is spilled, because dynamic
+ * directives depend on the task context and are checked before the task is restored.
+ */
+@Slf4j
+@CompileStatic
+class PendingTaskSpill {
+
+    /**
+     * The directives read by the polling monitors to decide whether a task can be submitted
+     */
+    static final private List<String> RESOURCE_DIRECTIVES = ['cpus', 'memory', 'disk', 'time', 'accelerator']
+
+    final private int threshold
+
+    final private Map<TaskId,Long> index = new HashMap<>()
+
+    private Path dir
+
+    private FileChannel channel
+
+    private long spilledCount
+
+    private long restoredCount
+
+    PendingTaskSpill(int threshold) {
+        assert threshold > 0
+        this.threshold = threshold
+    }
+
+    /**
+     * @return The number of pending tasks kept in memory before spilling the following ones
+     */
+    int getThreshold() { threshold }
+
+    /**
+     * @return The number of tasks currently spilled
+     */
+    synchronized int getSize() { index.size() }
+
+    @PackageScope long getSpilledCount() { spilledCount }
+
+    @PackageScope long getRestoredCount() { restoredCount }
+
+    synchronized boolean isSpilled(TaskRun task) {
+        index.containsKey(task.id)
+    }
+
+    /**
+     * Serialize the task data to the log and release it
+     *
+     * @param task The {@link TaskRun} to spill
+     * @return {@code true} when the task has been spilled or {@code false} when its data cannot be serialized
+     */
+    boolean spill(TaskRun task) {
+        try {
+            // the task config caches the resolved values, therefore they stay available once the context is released
+            for( String it : RESOURCE_DIRECTIVES )
+                task.config.get(it)
+        }
+        catch( Throwable e ) {
+            // keep the task in memory, the error is reported when the task is submitted
+            log.trace "[${task.name}] Unable to resolve directives of pending task -- cause: ${e.message ?: e}"
+            return false
+        }
+
+        final holder = task.context.getHolder()
+        final values = new LinkedHashMap<String,Object>(holder)
+        values.remove(TaskProcessor.TASK_CONTEXT_PROPERTY_NAME)
+        final payload = new ArrayList(4)
+        payload.add(values)
+        payload.add(new ArrayList(task.inputs.values()))
+        payload.add(task.script)
+        payload.add(task.stdin)
+
+        byte[] bytes
+        try {
+            bytes = serialize(payload)
+        }
+        catch( Throwable e ) {
+            log.trace "[${task.name}] Unable to spill pending task -- cause: ${e.message ?: e}"
+            return false
+        }
+
+        synchronized (this) {
+            if( index.containsKey(task.id) )
+                return true
+            index.put(task.id, append(bytes))
+            spilledCount++
+        }
+
+        // release the task data
+        holder.keySet().retainAll(Collections.singleton(TaskProcessor.TASK_CONTEXT_PROPERTY_NAME))
+        for( Map.Entry<InParam,Object> entry : task.inputs.entrySet() )
+            entry.setValue(null)
+        task.script = null
+        task.stdin = null
+        return true
+    }
+
+    /**
+     * Restore the data of a spilled task, it does nothing when the task is not spilled
+     *
+     * @param task The {@link TaskRun} to restore
+     */
+    void restore(TaskRun task) {
+        byte[] bytes
+        synchronized (this) {
+            final offset = index.remove(task.id)
+            if( offset == null )
+                return
+            bytes = read(offset)
+            restoredCount++
+            // all records have been consumed, the log can be reset
+            if( index.isEmpty() )
+                channel.truncate(0)
+        }
+
+        final payload = (List)KryoHelper.deserialize(bytes)
+        task.context.getHolder().putAll((Map)payload.get(0))
+        final values = (List)payload.get(1)
+        int i=0
+        for( Map.Entry<InParam,Object> entry : task.inputs.entrySet() )
+            entry.setValue(values.get(i++))
+        task.script = payload.get(2)
+        task.stdin = payload.get(3)
+    }
+
+    protected byte[] serialize(List payload) {
+        KryoHelper.serialize(payload)
+    }
+
+    private long append(byte[] bytes) {
+        if( channel == null ) {
+            dir = FileHelper.createLocalDir('nxf-pending-')
+            channel = FileChannel.open(dir.resolve('tasks.log'), StandardOpenOption.CREATE, StandardOpenOption.READ, StandardOpenOption.WRITE)
+            log.debug "Spilling pending tasks to: $dir"
+        }
+        final offset = channel.size()
+        final buffer = ByteBuffer.allocate(4 + bytes.length)
+        buffer.putInt(bytes.length)
+        buffer.put(bytes)
+        buffer.flip()
+        long pos = offset
+        while( buffer.hasRemaining() )
+            pos += channel.write(buffer, pos)
+        return offset
+    }
+
+    private byte[] read(long offset) {
+        final header = ByteBuffer.allocate(4)
+        readFully(header, offset)
+        final result = ByteBuffer.allocate(header.getInt(0))
+        readFully(result, offset + 4)
+        return result.array()
+    }
+
+    private void readFully(ByteBuffer buffer, long pos) {
+        while( buffer.hasRemaining() ) {
+            final n = channel.read(buffer, pos)
+            if( n < 0 )
+                throw new IllegalStateException("Unexpected end of pending tasks log at position: $pos")
+            pos += n
+        }
+    }
+
+    /**
+     * Close and delete the log
+     */
+    synchronized void close() {
+        index.clear()
+        if( channel == null )
+            return
+        log.debug "Pending tasks spill stats > spilled=$spilledCount; restored=$restoredCount"
+        channel.close()
+        channel = null
+        FileHelper.deletePath(dir)
+    }
+
+}
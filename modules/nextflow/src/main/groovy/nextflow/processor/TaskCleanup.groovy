@@ -0,0 +1,187 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import java.util.concurrent.BlockingQueue
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.LongAdder
+
+import com.google.common.util.concurrent.RateLimiter
+import groovy.transform.CompileStatic
+import groovy.util.logging.Slf4j
+import nextflow.util.Duration
+import nextflow.util.Throttle
+/**
+ * Runs the non-critical cleanup actions of completed tasks in the background,
+ * e.g. the deletion of the cloud jobs and temporary log files, so that the
+ * monitor loop only carries out the task state transitions.
+ *
+ * Actions are executed by a small pool of low priority threads at a paced rate.
+ * When the queue of pending actions is full the caller runs the action inline,
+ * slowing down the monitor loop until the backlog is drained.
+ * On shutdown the remaining actions are completed, without pacing, before returning.
+ */
+@Slf4j
+@CompileStatic
+class TaskCleanup {
+
+    static final private double DEFAULT_RATE_LIMIT = 20d
+
+    static final private int DEFAULT_QUEUE_SIZE = 10_000
+
+    static final private int DEFAULT_THREADS = 1
+
+    private final String name
+
+    private final int threads
+
+    private final RateLimiter rateLimiter
+
+    private final BlockingQueue<Action> queue
+
+    private final LongAdder completed = new LongAdder()
+
+    private final LongAdder failed = new LongAdder()
+
+    private final LongAdder inline = new LongAdder()
+
+    private final Duration dumpInterval = Duration.of('1 min')
+
+    private final List<Thread> workers = new ArrayList<>()
+
+    private volatile boolean terminated
+
+    @CompileStatic
+    static private class Action {
+        final String description
+        final Runnable target
+
+        Action(String description, Runnable target) {
+            this.description = description
+            this.target = target
+        }
+    }
+
+    TaskCleanup(String name, int threads=DEFAULT_THREADS, double rateLimit=DEFAULT_RATE_LIMIT, int queueSize=DEFAULT_QUEUE_SIZE) {
+        if( threads < 1 )
+            throw new IllegalArgumentException("Invalid cleanup threads value: $threads -- it must be a positive integer")
+        if( rateLimit <= 0 )
+            throw new IllegalArgumentException("Invalid cleanup rate limit value: $rateLimit -- it must be a positive number")
+        if( queueSize < 1 )
+            throw new IllegalArgumentException("Invalid cleanup queue size value: $queueSize -- it must be a positive integer")
+        this.name = name
+        this.threads = threads
+        this.rateLimiter = RateLimiter.create(rateLimit)
+        this.queue = new LinkedBlockingQueue<>(queueSize)
+    }
+
+    TaskCleanup start() {
+        for( int i=0; i<threads; i++ ) {
+            final thread = new Thread(this.&cleanupLoop as Runnable, "Task cleanup ($name)-${i+1}")
+            thread.setDaemon(true)
+            thread.setPriority(Thread.MIN_PRIORITY)
+            thread.start()
+            workers.add(thread)
+        }
+        return this
+    }
+
+    /**
+     * @return The number of cleanup actions not yet executed
+     */
+    int getPendingCount() { queue.size() }
+
+    long getCompletedCount() { completed.sum() }
+
+    long getFailedCount() { failed.sum() }
+
+    /**
+     * @return The number of actions executed by the caller because the queue was full
+     */
+    long getInlineCount() { inline.sum() }
+
+    /**
+     * Queue a cleanup action. When the queue of pending actions is full, or the
+     * cleanup has been shutdown, the action is executed by the calling thread
+     *
+     * @param description A short description of the action used for logging purposes
+     * @param target The cleanup action to execute
+     */
+    void submit(String description, Runnable target) {
+        final action = new Action(description, target)
+        if( terminated || !queue.offer(action) ) {
+            log.trace "Task cleanup queue full (${queue.size()}) -- running ${description} inline"
+            runInline(action)
+        }
+        // the action may have been queued after the remaining ones were drained by the shutdown,
+        // when it's still in the queue take it back, otherwise it has been picked up by a worker
+        else if( terminated && queue.remove(action) ) {
+            log.trace "Task cleanup terminated -- running ${description} inline"
+            runInline(action)
+        }
+    }
+
+    private void runInline(Action action) {
+        inline.increment()
+        run0(action)
+    }
+
+    protected void cleanupLoop() {
+        while( !terminated || queue.size() ) {
+            final action = queue.poll(1, TimeUnit.SECONDS)
+            if( action != null ) {
+                // the backlog is drained as fast as possible on shutdown
+                if( !terminated )
+                    rateLimiter.acquire()
+                run0(action)
+            }
+            Throttle.after(dumpInterval) { dumpStatus() }
+        }
+    }
+
+    protected void run0(Action action) {
+        try {
+            action.target.run()
+            completed.increment()
+        }
+        catch( Throwable e ) {
+            failed.increment()
+            log.warn "Unable to cleanup ${action.description} -- see the log file for details", e
+        }
+    }
+
+    protected void dumpStatus() {
+        log.debug "Task cleanup ($name) > pending: ${queue.size()}; completed: ${completed.sum()}; failed: ${failed.sum()}; inline: ${inline.sum()}"
+    }
+
+    /**
+     * Complete the remaining queued actions and stop the cleanup threads
+     */
+    void shutdown() {
+        terminated = true
+        for( Thread it : workers )
+            it.join()
+        workers.clear()
+        // run any action left behind i.e. when the workers were never started
+        Action action
+        while( (action=queue.poll()) != null )
+            run0(action)
+        dumpStatus()
+    }
+
+}
@@ -53,9 +53,31 @@ class TaskConfig extends LazyMap implements Cloneable {
         super(entries)
     }
 
+    /**
+     * Create a task config sharing the entries of the given process config map.
+     * The task specific settings are kept in a copy-on-write layer, therefore
+     * the shared map is never modified.
+     *
+     * @param shared The process config entries, it must not be modified once shared
+     * @return The {@link TaskConfig} instance
+     */
+    static TaskConfig overlay( Map<String,Object> shared ) {
+        final result = new TaskConfig()
+        result.setTarget(new OverlayMap(shared))
+        for( Map.Entry<String,Object> entry : shared.entrySet() ) {
+            // the 'ext' map holds the task binding, a copy is required for each task
+            if( entry.key == 'ext' && entry.value instanceof Map )
+                result.put('ext', entry.value)
+            else if( isDynamicValue(entry.value) || (entry.key == 'module' && entry.value instanceof List && (entry.value as List).any { it instanceof Closure }) )
+                result.setDynamic(true)
+        }
+        return result
+    }
+
     TaskConfig clone() {
         def copy = (TaskConfig)super.clone()
-        copy.setTarget(new HashMap<>(this.getTarget()))
+        final target = this.getTarget()
+        copy.setTarget(target instanceof OverlayMap ? ((OverlayMap)target).copy() : new HashMap<>(target))
         copy.newCache()
         return copy
     }
@@ -662,15 +684,23 @@ class LazyMap implements Map<String,Object> {
     }
 
     Object put( String key, Object value ) {
-        if( value instanceof Closure ) {
+        if( isDynamicValue(value) )
             dynamic |= true
-        }
-        else if( value instanceof GString ) {
+        return target.put(key, value)
+    }
+
+    /**
+     * @return {@code true} when the value is resolved lazily i.e. a closure or a string interpolating a closure
+     */
+    static protected boolean isDynamicValue( Object value ) {
+        if( value instanceof Closure )
+            return true
+        if( value instanceof GString ) {
             for( int i=0; i<value.valueCount; i++ )
                 if (value.values[i] instanceof Closure)
-                    dynamic |= true
+                    return true
         }
-        return target.put(key, value)
+        return false
     }
 
     @Override
@@ -82,6 +82,21 @@ class TaskContext implements Map<String,Object>, Cloneable {
         log.trace "Binding names for '$name' > $variableNames"
     }
 
+    /**
+     * Create a task context sharing the variable names computed by the processor
+     *
+     * @param processor The {@link TaskProcessor} owning the task
+     * @param holder The map holding the task variables
+     * @param variableNames The read-only set of the variables referenced in the global script binding
+     */
+    TaskContext( TaskProcessor processor, Map holder, Set<String> variableNames ) {
+        assert holder != null
+        this.holder = holder
+        this.script = processor.ownerScript
+        this.name = processor.name
+        this.variableNames = variableNames
+    }
+
     protected TaskContext(Script script, Map holder, String name) {
         this.script = script
         this.holder = holder
@@ -184,6 +184,8 @@ abstract class TaskHandler {
         record.time = task.config.getTime()?.toMillis()
         record.env = task.getEnvironmentStr()
         record.out_label = task.config.getOutLabel()?.getLabel()
+        if( task.inputBytes != null )
+            record.input_bytes = task.inputBytes
         record.executorName = task.processor.executor.getName()
 
         if( isCompleted() ) {
@@ -258,4 +260,21 @@ abstract class TaskHandler {
         task.processor.forksCount?.decrement()
     }
 
+    /**
+     * Run a non-critical cleanup action of the completed task, e.g. the deletion of the
+     * job or of a temporary file. The action is deferred to the executor {@link TaskCleanup}
+     * when the {@code asyncCleanup} setting is enabled, otherwise it is run immediately
+     *
+     * @param description A short description of the action used for logging purposes
+     * @param action The cleanup action to run
+     */
+    protected void deferCleanup(String description, Runnable action) {
+        final monitor = task?.processor?.executor?.getMonitor()
+        final cleanup = monitor instanceof TaskPollingMonitor ? ((TaskPollingMonitor)monitor).getTaskCleanup() : null
+        if( cleanup )
+            cleanup.submit(description, action)
+        else
+            action.run()
+    }
+
 }
@@ -116,6 +116,16 @@ class TaskPollingMonitor implements TaskMonitor {
      */
     private RateLimiter submitRateLimit
 
+    /**
+     * Spills the data of pending tasks exceeding the configured threshold to disk
+     */
+    private PendingTaskSpill pendingSpill
+
+    /**
+     * Runs the non-critical cleanup of completed tasks in the background when {@code asyncCleanup} is enabled
+     */
+    private TaskCleanup taskCleanup
+
     /**
      * Create the task polling monitor with the provided named parameters object.
      * <p>
@@ -229,11 +239,16 @@ class TaskPollingMonitor implements TaskMonitor {
      */
     @Override
     void schedule(TaskHandler handler) {
+        // notify before the task data can be spilled, since the trace record needs it
+        session.notifyTaskPending(handler)
+        // the task is spilled before being added to the queue, therefore the file is written
+        // without holding the lock and the task cannot be submitted while it's being spilled
+        if( pendingSpill && pendingQueue.size() >= pendingSpill.threshold )
+            pendingSpill.spill(handler.task)
         pendingLock.lock()
         try{
             pendingQueue << handler
             taskAvail.signal()  // signal that a new task is available for execution
-            session.notifyTaskPending(handler)
             log.trace "Scheduled task > $handler"
         }
         finally {
@@ -290,6 +305,12 @@ class TaskPollingMonitor implements TaskMonitor {
 
         //
         this.submitRateLimit = createSubmitRateLimit()
+        this.pendingSpill = createPendingSpill()
+        // with the critical path policy the pending tasks are kept ordered by rank
+        final ranker = session.getCriticalPathRanker()
+        if( ranker )
+            this.pendingQueue = ranker.createQueue()
+        this.taskCleanup = createTaskCleanup()
 
         // remove pending tasks on termination
         session.onShutdown { this.cleanup() }
@@ -311,6 +332,30 @@ class TaskPollingMonitor implements TaskMonitor {
         return this
     }
 
+    protected PendingTaskSpill createPendingSpill() {
+        final threshold = session.getExecConfigProp(name, 'spillThreshold', 0) as int
+        if( threshold <= 0 )
+            return null
+        log.debug "Creating pending tasks spill for executor '$name' > threshold: $threshold"
+        return new PendingTaskSpill(threshold)
+    }
+
+    protected TaskCleanup createTaskCleanup() {
+        final enabled = session.getExecConfigProp(name, 'asyncCleanup', false) as boolean
+        if( !enabled )
+            return null
+        final threads = session.getExecConfigProp(name, 'cleanupThreads', 1) as int
+        final rateLimit = session.getExecConfigProp(name, 'cleanupRateLimit', 20) as double
+        final queueSize = session.getExecConfigProp(name, 'cleanupQueueSize', 10_000) as int
+        log.debug "Creating task cleanup for executor '$name' > threads: $threads; rateLimit: $rateLimit; queueSize: $queueSize"
+        return new TaskCleanup(name, threads, rateLimit, queueSize).start()
+    }
+
+    /**
+     * @return The {@link TaskCleanup} running the deferred cleanup of completed tasks or {@code null} when not enabled
+     */
+    TaskCleanup getTaskCleanup() { taskCleanup }
+
     protected RateLimiter createSubmitRateLimit() {
         def limit = session.getExecConfigProp(name,'submitRateLimit',null) as String
         if( !limit )
@@ -468,6 +513,8 @@ class TaskPollingMonitor implements TaskMonitor {
 
             def msg = []
             msg << "%% executor $name > tasks in the submission queue: ${pending} -- tasks to be submitted are shown below"
+            if( pendingSpill?.size )
+                msg << "%% tasks spilled to disk: ${pendingSpill.size}"
             // dump the first 10 tasks
             def i=0; def itr = pendingQueue.iterator()
             while( i++<10 && itr.hasNext() )
@@ -565,12 +612,14 @@ class TaskPollingMonitor implements TaskMonitor {
                 if( !canSubmit(handler) )
                     continue
 
+                pendingSpill?.restore(handler.task)
                 schedulerBatch?.startSubmit()
                 count++
                 handler.incProcessForks()
                 submit(handler)
             }
             catch ( Throwable e ) {
+                pendingSpill?.restore(handler.task)
                 handleException(handler, e)
                 session.notifyTaskComplete(handler)
             }
@@ -644,6 +693,16 @@ class TaskPollingMonitor implements TaskMonitor {
      * Kill all pending jobs when current execution session is aborted
      */
     protected void cleanup() {
+        pendingSpill?.close()
+        try {
+            killRunningTasks()
+        }
+        finally {
+            taskCleanup?.shutdown()
+        }
+    }
+
+    protected void killRunningTasks() {
         if( !runningQueue.size() )
             return
         if( session.disableJobsCancellation ) {
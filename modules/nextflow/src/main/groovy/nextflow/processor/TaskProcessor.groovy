@@ -15,7 +15,7 @@
  */
 package nextflow.processor
 
-import nextflow.file.LocalFileWalker
+import nextflow.file.OutfilesListing
 import nextflow.k8s.localdata.LocalPath
 
 import static nextflow.processor.ErrorStrategy.*
@@ -57,6 +57,7 @@ import nextflow.Session
 import nextflow.ast.NextflowDSLImpl
 import nextflow.ast.TaskCmdXform
 import nextflow.ast.TaskTemplateVarsXform
+import nextflow.cache.ResumePrefetcher
 import nextflow.cloud.CloudSpotTerminationException
 import nextflow.dag.NodeMarker
 import nextflow.exception.FailedGuardException
@@ -72,6 +73,7 @@ import nextflow.executor.CachedTaskHandler
 import nextflow.executor.Executor
 import nextflow.executor.StoredTaskHandler
 import nextflow.extension.CH
+import nextflow.extension.ChannelCredits
 import nextflow.extension.DataflowHelper
 import nextflow.file.FileHelper
 import nextflow.file.FileHolder
@@ -172,6 +174,11 @@ class TaskProcessor {
      */
     protected BodyDef taskBody
 
+    /**
+     * The task body variables shared by the task contexts, see {@link #getContextVariableNames()}
+     */
+    private volatile Set<String> contextVariableNames
+
     /**
      * The corresponding {@code DataflowProcessor} which will receive and
      * manage accordingly the task inputs
@@ -237,6 +244,11 @@ class TaskProcessor {
      */
     protected AtomicIntegerArray openPorts
 
+    /**
+     * The credits of the bounded input channels consumed by this process
+     */
+    private List<ChannelCredits> inputCredits = []
+
     /**
      * Process ID number. The first is 1, the second 2 and so on ..
      */
@@ -364,6 +376,20 @@ class TaskProcessor {
         return result
     }
 
+    /**
+     * @return The names of the variables referenced by the task body and not declared
+     * as inputs or outputs. The same read-only set is shared by all the task contexts
+     */
+    Set<String> getContextVariableNames() {
+        if( contextVariableNames == null ) {
+            Set<String> names = taskBody.getValNames() ?: Collections.<String>emptySet()
+            if( names )
+                names = names - getDeclaredNames()
+            contextVariableNames = Collections.unmodifiableSet(new HashSet<String>(names))
+        }
+        return contextVariableNames
+    }
+
     LongAdder getForksCount() { forksCount }
 
     int getMaxForks() { maxForks }
@@ -540,6 +566,9 @@ class TaskProcessor {
         // this allows us to manage them independently from the operator life-cycle
         this.singleton = allScalarValues && !hasEachParams
         this.openPorts = createPortsArray(opInputs.size())
+        // with `each` params a received item may spawn many tasks, therefore bounded inputs are not tracked
+        if( !iteratorIndexes )
+            this.inputCredits = registerInputCredits(opInputs)
         config.getOutputs().setSingleton(singleton)
         def interceptor = new TaskProcessorInterceptor(opInputs, singleton)
         def params = [inputs: opInputs, maxForks: session.poolSize, listeners: [interceptor] ]
@@ -553,6 +582,24 @@ class TaskProcessor {
         start(operator)
     }
 
+    /**
+     * Register this process as a consumer of the bounded input channels
+     *
+     * @param inputs The operator input channels, the last one is the control channel
+     * @return The list of the credits to be released when a task completes
+     */
+    protected List<ChannelCredits> registerInputCredits(List inputs) {
+        final result = new ArrayList<ChannelCredits>()
+        for( int i=0; i<inputs.size()-1; i++ ) {
+            final credits = ChannelCredits.of(inputs.get(i))
+            if( credits != null ) {
+                credits.addConsumer(this, name)
+                result.add(credits)
+            }
+        }
+        return result
+    }
+
     private start(DataflowProcessor op) {
         if( !NF.dsl2 ) {
             op.start()
@@ -604,6 +651,9 @@ class TaskProcessor {
         if( !checkWhenGuard(task) )
             return
 
+        // set the resources predicted from the previous runs before the task script is rendered
+        session.resourcePredictor?.apply(task)
+
         TaskClosure block
         if( session.stubRun && (block=task.config.getStubBlock()) ) {
             task.resolve(block)
@@ -715,7 +765,7 @@ class TaskProcessor {
                 processor: this,
                 type: scriptType,
                 config: config.createTaskConfig(),
-                context: new TaskContext(this)
+                context: new TaskContext(this, [:], getContextVariableNames())
         )
 
         // setup config
@@ -771,13 +821,15 @@ class TaskProcessor {
             Path resumeDir = null
             boolean exists = false
             try {
-                def entry = session.cache.getTaskEntry(hash, this)
+                // use the entry loaded ahead of time by the resume prefetcher when available
+                final prefetched = session.resumePrefetcher?.take(hash)
+                def entry = prefetched ? prefetched.toTaskEntry(this) : session.cache.getTaskEntry(hash, this)
                 resumeDir = entry ? FileHelper.asPath(entry.trace.getWorkDir()) : null
                 if( resumeDir )
-                    exists = resumeDir.exists()
+                    exists = prefetched ? prefetched.exists : resumeDir.exists()
 
-                log.trace "[${safeTaskName(task)}] Cacheable folder=${resumeDir?.toUriString()} -- exists=$exists; try=$tries; shouldTryCache=$shouldTryCache; entry=$entry"
-                def cached = shouldTryCache && exists && checkCachedOutput(task.clone(), resumeDir, hash, entry)
+                log.trace "[${safeTaskName(task)}] Cacheable folder=${resumeDir?.toUriString()} -- exists=$exists; try=$tries; shouldTryCache=$shouldTryCache; prefetched=${prefetched!=null}; entry=$entry"
+                def cached = shouldTryCache && exists && checkCachedOutput(task.clone(), resumeDir, hash, entry, prefetched)
                 if( cached )
                     break
             }
@@ -877,6 +929,15 @@ class TaskProcessor {
      * @return {@code true} when all outputs are available, {@code false} otherwise
      */
     final boolean checkCachedOutput(TaskRun task, Path folder, HashCode hash, TaskEntry entry) {
+        checkCachedOutput(task, folder, hash, entry, null)
+    }
+
+    /**
+     * Check whenever the outputs for the specified task already exist
+     *
+     * @param prefetched The task entry loaded by the {@link ResumePrefetcher} or {@code null} to read the task exit file
+     */
+    final boolean checkCachedOutput(TaskRun task, Path folder, HashCode hash, TaskEntry entry, ResumePrefetcher.Entry prefetched) {
 
         // check if exists the task exit code file
         def exitCode = null
@@ -884,7 +945,7 @@ class TaskProcessor {
         if( task.type == ScriptType.SCRIPTLET ) {
             def str
             try {
-                str = exitFile.text?.trim()
+                str = prefetched ? prefetched.getExitText() : exitFile.text?.trim()
             }
             catch( IOException e ) {
                 log.trace "[${safeTaskName(task)}] Exit file can't be read > $exitFile -- return false -- Cause: ${e.message}"
@@ -1006,6 +1067,7 @@ class TaskProcessor {
                 session.getExecService().submit {
                     try {
                         taskCopy.runType = RunType.RETRY
+                        session.resourcePredictor?.apply(taskCopy)
                         checkCachedOrLaunchTask( taskCopy, taskCopy.hash, false )
                     }
                     catch( Throwable e ) {
@@ -1133,6 +1195,7 @@ class TaskProcessor {
                     try {
                         taskCopy.config.attempt = taskCopy.config.attempt ? taskCopy.config.attempt + 1 : 2
                         taskCopy.runType = RunType.RETRY
+                        session.resourcePredictor?.apply(taskCopy)
                         taskCopy.resolve(taskBody)
                         checkCachedOrLaunchTask( taskCopy, taskCopy.hash, false )
                     }
@@ -1481,6 +1544,9 @@ class TaskProcessor {
     final protected void collectOutputs( TaskRun task, Path workDir, def stdout, Map context ) {
         log.trace "<$name> collecting output: ${task.outputs}"
 
+        // the outfiles listing is read once and shared by all the file outputs
+        OutfilesListing listing = null
+        boolean listingLoaded = false
         for( OutParam param : task.outputs.keySet() ) {
 
             switch( param ) {
@@ -1489,7 +1555,11 @@ class TaskProcessor {
                     break
 
                 case FileOutParam:
-                    collectOutFiles(task, (FileOutParam)param, workDir, context)
+                    if( !listingLoaded ) {
+                        listing = OutfilesListing.read(workDir)
+                        listingLoaded = true
+                    }
+                    collectOutFiles(task, (FileOutParam)param, workDir, context, listing)
                     break
 
                 case ValueOutParam:
@@ -1568,6 +1638,10 @@ class TaskProcessor {
 
 
     protected void collectOutFiles( TaskRun task, FileOutParam param, Path workDir, Map context ) {
+        collectOutFiles(task, param, workDir, context, OutfilesListing.read(workDir))
+    }
+
+    protected void collectOutFiles( TaskRun task, FileOutParam param, Path workDir, Map context, OutfilesListing listing ) {
 
         final List<Path> allFiles = []
         // type file parameter can contain a multiple files pattern separating them with a special character
@@ -1591,11 +1665,13 @@ class TaskProcessor {
                 def path = param.glob ? splitter.strip(filePattern) : filePattern
                 def file = workDir.resolve(path)
                 def origFile = file
-                def outfiles = workDir.resolve( ".command.outfiles" ).toFile()
+                // files found in the outfiles listing do not need to be checked on the storage,
+                // only the ones not listed (or reported as missing) fall back to the path resolution
+                def listed = listing?.resolve(file, workDir)
                 def exists
-                if( outfiles.exists() ){
-                    file = LocalFileWalker.exists( outfiles, file, workDir, param.followLinks ? LinkOption.NOFOLLOW_LINKS : null )
-                    exists = file != null
+                if( listed != null ) {
+                    file = listed
+                    exists = true
                 } else {
                     exists = param.followLinks ? file.exists() : file.exists(LinkOption.NOFOLLOW_LINKS)
                 }
@@ -2329,11 +2405,17 @@ class TaskProcessor {
 
         // increment the number of processes executed
         state.update { StateObj it -> it.incCompleted() }
+
+        // give back the credits of the bounded input channels
+        for( ChannelCredits credits : inputCredits )
+            credits.release(this)
     }
 
     protected void terminateProcess() {
         log.trace "<${name}> Sending poison pills and terminating process"
         sendPoisonPill()
+        for( ChannelCredits credits : inputCredits )
+            credits.removeConsumer(this)
         session.notifyProcessTerminate(this)
         session.processDeregister(this)
     }
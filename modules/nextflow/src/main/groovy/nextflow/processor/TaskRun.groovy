@@ -132,6 +132,11 @@ class TaskRun implements Cloneable {
      */
     boolean cached
 
+    /**
+     * The total size of the task input files, computed only when resources prediction is enabled
+     */
+    Long inputBytes
+
     /**
      * Task produced standard output
      */
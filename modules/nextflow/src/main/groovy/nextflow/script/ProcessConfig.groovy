@@ -147,6 +147,11 @@ class ProcessConfig implements Map<String,Object>, Cloneable {
      */
     private outputs = new OutputsList()
 
+    /**
+     * Read-only snapshot of the config properties shared by the task configs
+     */
+    private Map<String,Object> taskConfigBase
+
     /**
      * Initialize the taskConfig object with the defaults values
      *
@@ -302,7 +307,23 @@ class ProcessConfig implements Map<String,Object>, Cloneable {
     BaseScript getOwnerScript() { ownerScript }
 
     TaskConfig createTaskConfig() {
-        return new TaskConfig(configProperties)
+        // all tasks share the same snapshot of the process config unless it changes
+        Map<String,Object> base = taskConfigBase
+        if( base == null || !sameEntries(base, configProperties) ) {
+            base = Collections.unmodifiableMap(new LinkedHashMap<String,Object>(configProperties))
+            taskConfigBase = base
+        }
+        return TaskConfig.overlay(base)
+    }
+
+    static private boolean sameEntries( Map<String,Object> snapshot, Map<String,Object> current ) {
+        if( snapshot.size() != current.size() )
+            return false
+        for( Map.Entry<String,Object> entry : current.entrySet() ) {
+            if( !snapshot.containsKey(entry.key) || !snapshot.get(entry.key).is(entry.value) )
+                return false
+        }
+        return true
     }
 
     /**
@@ -29,6 +29,7 @@ import groovyx.gpars.dataflow.DataflowWriteChannel
 import nextflow.Channel
 import nextflow.exception.StopSplitIterationException
 import nextflow.extension.CH
+import nextflow.extension.ChannelCredits
 import nextflow.util.CheckHelper
 /**
  * Generic data splitter, provide main methods/interfaces
@@ -399,8 +400,11 @@ abstract class AbstractSplitter<T> implements SplitterStrategy {
             result = closure.call(result)
         }
 
-        if( into != null )
+        if( into != null ) {
+            // block when the target channel is bounded and its consumers are saturated
+            ChannelCredits.acquire(into, result)
             append(into,result)
+        }
 
         return result
     }
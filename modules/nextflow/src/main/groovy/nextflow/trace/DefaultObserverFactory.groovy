@@ -3,6 +3,8 @@ package nextflow.trace
 import java.nio.file.Path
 
 import nextflow.Session
+import nextflow.k8s.K8sConfig
+import nextflow.k8s.K8sIntermediateDataCleaner
 
 /**
  * Creates Nextflow observes object
@@ -25,9 +27,18 @@ class DefaultObserverFactory implements TraceObserverFactory {
         createTimelineObserver(result)
         createDagObserver(result)
         createAnsiLogObserver(result)
+        createResourcePredictionObserver(result)
+        createIntermediateDataCleaner(result)
         return result
     }
 
+    protected void createIntermediateDataCleaner(Collection<TraceObserver> result) {
+        final storage = new K8sConfig( (Map<String,Object>)config.k8s ).getStorage()
+        if( !storage?.deleteIntermediateData() )
+            return
+        result << new K8sIntermediateDataCleaner(storage.getDeleteBatchSize(), storage.deleteResumableData())
+    }
+
     protected void createAnsiLogObserver(Collection<TraceObserver> result) {
         if( session.ansiLog ) {
             session.ansiLogObserver = new AnsiLogObserver()
@@ -79,6 +90,21 @@ class DefaultObserverFactory implements TraceObserverFactory {
         def traceFile = (fileName as Path).complete()
         def observer = new GraphObserver(traceFile)
         config.navigate('dag.overwrite')  { observer.overwrite = it }
+        config.navigate('dag.aggregate')  { observer.aggregate = it }
+        result << observer
+    }
+
+    protected void createResourcePredictionObserver(Collection<TraceObserver> result) {
+        final predictor = session.getResourcePredictor()
+        Boolean isEnabled = config.navigate('resourcePredictor.report.enabled') as Boolean
+        if( predictor == null || !isEnabled )
+            return
+
+        String fileName = config.navigate('resourcePredictor.report.file')
+        if( !fileName ) fileName = ResourcePredictionObserver.DEF_FILE_NAME
+        def reportFile = (fileName as Path).complete()
+        def observer = new ResourcePredictionObserver(predictor, reportFile)
+        config.navigate('resourcePredictor.report.overwrite') { observer.overwrite = it }
         result << observer
     }
 
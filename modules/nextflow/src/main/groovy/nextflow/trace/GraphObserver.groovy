@@ -23,6 +23,7 @@ import groovy.util.logging.Slf4j
 import nextflow.Session
 import nextflow.dag.CytoscapeHtmlRenderer
 import nextflow.dag.DAG
+import nextflow.dag.DagAggregator
 import nextflow.dag.DagRenderer
 import nextflow.dag.DotRenderer
 import nextflow.dag.GexfRenderer
@@ -53,6 +54,11 @@ class GraphObserver implements TraceObserver {
 
     boolean overwrite
 
+    /**
+     * When {@code true} operator chains and fan-out groups are collapsed into summary nodes
+     */
+    boolean aggregate
+
     String getFormat() { format }
 
     String getName() { name }
@@ -82,7 +88,10 @@ class GraphObserver implements TraceObserver {
         // -- normalise the DAG
         dag.normalize()
         // -- render it to a file
-        createRender().renderDocument(dag,file)
+        final start = System.currentTimeMillis()
+        final target = aggregate ? new DagAggregator(dag).apply() : dag
+        createRender().renderDocument(target,file)
+        log.debug "DAG rendering completed in ${System.currentTimeMillis()-start} ms -- vertices: ${target.vertices.size()}; edges: ${target.edges.size()}"
     }
 
     @PackageScope
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.trace
+
+import java.nio.file.Files
+import java.nio.file.Path
+
+import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
+import groovy.util.logging.Slf4j
+import nextflow.processor.TaskHandler
+import nextflow.util.MemoryUnit
+/**
+ * Creates a report comparing the resources predicted by the {@link ResourcePredictor}
+ * with the ones actually used by the tasks
+ */
+@Slf4j
+@CompileStatic
+class ResourcePredictionObserver implements TraceObserver {
+
+    public static final String DEF_FILE_NAME = "resource-predictions-${TraceHelper.launchTimestampFmt()}.tsv"
+
+    static final List<String> HEADER = ['process', 'tasks', 'failed', 'pred_cpus', 'used_cpus', 'pred_memory', 'peak_rss', 'max_peak_rss', 'under_predicted']
+
+    /**
+     * Predictions and actual usage summary for a process
+     */
+    @PackageScope
+    static class Summary {
+        int tasks
+        int failed
+        int underPredicted
+        double predictedCpus
+        double usedCpus
+        int cpuTasks
+        double predictedMemory
+        double peakRss
+        long maxPeakRss
+        int memoryTasks
+    }
+
+    final private ResourcePredictor predictor
+
+    final private Path reportFile
+
+    final private Map<String,Summary> summaries = new TreeMap<>()
+
+    boolean overwrite
+
+    ResourcePredictionObserver(ResourcePredictor predictor, Path file) {
+        this.predictor = predictor
+        this.predictor.tracking = true
+        this.reportFile = file
+    }
+
+    @Override
+    void onProcessComplete(TaskHandler handler, TraceRecord trace) {
+        final prediction = predictor.remove(handler.task.id)
+        if( prediction == null || trace == null )
+            return
+        synchronized (summaries) {
+            add(prediction, trace)
+        }
+    }
+
+    @Override
+    void onProcessCached(TaskHandler handler, TraceRecord trace) {
+        // the prediction is applied before the cache is checked
+        predictor.remove(handler.task.id)
+    }
+
+    @PackageScope void add(ResourcePredictor.Prediction prediction, TraceRecord trace) {
+        final summary = summaries.computeIfAbsent(prediction.process, { k -> new Summary() })
+        summary.tasks++
+        if( trace.get('status') != 'COMPLETED' )
+            summary.failed++
+        final cpu = trace.get('%cpu') as Double
+        if( prediction.cpus && cpu != null ) {
+            summary.predictedCpus += prediction.cpus
+            summary.usedCpus += cpu / 100
+            summary.cpuTasks++
+        }
+        final peakRss = trace.get('peak_rss') as Long
+        if( prediction.memory && peakRss ) {
+            summary.predictedMemory += prediction.memory.toBytes()
+            summary.peakRss += peakRss
+            summary.maxPeakRss = Math.max(summary.maxPeakRss, peakRss)
+            summary.memoryTasks++
+            if( peakRss > prediction.memory.toBytes() )
+                summary.underPredicted++
+        }
+    }
+
+    @Override
+    void onFlowComplete() {
+        try {
+            render()
+        }
+        catch( Exception e ) {
+            log.warn "Failed to render resource predictions report -- see the log file for details", e
+        }
+    }
+
+    @PackageScope String renderText() {
+        final result = new StringBuilder()
+        result << HEADER.join('\t') << '\n'
+        for( Map.Entry<String,Summary> entry : summaries ) {
+            final it = entry.value
+            final row = new ArrayList<String>(HEADER.size())
+            row << entry.key
+            row << String.valueOf(it.tasks)
+            row << String.valueOf(it.failed)
+            row << (it.cpuTasks ? String.format('%.2f', it.predictedCpus / it.cpuTasks) : '-')
+            row << (it.cpuTasks ? String.format('%.2f', it.usedCpus / it.cpuTasks) : '-')
+            row << (it.memoryTasks ? MemoryUnit.of(Math.round(it.predictedMemory / it.memoryTasks)).toString() : '-')
+            row << (it.memoryTasks ? MemoryUnit.of(Math.round(it.peakRss / it.memoryTasks)).toString() : '-')
+            row << (it.memoryTasks ? MemoryUnit.of(it.maxPeakRss).toString() : '-')
+            row << String.valueOf(it.underPredicted)
+            result << row.join('\t') << '\n'
+        }
+        return result.toString()
+    }
+
+    protected void render() {
+        final parent = reportFile.getParent()
+        if( parent )
+            Files.createDirectories(parent)
+        final writer = TraceHelper.newFileWriter(reportFile, overwrite, 'Resource predictions')
+        try {
+            writer.write(renderText())
+        }
+        finally {
+            writer.close()
+        }
+    }
+}
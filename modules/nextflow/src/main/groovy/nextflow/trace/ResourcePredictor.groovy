@@ -0,0 +1,352 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.trace
+
+import java.nio.file.Files
+import java.nio.file.Path
+import java.util.concurrent.ConcurrentHashMap
+
+import com.google.common.cache.Cache
+import com.google.common.cache.CacheBuilder
+import com.google.common.hash.HashCode
+import groovy.transform.CompileStatic
+import groovy.transform.EqualsAndHashCode
+import groovy.transform.PackageScope
+import groovy.transform.ToString
+import groovy.util.logging.Slf4j
+import nextflow.cache.CacheDB
+import nextflow.cache.CacheFactory
+import nextflow.file.FileHolder
+import nextflow.processor.TaskId
+import nextflow.processor.TaskRun
+import nextflow.util.HistoryFile
+import nextflow.util.MemoryUnit
+/**
+ * Predicts the cpus and memory required by a task from the trace records
+ * of the tasks executed by previous runs of the same pipeline.
+ *
+ * For each process the memory is modelled as a linear function of the task input size,
+ * fitted with least squares and shifted so that the requested quantile of the historical
+ * peak RSS is covered. When the input size is not known or does not vary, the model
+ * falls back to the quantile of the peak RSS. The cpus are predicted as the quantile
+ * of the historical cpu usage. A safety margin is added to both predictions.
+ */
+@Slf4j
+@CompileStatic
+class ResourcePredictor {
+
+    static final public double DEF_QUANTILE = 0.95
+
+    static final public double DEF_MARGIN = 0.1
+
+    static final public int DEF_MIN_SAMPLES = 10
+
+    static final public int DEF_HISTORY = 5
+
+    static final private long MB = 1024 * 1024
+
+    /**
+     * Resources usage of a past task
+     */
+    @ToString
+    @EqualsAndHashCode
+    static class Sample {
+        Long inputBytes
+        long peakRss
+        Double cpus
+    }
+
+    /**
+     * The resource model of a process
+     */
+    @ToString(includeNames = true)
+    static class Model {
+        int samples
+        double intercept
+        double slope
+        Double cpus
+
+        long memoryBytes(Long inputBytes) {
+            final x = inputBytes != null ? inputBytes : 0L
+            return Math.round(intercept + slope * x)
+        }
+    }
+
+    /**
+     * The resources predicted for a task
+     */
+    @ToString(includeNames = true)
+    @EqualsAndHashCode
+    static class Prediction {
+        String process
+        Integer cpus
+        MemoryUnit memory
+    }
+
+    final private double quantile
+
+    final private double margin
+
+    final private int minSamples
+
+    final private boolean predictCpus
+
+    final private boolean predictMemory
+
+    final private Integer maxCpus
+
+    final private MemoryUnit maxMemory
+
+    final private Map<String,List<Sample>> samples = new HashMap<>()
+
+    final private Map<String,Model> models = new HashMap<>()
+
+    final private Map<TaskId,Prediction> predictions = new ConcurrentHashMap<>()
+
+    /**
+     * The size of the input files, so that a file read by many tasks is checked only once
+     */
+    final private Cache<Path,Long> fileSizes = CacheBuilder.newBuilder().maximumSize(100_000).build()
+
+    /**
+     * When {@code true} the predictions applied are kept until retrieved by {@link #remove(TaskId)}
+     */
+    boolean tracking
+
+    ResourcePredictor(Map opts) {
+        this.quantile = opts.quantile != null ? opts.quantile as double : DEF_QUANTILE
+        this.margin = opts.margin != null ? opts.margin as double : DEF_MARGIN
+        this.minSamples = opts.minSamples != null ? opts.minSamples as int : DEF_MIN_SAMPLES
+        this.predictCpus = opts.cpus != null ? opts.cpus as boolean : true
+        this.predictMemory = opts.memory != null ? opts.memory as boolean : true
+        this.maxCpus = opts.maxCpus as Integer
+        this.maxMemory = opts.maxMemory != null ? MemoryUnit.of(opts.maxMemory.toString()) : null
+        if( quantile <= 0 || quantile > 1 )
+            throw new IllegalArgumentException("Invalid resourcePredictor.quantile value: $quantile -- it must be a number between 0 and 1")
+        if( margin < 0 )
+            throw new IllegalArgumentException("Invalid resourcePredictor.margin value: $margin -- it cannot be a negative number")
+    }
+
+    /**
+     * Create the predictor loading the trace records of the previous runs
+     *
+     * @param config The {@code resourcePredictor} config scope
+     * @param history The executions history file
+     * @param revisionId The pipeline revision id, only the runs of the same revision are used
+     * @param runName The current run name, which is excluded from the history
+     * @return The {@link ResourcePredictor} instance or {@code null} when it's not enabled
+     */
+    static ResourcePredictor create(Map config, HistoryFile history, String revisionId, String runName) {
+        if( !config?.enabled )
+            return null
+        final result = new ResourcePredictor(config)
+        final count = config.history != null ? config.history as int : DEF_HISTORY
+        if( history?.exists() ) {
+            final runs = history.findAll()
+                    .findAll { HistoryFile.Record it -> it.runName != runName && (!revisionId || it.revisionId == revisionId) }
+            result.load(runs.takeRight(count))
+        }
+        return result.fit()
+    }
+
+    protected void load(List<HistoryFile.Record> runs) {
+        final visited = new HashSet<HashCode>()
+        for( HistoryFile.Record run : runs ) {
+            CacheDB db = null
+            try {
+                db = CacheFactory.create(run.sessionId, run.runName).openForRead()
+                db.eachRecord { HashCode hash, TraceRecord trace ->
+                    if( visited.add(hash) )
+                        add(trace)
+                }
+            }
+            catch( Exception e ) {
+                log.debug "Unable to load resource usage of run: ${run.runName} -- cause: ${e.message ?: e}"
+            }
+            finally {
+                db?.close()
+            }
+        }
+    }
+
+    /**
+     * Add the resources usage of a past task
+     *
+     * @param trace The task {@link TraceRecord}
+     */
+    void add(TraceRecord trace) {
+        if( trace.isCached() || trace.get('status') != 'COMPLETED' )
+            return
+        final process = trace.get('process') as String
+        final peakRss = trace.get('peak_rss') as Long
+        if( !process || !peakRss )
+            return
+        final cpu = trace.get('%cpu') as Double
+        final sample = new Sample(inputBytes: trace.get('input_bytes') as Long, peakRss: peakRss, cpus: cpu != null ? cpu/100 : null)
+        samples.computeIfAbsent(process, { k -> new ArrayList<Sample>() }).add(sample)
+    }
+
+    /**
+     * Fit the model of each process having at least {@code minSamples} samples
+     */
+    ResourcePredictor fit() {
+        for( Map.Entry<String,List<Sample>> entry : samples.entrySet() ) {
+            if( entry.value.size() < minSamples )
+                continue
+            final model = fitModel(entry.value)
+            log.debug "Resource model for process '${entry.key}': $model"
+            models.put(entry.key, model)
+        }
+        samples.clear()
+        return this
+    }
+
+    @PackageScope Model fitModel(List<Sample> samples) {
+        final result = new Model(samples: samples.size())
+        final known = samples.findAll { Sample it -> it.inputBytes != null }
+        if( known.size() >= minSamples ) {
+            // least squares slope of the peak RSS over the input size
+            double meanX = 0
+            double meanY = 0
+            for( Sample it : known ) {
+                meanX += it.inputBytes / known.size()
+                meanY += it.peakRss / known.size()
+            }
+            double cov = 0
+            double var = 0
+            for( Sample it : known ) {
+                cov += (it.inputBytes - meanX) * (it.peakRss - meanY)
+                var += (it.inputBytes - meanX) * (it.inputBytes - meanX)
+            }
+            // memory is not expected to decrease with the input size
+            result.slope = var > 0 ? Math.max(0d, cov / var) : 0d
+            // shift the line to cover the requested quantile of the residuals
+            result.intercept = quantileOf(known.collect { Sample it -> (it.peakRss - result.slope * it.inputBytes) as double })
+        }
+        else {
+            result.intercept = quantileOf(samples.collect { Sample it -> it.peakRss as double })
+        }
+
+        final cpus = samples.findAll { Sample it -> it.cpus != null }.collect { Sample it -> it.cpus }
+        if( cpus )
+            result.cpus = quantileOf(cpus)
+        return result
+    }
+
+    @PackageScope double quantileOf(List<Double> values) {
+        final sorted = new ArrayList<Double>(values)
+        Collections.sort(sorted)
+        final index = (int)Math.ceil(quantile * sorted.size()) - 1
+        return sorted.get(Math.max(0, Math.min(index, sorted.size()-1)))
+    }
+
+    Model getModel(String process) {
+        models.get(process)
+    }
+
+    /**
+     * Predict the resources for a task
+     *
+     * @param process The process name
+     * @param inputBytes The size of the task input files or {@code null} if unknown
+     * @return The {@link Prediction} object or {@code null} if there isn't a model for the process
+     */
+    Prediction predict(String process, Long inputBytes) {
+        final model = models.get(process)
+        if( model == null )
+            return null
+        final result = new Prediction(process: process)
+        if( predictMemory ) {
+            final bytes = model.memoryBytes(inputBytes) * (1+margin)
+            // round up to the next megabyte
+            long value = Math.max(1L, (long)Math.ceil(bytes / MB)) * MB
+            if( maxMemory && value > maxMemory.toBytes() )
+                value = maxMemory.toBytes()
+            result.memory = MemoryUnit.of(value)
+        }
+        if( predictCpus && model.cpus != null ) {
+            int value = Math.max(1, (int)Math.ceil(model.cpus * (1+margin)))
+            if( maxCpus && value > maxCpus )
+                value = maxCpus
+            result.cpus = value
+        }
+        return result
+    }
+
+    /**
+     * Set the predicted resources to the task config. For retried tasks the resources
+     * requested by the process definition are used when they are greater than the predicted ones
+     *
+     * @param task The {@link TaskRun} to be submitted
+     */
+    void apply(TaskRun task) {
+        // the input size is recorded in the trace of all tasks to be used by next runs,
+        // retried tasks keep the one computed for the first attempt
+        if( task.inputBytes == null )
+            task.inputBytes = inputBytes(task)
+        final process = task.processor.name
+        if( !models.containsKey(process) )
+            return
+        final prediction = predict(process, task.inputBytes)
+        final retry = (task.config.getAttempt() ?: 1) > 1
+        if( prediction.memory ) {
+            final declared = task.config.getMemory()
+            if( !retry || declared == null || declared < prediction.memory )
+                task.config.put('memory', prediction.memory)
+        }
+        if( prediction.cpus ) {
+            final declared = task.config.getCpus()
+            if( !retry || declared < prediction.cpus )
+                task.config.put('cpus', prediction.cpus)
+        }
+        log.trace "[${task.name}] predicted resources: $prediction"
+        if( tracking )
+            predictions.put(task.id, prediction)
+    }
+
+    /**
+     * @return The prediction applied to the task with the given id, removing it
+     */
+    Prediction remove(TaskId taskId) {
+        predictions.remove(taskId)
+    }
+
+    protected Long inputBytes(TaskRun task) {
+        long result = 0
+        for( List<FileHolder> holders : task.getInputFiles().values() ) {
+            for( FileHolder it : holders )
+                result += sizeOf(it.storePath)
+        }
+        return result
+    }
+
+    @PackageScope long sizeOf(Path path) {
+        final cached = fileSizes.getIfPresent(path)
+        if( cached != null )
+            return cached
+        long result = 0
+        try {
+            result = Files.size(path)
+        }
+        catch( IOException e ) {
+            log.trace "Unable to get size of input file: $path -- cause: ${e.message ?: e}"
+        }
+        fileSizes.put(path, result)
+        return result
+    }
+
+}
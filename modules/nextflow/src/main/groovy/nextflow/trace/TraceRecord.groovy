@@ -136,6 +136,12 @@ class TraceRecord implements Serializable {
             scheduler_delta_submitted_batch_end:   'num',
             scheduler_time_delta_phase_three:      'str',
             scheduler_copy_tasks:                  'num',
+            pod_deletion_backlog:                  'num',
+            infiles_time:                          'num',
+            infiles_strategy:                      'str',
+            outfiles_time:                         'num',
+            outfiles_strategy:                     'str',
+            input_bytes:                           'mem',
     ]
 
     static public Map<String,Closure<String>> FORMATTER = [
@@ -484,6 +490,8 @@ class TraceRecord implements Serializable {
                     break
 
                 case 'cpu_model':
+                case 'infiles_strategy':
+                case 'outfiles_strategy':
                     this.put(name, value)
                     break
 
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.util
+
+import com.esotericsoftware.kryo.Kryo
+import com.esotericsoftware.kryo.KryoException
+import com.esotericsoftware.kryo.io.Input
+import com.esotericsoftware.kryo.io.Output
+import groovy.transform.CompileStatic
+/**
+ * Compact serialization for path strings used by the Kryo path serializers.
+ *
+ * The parent directory of each path is stored once in a prefix table and any further
+ * path in the same directory only stores the prefix index and the file name. The table
+ * lives in the Kryo graph context, therefore its scope is a single top-level serialized
+ * object e.g. a cache record, and it's discarded when Kryo is reset.
+ *
+ * The compact format starts with a {@code null} string, so that serializers can tell it apart
+ * from their legacy format, which always starts with a non-null string.
+ */
+@CompileStatic
+class PathDictionary {
+
+    /**
+     * Write a path string using the compact format
+     *
+     * @param kryo The current {@link Kryo} instance
+     * @param output The {@link Output} stream
+     * @param path The path string to write
+     */
+    static void write(Kryo kryo, Output output, String path) {
+        final p = path.lastIndexOf('/')
+        final prefix = path.substring(0, p+1)
+        // the table is bound to the output stream, to handle nested serializations with the same kryo instance
+        def table = (Map<String,Integer>)kryo.getGraphContext().get(output)
+        if( table == null ) {
+            table = new HashMap<String,Integer>()
+            kryo.getGraphContext().put(output, table)
+        }
+
+        output.writeString(null)
+        final index = table.get(prefix)
+        if( index != null ) {
+            output.writeVarInt(index+1, true)
+        }
+        else {
+            output.writeVarInt(0, true)
+            output.writeString(prefix)
+            table.put(prefix, table.size())
+        }
+        output.writeString(path.substring(p+1))
+    }
+
+    /**
+     * Read a path string written by {@link #write}. It must be invoked once the leading
+     * {@code null} string has been read by the serializer.
+     *
+     * @param kryo The current {@link Kryo} instance
+     * @param input The {@link Input} stream
+     * @return The path string
+     */
+    static String read(Kryo kryo, Input input) {
+        def table = (List<String>)kryo.getGraphContext().get(input)
+        if( table == null ) {
+            table = new ArrayList<String>()
+            kryo.getGraphContext().put(input, table)
+        }
+
+        final ref = input.readVarInt(true)
+        String prefix
+        if( ref == 0 ) {
+            prefix = input.readString()
+            table.add(prefix)
+        }
+        else if( ref <= table.size() ) {
+            prefix = table.get(ref-1)
+        }
+        else
+            throw new KryoException("Invalid path prefix reference: $ref")
+        return prefix + input.readString()
+    }
+
+}
@@ -29,10 +29,13 @@ import com.esotericsoftware.kryo.io.Input
 import com.esotericsoftware.kryo.io.Output
 import de.javakaffee.kryoserializers.UnmodifiableCollectionsSerializer
 import groovy.transform.CompileStatic
+import groovy.transform.PackageScope
 import groovy.util.logging.Slf4j
 import nextflow.file.FileHelper
 import nextflow.io.SerializableMarker
 import nextflow.plugin.Plugins
+import nextflow.processor.TaskId
+import nextflow.trace.TraceRecord
 import org.codehaus.groovy.runtime.GStringImpl
 import org.objenesis.instantiator.ObjectInstantiator
 import org.pf4j.Extension
@@ -46,6 +49,49 @@ class KryoHelper {
 
     static final ThreadLocal<Kryo> threadLocal
 
+    /**
+     * Classes commonly stored in the cache DB and in the spill files, registered with a stable ID
+     * so that the class name is not written along with each serialized object.
+     *
+     * NOTE: the IDs are persisted in the cache DB, therefore they must never be changed or
+     * reused, new classes can only be appended. Data serialized by a previous version,
+     * which includes the class name, can still be read.
+     */
+    static final Map<Class,Integer> COMMON_CLASSES = [
+            (ArrayList): 100,
+            (LinkedList): 101,
+            (HashMap): 102,
+            (LinkedHashMap): 103,
+            (TreeMap): 104,
+            (HashSet): 105,
+            (LinkedHashSet): 106,
+            (TreeSet): 107,
+            ((new byte[0]).getClass()): 108,
+            ((new Object[0]).getClass()): 109,
+            ((new String[0]).getClass()): 110,
+            (BigDecimal): 111,
+            (BigInteger): 112,
+            (Date): 113,
+            (GStringImpl): 114,
+            (ArrayBag): 115,
+            (TraceRecord): 116,
+            (TaskId): 117,
+            (Duration): 118,
+            (MemoryUnit): 119,
+            (BlankSeparatedList): 120,
+    ]
+
+    /**
+     * Pooled buffers larger than this size are released after use
+     */
+    static final private int MAX_POOLED_BUFFER = 1024 * 1024
+
+    static final private ThreadLocal<Output> pooledOutput = new ThreadLocal<>()
+
+    static final private ThreadLocal<Input> pooledInput = new ThreadLocal<>()
+
+    static final private byte[] EMPTY = new byte[0]
+
     static {
         serializers = [:]
 
@@ -81,9 +127,11 @@ class KryoHelper {
 
 
     /**
+     * @param registerCommon When {@code false} the {@link #COMMON_CLASSES} are not registered, mostly for testing purposes
      * @return A new instance {@code Kryo} instance
      */
-    static private Kryo newInstance() {
+    @PackageScope
+    static Kryo newInstance(boolean registerCommon=true) {
         def kryo = new Kryo()
         kryo.setInstantiatorStrategy( InstantiationStrategy.instance )
 
@@ -113,6 +161,22 @@ class KryoHelper {
         // map entry serializer
         kryo.addDefaultSerializer(Map.Entry, MapEntrySerializer)
 
+        // common classes, registered after the default serializers so that they are
+        // serialized in the same way as when unregistered
+        if( registerCommon ) {
+            for( Map.Entry<Class,Integer> entry : COMMON_CLASSES ) {
+                final clazz = entry.key
+                final id = entry.value
+                if( kryo.getClassResolver().getRegistration(clazz) != null )
+                    continue
+                if( kryo.getRegistration(id) != null ) {
+                    log.warn "Kryo registration id $id is already used by class ${kryo.getRegistration(id).type.name} -- cannot be used for class ${clazz.name}"
+                    continue
+                }
+                kryo.register(clazz, id)
+            }
+        }
+
         return kryo
     }
 
@@ -161,11 +225,25 @@ class KryoHelper {
     }
 
     static byte[] serialize( object ) {
-        ByteArrayOutputStream buffer = new ByteArrayOutputStream(4*1024)
-        def output = new Output(buffer)
-        kryo().writeClassAndObject(output, object)
-        output.flush()
-        return buffer.toByteArray()
+        // take the buffer out of the pool, so that a nested invocation
+        // eventually made by a custom serializer gets a new one
+        Output output = pooledOutput.get()
+        if( output != null ) {
+            pooledOutput.set(null)
+            output.clear()
+        }
+        else {
+            output = new Output(4*1024, -1)
+        }
+
+        try {
+            kryo().writeClassAndObject(output, object)
+            return output.toBytes()
+        }
+        finally {
+            if( output.getBuffer().length <= MAX_POOLED_BUFFER )
+                pooledOutput.set(output)
+        }
     }
 
     static <T> T deserialize( byte[] binary, ClassLoader loader = null ) {
@@ -176,13 +254,22 @@ class KryoHelper {
             kryo.setClassLoader(loader)
         }
 
+        Input input = pooledInput.get()
+        if( input != null )
+            pooledInput.set(null)
+        else
+            input = new Input()
+
         try {
-            def buffer = new ByteArrayInputStream(binary)
-            return (T)kryo.readClassAndObject(new Input(buffer))
+            input.setBuffer(binary)
+            return (T)kryo.readClassAndObject(input)
         }
         finally {
+            // release the reference to the binary data
+            input.setBuffer(EMPTY)
+            pooledInput.set(input)
             if( prev ) {
-                kryo.setClassLoader(loader)
+                kryo.setClassLoader(prev)
             }
         }
     }
@@ -265,14 +352,23 @@ class PathSerializer extends Serializer<Path> {
         final path = target.toString()
         log.trace "Path serialization > scheme: $scheme; path: $path"
 
-        output.writeString(scheme)
-        output.writeString(path)
+        PathDictionary.write(kryo, output, "$scheme://$path".toString())
     }
 
     @Override
     Path read(Kryo kryo, Input input, Class<Path> type) {
-        final scheme = input.readString()
-        final path = input.readString()
+        String scheme = input.readString()
+        String path
+        if( scheme == null ) {
+            // compact format, see PathDictionary
+            final uri = PathDictionary.read(kryo, input)
+            final p = uri.indexOf('://')
+            scheme = uri.substring(0, p)
+            path = uri.substring(p+3)
+        }
+        else {
+            path = input.readString()
+        }
         log.trace "Path de-serialization > scheme: $scheme; path: $path"
 
         if( "file".equalsIgnoreCase(scheme) ) {
@@ -17,6 +17,9 @@
 
 package nextflow.util
 
+import java.nio.charset.StandardCharsets
+import java.util.zip.GZIPOutputStream
+
 import groovy.json.JsonSlurper
 import groovy.transform.CompileStatic
 import groovy.util.logging.Slf4j
@@ -38,6 +41,11 @@ class SimpleHttpClient {
     public static int DEFAULT_BACK_OFF_BASE = 3
     public static int DEFAULT_BACK_OFF_DELAY = 250
 
+    /**
+     * Request bodies smaller than this are never compressed
+     */
+    public static int COMPRESSION_MIN_SIZE = 1024
+
     /**
      * Default user agent
      */
@@ -76,6 +84,12 @@ class SimpleHttpClient {
 
     private int backOffDelay = DEFAULT_BACK_OFF_DELAY
 
+    private boolean compression
+
+    private int connectTimeout
+
+    private int readTimeout
+
     private CookieManager cookieManager
 
     SimpleHttpClient() {
@@ -132,10 +146,22 @@ class SimpleHttpClient {
             else if( basicToken )
                 con.setRequestProperty("Authorization","Basic ${basicToken.bytes.encodeBase64()}")
 
+            // set timeouts
+            if( connectTimeout )
+                con.setConnectTimeout(connectTimeout)
+            if( readTimeout )
+                con.setReadTimeout(readTimeout)
+
             con.setDoOutput(true)
 
             // Send POST request
-            if( body ) {
+            if( body && compression && body.length() >= COMPRESSION_MIN_SIZE ) {
+                con.setRequestProperty("Content-Encoding", "gzip")
+                final output = new GZIPOutputStream(con.getOutputStream())
+                output.write(body.getBytes(StandardCharsets.UTF_8))
+                output.close()
+            }
+            else if( body ) {
                 DataOutputStream output = new DataOutputStream(con.getOutputStream())
                 output.writeBytes(body)
                 output.flush()
@@ -254,4 +280,32 @@ class SimpleHttpClient {
         return this
     }
 
+    /**
+     * Enable the gzip compression of request bodies
+     *
+     * @param value When {@code true} request bodies larger than {@link #COMPRESSION_MIN_SIZE} are sent gzip compressed
+     */
+    SimpleHttpClient setCompression(boolean value) {
+        this.compression = value
+        return this
+    }
+
+    boolean getCompression() { compression }
+
+    /**
+     * @param millis The connection timeout in milliseconds, zero means no timeout
+     */
+    SimpleHttpClient setConnectTimeout(int millis) {
+        this.connectTimeout = millis
+        return this
+    }
+
+    /**
+     * @param millis The read timeout in milliseconds, zero means no timeout
+     */
+    SimpleHttpClient setReadTimeout(int millis) {
+        this.readTimeout = millis
+        return this
+    }
+
 }
@@ -757,6 +757,33 @@ class ChannelTest extends Specification {
         pairs.val == Channel.STOP
     }
 
+    def 'should group files with a pending limit' () {
+
+        setup:
+        def folder = tempDir.root.toAbsolutePath()
+        def a1 = Files.createFile(folder.resolve('alpha_1.fa'))
+        def a2 = Files.createFile(folder.resolve('alpha_2.fa'))
+        def b1 = Files.createFile(folder.resolve('beta_1.fa'))
+        def b2 = Files.createFile(folder.resolve('beta_2.fa'))
+        def d1 = Files.createFile(folder.resolve('delta_1.fa'))
+        def d2 = Files.createFile(folder.resolve('delta_2.fa'))
+        Files.createFile(folder.resolve('gamma_1.fa'))
+
+        when:
+        def pairs = Channel.fromFilePairs(folder.resolve("*_{1,2}.fa"), maxPending: 1)
+        def result = [pairs.val, pairs.val, pairs.val].sort { it[0] }
+        then:
+        result == [['alpha', [a1, a2]], ['beta', [b1, b2]], ['delta', [d1, d2]]]
+        pairs.val == Channel.STOP
+
+        when:
+        pairs = Channel.fromFilePairs(folder.resolve("*_{1,2}.fa"), maxPending: 1, flat: true)
+        result = [pairs.val, pairs.val, pairs.val].sort { it[0] }
+        then:
+        result == [['alpha', a1, a2], ['beta', b1, b2], ['delta', d1, d2]]
+        pairs.val == Channel.STOP
+    }
+
     def 'should group files with the same prefix and root path' () {
 
         setup:
@@ -174,4 +174,40 @@ class CacheDBTest extends Specification {
 
     }
 
+    def 'should remove task entries in batch' () {
+
+        setup:
+        def folder = Files.createTempDirectory('test')
+        def uuid = UUID.randomUUID()
+        def hash1 = CacheHelper.hasher('a').hash()
+        def hash2 = CacheHelper.hasher('b').hash()
+        def hash3 = CacheHelper.hasher('c').hash()
+        def store = new DefaultCacheStore(uuid, 'test_1', folder)
+        def cache = new CacheDB(store).open()
+        and:
+        def h1 = makeTaskHandler(hash1, [task_id: 1, process: 'foo', exit: 0])
+        cache.writeTaskEntry0(h1, h1.traceRecord)
+        def h2 = makeTaskHandler(hash2, [task_id: 2, process: 'bar', exit: 0])
+        cache.writeTaskEntry0(h2, h2.traceRecord)
+        // the second entry is referenced by two runs
+        cache.incTaskEntry(hash2)
+
+        when:
+        def result = cache.removeTaskEntries([hash1, hash2, hash3])
+        then:
+        result == [hash1] as Set
+        store.getEntry(hash1) == null
+        store.getEntry(hash2) != null
+
+        when:
+        result = cache.removeTaskEntries([hash2])
+        then:
+        result == [hash2] as Set
+        store.getEntry(hash2) == null
+
+        cleanup:
+        cache?.close()
+        folder?.deleteDir()
+    }
+
 }
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.cache
+
+import java.nio.file.Files
+import java.nio.file.Path
+
+import com.google.common.hash.HashCode
+import nextflow.trace.TraceRecord
+import nextflow.util.CacheHelper
+import nextflow.util.HistoryFile
+import nextflow.util.KryoHelper
+import spock.lang.Specification
+import spock.lang.Timeout
+
+@Timeout(10)
+class ResumePrefetcherTest extends Specification {
+
+    private void putTask(CacheStore store, HashCode hash, Path workDir) {
+        final trace = new TraceRecord([task_id: 1, process: 'foo', workdir: workDir.toString()])
+        store.putEntry(hash, KryoHelper.serialize([trace.serialize(), null, 1]))
+    }
+
+    def 'should iterate the index of a previous run' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def uuid = UUID.randomUUID()
+        def hash1 = CacheHelper.hasher('a').hash()
+        def hash2 = CacheHelper.hasher('b').hash()
+        and:
+        def store = new DefaultCacheStore(uuid, 'run_1', folder).open()
+        store.writeIndex(hash1, false)
+        store.writeIndex(hash2, true)
+        store.close()
+
+        when:
+        store = new DefaultCacheStore(uuid, 'run_2', folder).open()
+        def items = []
+        def found = store.eachIndex('run_1') { CacheStore.Index it -> items << [it.key, it.cached] }
+        then:
+        found
+        items == [[hash1, false], [hash2, true]]
+        and:
+        !store.eachIndex('run_0') { }
+
+        cleanup:
+        store?.close()
+        folder?.deleteDir()
+    }
+
+    def 'should find the previous run of the session' () {
+        given:
+        def file = Files.createTempFile('test', '.history')
+        def history = new HistoryFile(file)
+        def uuid = UUID.randomUUID()
+        history.write('run_1', uuid, 'abc', 'nextflow run')
+        history.write('other_1', UUID.randomUUID(), 'abc', 'nextflow run')
+        history.write('run_2', uuid, 'abc', 'nextflow run -resume')
+        history.write('run_3', uuid, 'abc', 'nextflow run -resume')
+
+        expect:
+        ResumePrefetcher.findPreviousRun(history, uuid, 'run_3') == 'run_2'
+        ResumePrefetcher.findPreviousRun(history, uuid, 'run_4') == 'run_3'
+        ResumePrefetcher.findPreviousRun(history, UUID.randomUUID(), 'run_3') == null
+        ResumePrefetcher.findPreviousRun(null, uuid, 'run_3') == null
+
+        cleanup:
+        file?.delete()
+    }
+
+    def 'should prefetch the cache entries of the previous run' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def uuid = UUID.randomUUID()
+        def hash1 = CacheHelper.hasher('a').hash()
+        def hash2 = CacheHelper.hasher('b').hash()
+        def hash3 = CacheHelper.hasher('c').hash()
+        and:
+        def work1 = folder.resolve('work/aa'); work1.mkdirs()
+        work1.resolve('.exitcode').text = '0\n'
+        def work2 = folder.resolve('work/bb')
+        and:
+        def store = new DefaultCacheStore(uuid, 'run_1', folder).open()
+        putTask(store, hash1, work1)
+        putTask(store, hash2, work2)
+        store.writeIndex(hash1, false)
+        store.writeIndex(hash2, false)
+        // the third entry is missing in the db
+        store.writeIndex(hash3, false)
+        store.close()
+        and:
+        def cache = new CacheDB(new DefaultCacheStore(uuid, 'run_2', folder)).open()
+        def prefetcher = new ResumePrefetcher(cache, 'run_1', 2, 10).start()
+
+        when:
+        while( prefetcher.loadedCount < 2 )
+            sleep 50
+        def entry1 = prefetcher.take(hash1)
+        def entry2 = prefetcher.take(hash2)
+        then:
+        entry1.workDir == work1
+        entry1.exists
+        entry1.exitText == '0'
+        entry1.trace.get('process') == 'foo'
+        entry1.toTaskEntry(null).context == null
+        and:
+        entry2.workDir == work2
+        !entry2.exists
+        entry2.exitText == null
+
+        when:
+        // entries can be taken only once
+        def again = prefetcher.take(hash1)
+        def missing = prefetcher.take(hash3)
+        then:
+        again == null
+        missing == null
+        prefetcher.hitCount == 2
+        prefetcher.missCount == 2
+
+        cleanup:
+        prefetcher?.close()
+        cache?.close()
+        folder?.deleteDir()
+    }
+
+    def 'should evict the entries never requested' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def uuid = UUID.randomUUID()
+        def hashes = ['a','b','c','d'].collect { CacheHelper.hasher(it).hash() }
+        and:
+        def store = new DefaultCacheStore(uuid, 'run_1', folder).open()
+        hashes.eachWithIndex { HashCode hash, int i ->
+            putTask(store, hash, folder.resolve("work/$i"))
+            store.writeIndex(hash, false)
+        }
+        store.close()
+        and:
+        def cache = new CacheDB(new DefaultCacheStore(uuid, 'run_2', folder)).open()
+        def prefetcher = new ResumePrefetcher(cache, 'run_1', 2, 2)
+        prefetcher.evictDelayMillis = 100
+        prefetcher.start()
+
+        when:
+        // the first entries are never requested, still the last ones are loaded
+        while( prefetcher.loadedCount < 4 )
+            sleep 50
+        then:
+        prefetcher.evictedCount == 2
+        prefetcher.take(hashes[0]) == null
+        prefetcher.take(hashes[1]) == null
+        prefetcher.take(hashes[2]) != null
+        prefetcher.take(hashes[3]) != null
+
+        cleanup:
+        prefetcher?.close()
+        cache?.close()
+        folder?.deleteDir()
+    }
+
+    def 'should report exit file read errors' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def uuid = UUID.randomUUID()
+        def hash = CacheHelper.hasher('a').hash()
+        def work = folder.resolve('work/aa'); work.mkdirs()
+        and:
+        def store = new DefaultCacheStore(uuid, 'run_1', folder).open()
+        putTask(store, hash, work)
+        def prefetcher = new ResumePrefetcher(new CacheDB(store), 'run_0')
+
+        when:
+        def entry = prefetcher.load(hash)
+        then:
+        entry.exists
+
+        when:
+        entry.getExitText()
+        then:
+        thrown(IOException)
+
+        when:
+        entry = prefetcher.load(CacheHelper.hasher('z').hash())
+        then:
+        entry == null
+
+        cleanup:
+        store?.close()
+        folder?.deleteDir()
+    }
+
+    def 'should validate options' () {
+        when:
+        new ResumePrefetcher(Mock(CacheDB), 'foo', THREADS, SIZE)
+        then:
+        thrown(IllegalArgumentException)
+
+        where:
+        THREADS | SIZE
+        0       | 1
+        1       | 0
+    }
+
+}
@@ -18,6 +18,7 @@ package nextflow.cli
 
 import spock.lang.Specification
 import java.nio.file.Files
+import java.nio.file.LinkOption
 
 /**
  *
@@ -91,8 +92,58 @@ class CmdCleanTest extends Specification {
             folder?.deleteDir()
     }
 
+    def 'should delete nested folders without following links' () {
 
+        given:
+        def target = Files.createTempDirectory('target')
+        def keep = Files.createFile(target.resolve('keep.txt'))
+        and:
+        def folder = Files.createTempDirectory('test')
+        Files.createDirectories(folder.resolve('a/b/c'))
+        Files.createFile(folder.resolve('a/b/c/file.txt'))
+        Files.createFile(folder.resolve('.command.sh'))
+        Files.createSymbolicLink(folder.resolve('a/link'), target)
+        def cleaner = new CmdClean()
+
+        when:
+        def result = cleaner.deleteFolder(folder,false)
+        then:
+        result
+        !folder.exists()
+        and:
+        keep.exists()
+
+        when:
+        result = cleaner.deleteFolder(folder,false)
+        then:
+        result
+
+        cleanup:
+        target?.deleteDir()
+        folder?.deleteDir()
+    }
+
+    def 'should only delete the link of a linked folder' () {
 
+        given:
+        def target = Files.createTempDirectory('target')
+        def keep = Files.createFile(target.resolve('keep.txt'))
+        and:
+        def base = Files.createTempDirectory('test')
+        def folder = Files.createSymbolicLink(base.resolve('ab'), target)
+        def cleaner = new CmdClean()
 
+        when:
+        def result = cleaner.deleteFolder(folder,false)
+        then:
+        result
+        !Files.exists(folder, LinkOption.NOFOLLOW_LINKS)
+        and:
+        keep.exists()
+
+        cleanup:
+        target?.deleteDir()
+        base?.deleteDir()
+    }
 
 }
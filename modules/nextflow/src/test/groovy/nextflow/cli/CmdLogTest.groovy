@@ -17,8 +17,10 @@
 package nextflow.cli
 import java.nio.file.Files
 
+import groovy.json.JsonSlurper
 import nextflow.cache.CacheDB
 import nextflow.cache.DefaultCacheStore
+import nextflow.exception.AbortOperationException
 import nextflow.executor.CachedTaskHandler
 import nextflow.plugin.Plugins
 import nextflow.script.ProcessConfig
@@ -186,4 +188,94 @@ class CmdLogTest extends Specification {
 
     }
 
+    def 'should print tasks as json lines' () {
+
+        setup:
+        final folder = Files.createTempDirectory('test')
+        folder.resolve('.nextflow').mkdir()
+        final uuid = UUID.randomUUID()
+        final runName = 'test_1'
+
+        def store = new DefaultCacheStore(uuid, runName, folder)
+        def cache = new CacheDB(store)
+
+        def proc = Mock(TaskProcessor)
+        proc.getTaskBody() >> new BodyDef(null,'source')
+        proc.getConfig() >> new ProcessConfig([:])
+
+        cache.open()
+        for( int i=1; i<=500; i++ ) {
+            final index = i
+            def task = Mock(TaskRun)
+            task.getProcessor() >> proc
+            task.getHash() >> { CacheHelper.hasher("x$index").hash() }
+            def handler = new CachedTaskHandler(task, new TraceRecord([name: "foo ($index)".toString(), process: 'foo', exit: index % 2, '%cpu': 99.5, workdir:"$folder/$index".toString()]))
+            cache.writeTaskIndex0(handler)
+            cache.writeTaskEntry0(handler, handler.getTraceRecord())
+        }
+        cache.close()
+
+        def history = new HistoryFile(folder.resolve(HistoryFile.FILE_NAME))
+        history.write(runName,uuid,'b3d3aca8eb','run')
+
+        when:
+        def log = new CmdLog(basePath: folder, fields: 'name,exit,pcpu,workdir', filterStr: 'exit == 0', json: true, args: [runName])
+        log.run()
+        def lines = capture
+                .toString()
+                .readLines()
+                .findAll { line -> line.startsWith('{') }
+                .collect { line -> new JsonSlurper().parseText(line) }
+        then:
+        lines.size() == 250
+        lines[0] == [name: 'foo (2)', exit: 0, pcpu: 99.5, workdir: "$folder/2".toString()]
+        // records are printed in the cache index order
+        lines.collect { it.name } == (1..250).collect { "foo (${it*2})".toString() }
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+    def 'should match the fields ignoring the case' () {
+        given:
+        def log = new CmdLog()
+        log.@projection = ['NAME', 'Status', 'PCPU']
+        def record = new TraceRecord([name: 'foo (1)', status: 'COMPLETED', '%cpu': 99.5, workdir: '/work/ab'])
+
+        when:
+        def projected = log.project(record)
+        then:
+        projected.store == [name: 'foo (1)', status: 'COMPLETED', '%cpu': 99.5, workdir: '/work/ab']
+
+        when:
+        def json = new JsonSlurper().parseText(log.renderJson(new CmdLog.TraceAdaptor(projected)))
+        then:
+        json == [NAME: 'foo (1)', Status: 'COMPLETED', PCPU: 99.5]
+    }
+
+    def 'should print the same task only once' () {
+        given:
+        def output = new StringWriter()
+        def log = new CmdLog()
+        log.@writer = new PrintWriter(output)
+        def hash1 = CacheHelper.hasher('x1').hash()
+        def hash2 = CacheHelper.hasher('x2').hash()
+
+        when:
+        log.printLine(hash1, 'foo (1)')
+        log.printLine(hash2, 'foo (2)')
+        // the same task reported by another run
+        log.printLine(hash1, 'foo (1)')
+        log.@writer.flush()
+        then:
+        output.toString().readLines() == ['foo (1)', 'foo (2)']
+    }
+
+    def 'should not allow json and template options' () {
+        when:
+        new CmdLog(templateStr: 'x', json: true, args: ['foo']).init()
+        then:
+        thrown(AbortOperationException)
+    }
+
 }
@@ -59,6 +59,20 @@ class DAGTest extends Specification {
     }
 
 
+    def 'should resolve vertex names' () {
+        given:
+        def dag = new DAG()
+        def v1 = dag.createVertex(DAG.Type.PROCESS, 'Label A')
+        def v2 = dag.createVertex(DAG.Type.OPERATOR, 'Label B')
+
+        when:
+        def names = dag.vertexNames()
+        then:
+        names.size() == 2
+        names[v1] == v1.name
+        names[v2] == v2.name
+    }
+
     def 'should add new vertices' () {
 
         given:
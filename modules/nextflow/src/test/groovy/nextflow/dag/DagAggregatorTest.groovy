@@ -0,0 +1,109 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.dag
+
+import groovyx.gpars.dataflow.DataflowQueue
+import nextflow.Session
+import spock.lang.Specification
+
+class DagAggregatorTest extends Specification {
+
+    def setupSpec() {
+        new Session()
+    }
+
+    def 'should collapse operator chains and fan-out groups' () {
+        given:
+        def ch1 = new DataflowQueue()
+        def ch2 = new DataflowQueue()
+        def ch3 = new DataflowQueue()
+        def ch4 = new DataflowQueue()
+        def ch5 = new DataflowQueue()
+        def outs = (1..3).collect { new DataflowQueue() }
+        and:
+        def dag = new DAG()
+        dag.addOperatorNode('Op1', ch1, ch2)
+        dag.addOperatorNode('Op2', ch2, ch3)
+        dag.addOperatorNode('Op3', ch3, ch4)
+        dag.addOperatorNode('Op4', ch4, outs + [ch5])
+        outs.each { dag.addOperatorNode('view', it, null) }
+        dag.addOperatorNode('collect', ch5, null)
+        dag.normalize()
+
+        when:
+        def result = new DagAggregator(dag).apply()
+        then:
+        result.vertices.collect { [it.type, it.label] } == [
+                [DAG.Type.ORIGIN, null],
+                [DAG.Type.OPERATOR, '4 operators: Op1 .. Op4'],
+                [DAG.Type.OPERATOR, 'view x3'],
+                [DAG.Type.OPERATOR, 'collect'] ]
+        and:
+        result.edges.collect { [it.from.label, it.to.label] } == [
+                [null, '4 operators: Op1 .. Op4'],
+                ['4 operators: Op1 .. Op4', 'view x3'],
+                ['4 operators: Op1 .. Op4', 'collect'] ]
+        and:
+        new MermaidRenderer().renderNetwork(result) == '''\
+            flowchart TD
+                p0(( ))
+                p1([4 operators: Op1 .. Op4])
+                p2([view x3])
+                p3([collect])
+                p0 --> p1
+                p1 --> p2
+                p1 --> p3
+            '''.stripIndent()
+    }
+
+    def 'should not collapse operators with multiple inputs' () {
+        given:
+        def ch1 = new DataflowQueue()
+        def ch2 = new DataflowQueue()
+        def ch3 = new DataflowQueue()
+        def ch4 = new DataflowQueue()
+        and:
+        def dag = new DAG()
+        dag.addOperatorNode('Op1', ch1, ch2)
+        dag.addOperatorNode('mix', [ch2, ch3], ch4)
+        dag.normalize()
+
+        when:
+        def result = new DagAggregator(dag).apply()
+        then:
+        result.vertices.collect { it.label } == [null, 'Op1', null, 'mix', null]
+        result.edges.size() == 4
+    }
+
+    def 'should create the chain label' () {
+        given:
+        def dag = new DAG()
+        def chain = LABELS.collect { dag.createVertex(DAG.Type.OPERATOR, it) }
+
+        expect:
+        DagAggregator.chainLabel(chain) == EXPECTED
+
+        where:
+        LABELS                      | EXPECTED
+        ['map']                     | 'map'
+        [null]                      | null
+        ['map', 'filter']           | 'map, filter'
+        ['map', null, 'view']       | 'map, view'
+        ['a', 'b', 'c', 'd', 'e']   | '5 operators: a .. e'
+    }
+
+}
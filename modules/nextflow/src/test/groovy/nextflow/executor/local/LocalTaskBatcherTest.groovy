@@ -0,0 +1,164 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.executor.local
+
+import java.nio.file.Files
+import java.nio.file.Path
+import java.util.concurrent.Executors
+
+import nextflow.Session
+import nextflow.processor.TaskConfig
+import nextflow.processor.TaskRun
+import nextflow.util.Duration
+import spock.lang.Specification
+import spock.lang.Timeout
+
+@Timeout(10)
+class LocalTaskBatcherTest extends Specification {
+
+    private LocalTaskHandler createHandler(Path workDir, String script) {
+        Files.createDirectories(workDir)
+        workDir.resolve(TaskRun.CMD_RUN).text = script
+        def task = Mock(TaskRun) {
+            getWorkDir() >> workDir
+            getConfig() >> Mock(TaskConfig)
+        }
+        return new LocalTaskHandler(task, Mock(LocalExecutor))
+    }
+
+    def 'should create the batcher from the config' () {
+        given:
+        def session = Mock(Session)
+        def executor = Mock(LocalExecutor) {
+            getSession() >> session
+            getName() >> 'local'
+        }
+
+        when:
+        def batcher = LocalTaskBatcher.create(executor)
+        then:
+        session.getExecConfigProp('local', 'batchSize', 1) >> 1
+        batcher == null
+
+        when:
+        batcher = LocalTaskBatcher.create(executor)
+        then:
+        session.getExecConfigProp('local', 'batchSize', 1) >> 50
+        session.getExecConfigProp('local', 'batchTimeout', _) >> '1 sec'
+        session.getExecConfigProp('local', 'batchMode', 'parallel') >> 'sequential'
+        and:
+        batcher.batchSize == 50
+        !batcher.parallel
+
+        when:
+        LocalTaskBatcher.create(executor)
+        then:
+        session.getExecConfigProp('local', 'batchSize', 1) >> 50
+        session.getExecConfigProp('local', 'batchMode', 'parallel') >> 'foo'
+        thrown(IllegalArgumentException)
+    }
+
+    def 'should run a batch of tasks in a single worker' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def h1 = createHandler(folder.resolve('a b'), 'echo hello; exit 0')
+        def h2 = createHandler(folder.resolve('c'), 'echo world; exit 3')
+        def batcher = new LocalTaskBatcher(Mock(LocalExecutor), Executors.newCachedThreadPool(), 2, Duration.of('1s'), PARALLEL)
+
+        when:
+        batcher.runWorker([h1, h2])
+        then:
+        h1.@batchPid > 0
+        h1.@result.exitStatus == 0
+        h1.@result.logs.text == 'hello\n'
+        and:
+        h2.@batchPid > 0
+        h2.@result.exitStatus == 3
+        h2.@result.logs.text == 'world\n'
+
+        cleanup:
+        folder?.deleteDir()
+
+        where:
+        PARALLEL << [true, false]
+    }
+
+    def 'should not pass the batch mode to the tasks environment' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def h1 = createHandler(folder.resolve('a'), 'env | grep -c "^nxf_parallel=\\|^NXF_BATCH" || exit 0')
+        def batcher = new LocalTaskBatcher(Mock(LocalExecutor), Executors.newCachedThreadPool(), 1, Duration.of('1s'), true)
+
+        when:
+        batcher.runWorker([h1])
+        then:
+        h1.@result.exitStatus == 0
+        h1.@result.logs.text == '0\n'
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+    def 'should fail the tasks not reported by the worker' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def h1 = createHandler(folder.resolve('a'), 'exit 1')
+        def h2 = createHandler(folder.resolve('b'), 'exit 2')
+        def batcher = new LocalTaskBatcher(Mock(LocalExecutor), Executors.newCachedThreadPool(), 2, Duration.of('1s'), true)
+
+        when:
+        batcher.handleEvent([h1, h2], 'S 0 100')
+        batcher.handleEvent([h1, h2], 'E 0 1')
+        batcher.handleEvent([h1, h2], 'something else')
+        then:
+        h1.@batchPid == 100
+        h1.@result.exitStatus == 1
+        h2.@result == null
+
+        when:
+        h1.batchFailed(new Exception('lost'))
+        h2.batchFailed(new Exception('lost'))
+        then:
+        h1.@result.exitStatus == 1
+        h2.@result.error.message == 'lost'
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+    def 'should flush a partial batch after the timeout' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def h1 = createHandler(folder.resolve('a'), 'exit 0')
+        def h2 = createHandler(folder.resolve('b'), 'exit 0')
+        def batcher = new LocalTaskBatcher(Mock(LocalExecutor), Executors.newCachedThreadPool(), 10, Duration.of('100ms'), true)
+
+        when:
+        batcher.submit(h1)
+        batcher.submit(h2)
+        while( h1.@result == null || h2.@result == null )
+            sleep 50
+        then:
+        h1.@result.exitStatus == 0
+        h2.@result.exitStatus == 0
+
+        cleanup:
+        batcher?.shutdown()
+        folder?.deleteDir()
+    }
+
+}
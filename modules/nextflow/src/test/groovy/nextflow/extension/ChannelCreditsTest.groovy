@@ -0,0 +1,154 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.extension
+
+import groovyx.gpars.dataflow.DataflowQueue
+import nextflow.Channel
+import spock.lang.Specification
+import spock.lang.Timeout
+
+@Timeout(10)
+class ChannelCreditsTest extends Specification {
+
+    def setup() {
+        ChannelCredits.reset()
+    }
+
+    def 'should register and alias a channel' () {
+        given:
+        def ch = new DataflowQueue()
+        def reader = new DataflowQueue()
+
+        expect:
+        ChannelCredits.of(ch) == null
+        ChannelCredits.of(null) == null
+
+        when:
+        def credits = ChannelCredits.register(ch, 5, 'foo')
+        then:
+        credits.name == 'foo'
+        credits.capacity == 5
+        ChannelCredits.of(ch).is(credits)
+        ChannelCredits.of(reader) == null
+
+        when:
+        credits.alias(reader)
+        then:
+        ChannelCredits.of(reader).is(credits)
+
+        when:
+        ChannelCredits.reset()
+        then:
+        ChannelCredits.of(ch) == null
+        ChannelCredits.dumpDepths() == null
+    }
+
+    def 'should reject an invalid capacity' () {
+        when:
+        ChannelCredits.register(new DataflowQueue(), 0)
+        then:
+        thrown(IllegalArgumentException)
+    }
+
+    def 'should not block when there are no consumers' () {
+        given:
+        def credits = ChannelCredits.register(new DataflowQueue(), 1)
+
+        when:
+        10.times { credits.acquire() }
+        then:
+        noExceptionThrown()
+    }
+
+    def 'should block the producer until the consumer releases a credit' () {
+        given:
+        def ch = new DataflowQueue()
+        def credits = ChannelCredits.register(ch, 2, 'splitText')
+        def consumer = new Object()
+        credits.addConsumer(consumer, 'foo')
+
+        when:
+        credits.acquire()
+        ChannelCredits.acquire(ch, 'x')
+        ChannelCredits.acquire(ch, Channel.STOP)
+        then:
+        credits.depth(consumer) == 2
+        ChannelCredits.dumpDepths() == '  splitText (capacity=2; emitted=2); foo=2'
+
+        when:
+        def producer = Thread.start { credits.acquire() }
+        producer.join(200)
+        then:
+        producer.isAlive()
+
+        when:
+        credits.release(consumer)
+        producer.join()
+        then:
+        credits.depth(consumer) == 2
+    }
+
+    def 'should track each consumer separately' () {
+        given:
+        def credits = ChannelCredits.register(new DataflowQueue(), 1)
+        def fast = new Object()
+        def slow = new Object()
+        credits.addConsumer(fast, 'fast')
+        credits.addConsumer(slow, 'slow')
+
+        when:
+        credits.acquire()
+        credits.release(fast)
+        credits.release(fast)
+        then:
+        credits.depth(fast) == 0
+        credits.depth(slow) == 1
+
+        when:
+        def producer = Thread.start { credits.acquire() }
+        producer.join(200)
+        then:
+        producer.isAlive()
+
+        when:
+        credits.removeConsumer(slow)
+        producer.join()
+        then:
+        credits.depth(fast) == 1
+        credits.depth(slow) == 0
+    }
+
+    def 'should release the producer on close' () {
+        given:
+        def credits = ChannelCredits.register(new DataflowQueue(), 1)
+        credits.addConsumer(new Object(), 'foo')
+        credits.acquire()
+
+        when:
+        def producer = Thread.start { credits.acquire() }
+        producer.join(200)
+        then:
+        producer.isAlive()
+
+        when:
+        ChannelCredits.closeAll()
+        producer.join()
+        then:
+        !producer.isAlive()
+    }
+
+}
@@ -403,4 +403,57 @@ class CombineOpTest extends Specification {
         [2, 'b', 'q'] in all
     }
 
+    def 'should combine channels in parallel' () {
+
+        given:
+        def left = Channel.of(*(1..100))
+        def right = Channel.of('a','b','c')
+        def op = new CombineOp(left, right).setParallel(4)
+
+        when:
+        def result = op.apply()
+        def all = (List) ToListOp.apply(result).val
+        then:
+        all.size() == 300
+        all as Set == [(1..100), ['a','b','c']].combinations() as Set
+    }
+
+    def 'should combine by key in parallel' () {
+
+        given:
+        def left = Channel.of(['A', 1], ['B', 2], ['A', 3])
+        def right = Channel.of(['B', 'x'], ['B', 'y'], ['A', 'z'], ['A', 'w'])
+        def op = new CombineOp(left, right).setPivot(0).setParallel(3)
+
+        when:
+        def result = op.apply()
+        def all = (List) ToListOp.apply(result).val
+        then:
+        all.size() == 6
+        all as Set == [['A', 1, 'z'], ['A', 3, 'z'], ['A', 1, 'w'], ['A', 3, 'w'], ['B', 2, 'x'], ['B', 2, 'y']] as Set
+        // items of the same key are emitted in the sequential order
+        all.findAll { it[0]=='B' } == [['B', 2, 'x'], ['B', 2, 'y']]
+    }
+
+    def 'should apply backpressure to the combined items' () {
+
+        given:
+        def left = Channel.of(*(1..50))
+        def right = Channel.of(*(1..50))
+        def op = new CombineOp(left, right).setParallel(2).setBuffer(10)
+
+        when:
+        def result = (DataflowQueue) op.apply()
+        sleep 500
+        then:
+        result.length() == 10
+
+        when:
+        def count = 0
+        while( result.getVal() != Channel.STOP )
+            count++
+        then:
+        count == 2500
+    }
+
 }
@@ -16,7 +16,12 @@
 
 package nextflow.extension
 
+import java.util.concurrent.CompletableFuture
+
+import groovyx.gpars.dataflow.DataflowQueue
+import nextflow.Channel
 import nextflow.Session
+import nextflow.SysEnv
 import spock.lang.Specification
 import spock.lang.Unroll
 
@@ -54,6 +59,37 @@ class DataflowHelperTest extends Specification {
         thrown(IllegalArgumentException)
     }
 
+    def 'should run operators on virtual threads' () {
+        given:
+        SysEnv.push(NXF_ENABLE_VIRTUAL_OPERATORS: 'true')
+        def source = new DataflowQueue()
+        def result = new CompletableFuture<Thread>()
+
+        when:
+        DataflowHelper.subscribeImpl(source, [onNext: { result.complete(Thread.currentThread()) }])
+        source << 1 << Channel.STOP
+        then:
+        result.get().isVirtual()
+        result.get().name.startsWith('nf-operator-')
+        DataflowHelper.operatorGroup().is(DataflowHelper.operatorGroup())
+
+        cleanup:
+        SysEnv.pop()
+    }
+
+    def 'should run operators on the default pool' () {
+        given:
+        def source = new DataflowQueue()
+        def result = new CompletableFuture<Thread>()
+
+        when:
+        DataflowHelper.subscribeImpl(source, [onNext: { result.complete(Thread.currentThread()) }])
+        source << 1 << Channel.STOP
+        then:
+        !result.get().isVirtual()
+        DataflowHelper.operatorGroup() == null
+    }
+
     @Unroll
     def 'should split entry' () {
         when:
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.extension
+
+import java.nio.file.Paths
+
+import groovyx.gpars.dataflow.DataflowQueue
+import nextflow.Channel
+import nextflow.Session
+import spock.lang.Specification
+
+class FilePairsOpTest extends Specification {
+
+    def setup() {
+        new Session()
+    }
+
+    private List drain(DataflowQueue target) {
+        def result = []
+        def it
+        while( (it=target.getVal()) != Channel.STOP )
+            result << it
+        return result
+    }
+
+    def 'should emit complete groups as soon as they are found' () {
+        given:
+        def target = new DataflowQueue()
+        def op = new FilePairsOp(new DataflowQueue(), 2, 10).setTarget(target)
+
+        when:
+        op.collect(['a', Paths.get('/data/a_2.fq')])
+        op.collect(['b', Paths.get('/data/b_1.fq')])
+        then:
+        target.length() == 0
+        op.pending == 2
+
+        when:
+        op.collect(['a', Paths.get('/data/a_1.fq')])
+        then:
+        target.length() == 1
+        target.val == ['a', [Paths.get('/data/a_1.fq'), Paths.get('/data/a_2.fq')]]
+        op.pending == 1
+
+        when:
+        op.finalise(null)
+        then:
+        // incomplete groups are discarded
+        drain(target) == []
+        op.spilled == 0
+    }
+
+    def 'should spill unmatched files when exceeding the pending limit' () {
+        given:
+        def target = new DataflowQueue()
+        def op = new FilePairsOp(new DataflowQueue(), 2, 2).setTarget(target)
+
+        when:
+        op.collect(['a', Paths.get('/data/a_1.fq')])
+        op.collect(['b', Paths.get('/data/b_1.fq')])
+        op.collect(['c', Paths.get('/data/c_1.fq')])
+        then:
+        op.pending == 0
+        op.spilled == 3
+
+        when:
+        op.collect(['a', Paths.get('/data/a_2.fq')])
+        op.collect(['d', Paths.get('/data/d_1.fq')])
+        op.collect(['d', Paths.get('/data/d_2.fq')])
+        op.collect(['c', Paths.get('/data/c_2.fq')])
+        then:
+        // 'd' has not been spilled and it's emitted immediately
+        target.length() == 1
+        target.val == ['d', [Paths.get('/data/d_1.fq'), Paths.get('/data/d_2.fq')]]
+        op.spilled == 5
+
+        when:
+        op.finalise(null)
+        def result = drain(target)
+        then:
+        result.sort { it[0] } == [
+                ['a', [Paths.get('/data/a_1.fq'), Paths.get('/data/a_2.fq')]],
+                ['c', [Paths.get('/data/c_1.fq'), Paths.get('/data/c_2.fq')]] ]
+    }
+
+    def 'should emit groups of any size' () {
+        given:
+        def target = new DataflowQueue()
+        def op = new FilePairsOp(new DataflowQueue(), -1, 1).setTarget(target)
+
+        when:
+        op.collect(['x', Paths.get('/data/x_3.fq')])
+        op.collect(['x', Paths.get('/data/x_1.fq')])
+        op.collect(['y', Paths.get('/data/y_1.fq')])
+        op.collect(['x', Paths.get('/data/x_2.fq')])
+        op.finalise(null)
+        then:
+        drain(target).sort { it[0] } == [
+                ['x', [Paths.get('/data/x_1.fq'), Paths.get('/data/x_2.fq'), Paths.get('/data/x_3.fq')]],
+                ['y', [Paths.get('/data/y_1.fq')]] ]
+    }
+
+    def 'should validate the pending limit' () {
+        when:
+        new FilePairsOp(new DataflowQueue(), 2, 0)
+        then:
+        thrown(IllegalArgumentException)
+    }
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.extension
+
+import groovyx.gpars.dataflow.DataflowQueue
+import nextflow.Channel
+import nextflow.Session
+import nextflow.SysEnv
+import spock.lang.Requires
+import spock.lang.Specification
+import spock.lang.Unroll
+/**
+ * Measure the throughput of I/O bound operators running on the default
+ * thread pool and on virtual threads.
+ *
+ * Run it with: NXF_BENCHMARK=true ./gradlew :nextflow:test --tests '*OperatorThreadsBenchmarkTest'
+ */
+@Requires({ System.getenv('NXF_BENCHMARK') })
+class OperatorThreadsBenchmarkTest extends Specification {
+
+    static final int ITEMS = 200
+
+    static final int OPERATORS = 64
+
+    def setupSpec() {
+        new Session()
+    }
+
+    @Unroll
+    def 'should benchmark blocking operators [virtual=#VIRTUAL]' () {
+        given:
+        SysEnv.push(NXF_ENABLE_VIRTUAL_OPERATORS: String.valueOf(VIRTUAL))
+        def targets = (1..OPERATORS).collect { new DataflowQueue() }
+        def sources = (1..OPERATORS).collect { new DataflowQueue() }
+
+        when:
+        def start = System.currentTimeMillis()
+        for( int i=0; i<OPERATORS; i++ ) {
+            // simulate a remote read blocking the operator thread
+            new MapOp(sources[i], { sleep 5; it }).setTarget(targets[i]).apply()
+        }
+        for( int i=0; i<OPERATORS; i++ ) {
+            for( int j=0; j<ITEMS; j++ )
+                sources[i] << j
+            sources[i] << Channel.STOP
+        }
+        int count = 0
+        for( DataflowQueue target : targets ) {
+            while( target.val != Channel.STOP )
+                count++
+        }
+        def elapsed = System.currentTimeMillis() - start
+        then:
+        println "Blocking operators -- virtual=$VIRTUAL; operators=$OPERATORS; items=${count}; elapsed=${elapsed} ms; items/sec=${count * 1000 / elapsed}"
+        count == OPERATORS * ITEMS
+
+        cleanup:
+        SysEnv.pop()
+
+        where:
+        VIRTUAL << [false, true]
+    }
+
+}
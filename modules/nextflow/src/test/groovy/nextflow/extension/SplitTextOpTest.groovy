@@ -1,6 +1,8 @@
 package nextflow.extension
 
+import groovyx.gpars.dataflow.DataflowQueue
 import spock.lang.Specification
+import spock.lang.Timeout
 
 import nextflow.Channel
 
@@ -44,5 +46,71 @@ class SplitTextOpTest extends Specification {
         result.val == Channel.STOP
     }
 
+    def 'should bound the number of chunks emitted' () {
+        given:
+        ChannelCredits.reset()
+        def consumer = new Object()
+
+        def source = new DataflowQueue()
+
+        when:
+        def result = source.splitText(capacity: 2)
+        def credits = ChannelCredits.of(result)
+        credits.addConsumer(consumer, 'foo')
+        and:
+        source << 'a\nb\nc\nd'
+        source << Channel.STOP
+        then:
+        credits.capacity == 2
+        result.val == 'a\n'
+        result.val == 'b\n'
+
+        when:
+        sleep 200
+        then:
+        credits.depth(consumer) == 2
+        result.length() == 0
+
+        when:
+        credits.release(consumer)
+        credits.release(consumer)
+        then:
+        result.val == 'c\n'
+        result.val == 'd\n'
+        result.val == Channel.STOP
+    }
+
+    @Timeout(10)
+    def 'should not hold the dataflow pool threads while waiting for credits' () {
+        given:
+        ChannelCredits.reset()
+        def consumer = new Object()
+        // more blocked producers than the threads of the dataflow pool
+        def count = Runtime.runtime.availableProcessors() * 2 + 2
+        def sources = (1..count).collect { new DataflowQueue() }
+        def results = sources.collect { it.splitText(capacity: 1) }
+        results.each { ChannelCredits.of(it).addConsumer(consumer, 'foo') }
+
+        when:
+        sources.each { it << 'a\nb\nc'; it << Channel.STOP }
+        sleep 200
+        then:
+        results.every { it.length() == 1 }
+        and:
+        // other operators still make progress
+        Channel.of(1,2,3).map { it * 2 }.toList().val == [2,4,6]
+
+        when:
+        results.each { ChannelCredits.of(it).removeConsumer(consumer) }
+        then:
+        results.every { it.val == 'a\n' && it.val == 'b\n' && it.val == 'c\n' && it.val == Channel.STOP }
+    }
+
+    def 'should reject an invalid capacity' () {
+        when:
+        Channel.of('a\nb').splitText(capacity: 0)
+        then:
+        thrown(IllegalArgumentException)
+    }
 
 }
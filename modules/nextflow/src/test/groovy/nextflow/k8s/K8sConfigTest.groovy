@@ -159,6 +159,23 @@ class K8sConfigTest extends Specification {
         client.maxErrorRetry == 10
     }
 
+    def 'should set http pool options' () {
+        given:
+        def CONFIG = [httpPool: true, httpMaxConcurrency: [get: 100, POST: 10], namespace: 'this', client: [server: 'http://foo']]
+
+        when:
+        def client = new K8sConfig(CONFIG).getClient()
+        then:
+        client.httpPool
+        client.httpMaxConcurrency == [GET: 100, POST: 10]
+
+        when:
+        client = new K8sConfig([namespace: 'this', client: [server: 'http://foo']]).getClient()
+        then:
+        !client.httpPool
+        client.httpMaxConcurrency == null
+    }
+
     def 'should create client config with http request timeouts' () {
 
         given:
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s
+
+import java.nio.file.Files
+import java.nio.file.Path
+
+import nextflow.Session
+import nextflow.dag.DAG
+import nextflow.file.OutfilesListing
+import nextflow.processor.TaskConfig
+import nextflow.processor.TaskProcessor
+import nextflow.processor.TaskRun
+import spock.lang.Specification
+
+class K8sIntermediateDataCleanerTest extends Specification {
+
+    def setupSpec() {
+        new Session()
+    }
+
+    private DAG.Vertex process(DAG dag, String name) {
+        def proc = Mock(TaskProcessor) { getName() >> name }
+        dag.createVertex(DAG.Type.PROCESS, name, proc)
+    }
+
+    def 'should find the consumer processes' () {
+        given:
+        def dag = new DAG()
+        def a = process(dag, 'A')
+        def op1 = dag.createVertex(DAG.Type.OPERATOR, 'map')
+        def b = process(dag, 'B')
+        def c = process(dag, 'C')
+        def op2 = dag.createVertex(DAG.Type.OPERATOR, 'view')
+        def d = process(dag, 'D')
+        and:
+        dag.createEdge(a, op1)
+        dag.createEdge(op1, b)
+        dag.createEdge(op1, c)
+        // the outputs of B reach the view operator
+        dag.createEdge(b, op2)
+        // the outputs of C are the workflow outputs
+        dag.createEdge(c, null)
+        dag.createEdge(a, d)
+
+        expect:
+        K8sIntermediateDataCleaner.consumersGraph(dag) == [A: ['B','C','D'] as Set, B: null, C: null, D: null]
+    }
+
+    def 'should release the outputs when all consumers terminate' () {
+        given:
+        def cleaner = new K8sIntermediateDataCleaner(10)
+        def out1 = new K8sIntermediateDataCleaner.Output('foo (1)', Path.of('/work/ab/1'), [Path.of('/work/ab/1/x')], ['B','C'] as Set)
+        def out2 = new K8sIntermediateDataCleaner.Output('foo (2)', Path.of('/work/ab/2'), [Path.of('/work/ab/2/x')], ['B'] as Set)
+
+        when:
+        cleaner.register(out1)
+        cleaner.register(out2)
+        then:
+        cleaner.waitingCount == 2
+        cleaner.pendingCount == 0
+
+        when:
+        cleaner.release('B')
+        then:
+        cleaner.waitingCount == 1
+        cleaner.pendingCount == 1
+
+        when:
+        cleaner.release('C')
+        then:
+        cleaner.waitingCount == 0
+        cleaner.pendingCount == 2
+
+        when:
+        // consumers already terminated are not waited for
+        cleaner.register(new K8sIntermediateDataCleaner.Output('foo (3)', Path.of('/work/ab/3'), [Path.of('/work/ab/3/x')], ['C'] as Set))
+        then:
+        cleaner.waitingCount == 0
+        cleaner.pendingCount == 3
+    }
+
+    def 'should retain the outputs consumed by a failed process' () {
+        given:
+        def cleaner = new K8sIntermediateDataCleaner(10)
+        def out1 = new K8sIntermediateDataCleaner.Output('foo (1)', Path.of('/work/ab/1'), [Path.of('/work/ab/1/x')], ['B','C'] as Set)
+        def out2 = new K8sIntermediateDataCleaner.Output('foo (2)', Path.of('/work/ab/2'), [Path.of('/work/ab/2/x')], ['C'] as Set)
+        cleaner.register(out1)
+        cleaner.register(out2)
+
+        when:
+        cleaner.retain('B')
+        then:
+        cleaner.waitingCount == 1
+
+        when:
+        cleaner.register(new K8sIntermediateDataCleaner.Output('foo (3)', Path.of('/work/ab/3'), [Path.of('/work/ab/3/x')], ['B'] as Set))
+        cleaner.release('B')
+        cleaner.release('C')
+        then:
+        cleaner.waitingCount == 0
+        cleaner.pendingCount == 1
+    }
+
+    def 'should only delete the outputs of non resumable tasks unless enabled' () {
+        given:
+        def cleaner = new K8sIntermediateDataCleaner(10, RESUMABLE)
+        def processor = Mock(TaskProcessor) { isCacheable() >> CACHEABLE }
+        def task = new TaskRun(processor: processor, config: new TaskConfig(CONFIG))
+        task.exitStatus = EXIT
+        task.cached = CACHED
+
+        expect:
+        cleaner.isDeletable(task) == EXPECTED
+
+        where:
+        EXIT | CACHED | CACHEABLE | RESUMABLE | CONFIG                      | EXPECTED
+        0    | false  | false     | false     | [:]                         | true
+        1    | false  | false     | false     | [:]                         | false
+        0    | true   | false     | false     | [:]                         | false
+        0    | false  | true      | false     | [:]                         | false
+        0    | false  | true      | true      | [:]                         | true
+        0    | true   | true      | true      | [:]                         | false
+        0    | false  | true      | true      | [publishDir: '/some/path']  | false
+        0    | false  | false     | false     | [storeDir: '/some/path']    | false
+    }
+
+    def 'should delete the outputs in batch on the owning node' () {
+        given:
+        def workDir = Files.createTempDirectory('test').resolve('ab/cdef')
+        workDir.mkdirs()
+        workDir.resolve(OutfilesListing.NAME).text = '''\
+            /localwork/ab/cdef/;1;;4096;directory;16000000001;16000000002;16000000003
+            /localwork/ab/cdef/out.txt;1;;12;regular file;16000000001;16000000002;16000000003
+            /localwork/ab/cdef/res;1;;4096;directory;16000000001;16000000002;16000000003
+            /localwork/ab/cdef/res/sub;1;;4096;directory;16000000001;16000000002;16000000003
+            /localwork/ab/cdef/res/sub/data.csv;1;;100;regular file;16000000001;16000000002;16000000003
+            /localwork/ab/cdef/link.txt;1;/data/input.txt;50;regular file;16000000001;16000000002;16000000003
+            '''.stripIndent()
+        def files = ['out.txt', 'res', 'link.txt'].collect { workDir.resolve(it) }
+        and:
+        def cleaner = Spy(K8sIntermediateDataCleaner, constructorArgs: [10])
+
+        when:
+        cleaner.delete([new K8sIntermediateDataCleaner.Output('foo (1)', workDir, files, [] as Set)])
+        then:
+        1 * cleaner.nodeOf('/localwork/ab/cdef/out.txt') >> 'node-1'
+        1 * cleaner.nodeOf('/localwork/ab/cdef/res/sub/data.csv') >> 'node-1'
+        // outputs linking other files are not deleted
+        0 * cleaner.nodeOf('/localwork/ab/cdef/link.txt')
+        1 * cleaner.deleteOnNode('node-1', ['/localwork/ab/cdef/out.txt', '/localwork/ab/cdef/res/sub/data.csv'], ['/localwork/ab/cdef/res/sub', '/localwork/ab/cdef/res']) >> []
+        and:
+        cleaner.reclaimedBytes == 112
+        cleaner.deletedCount == 4
+        cleaner.failedCount == 0
+
+        cleanup:
+        workDir?.parent?.parent?.deleteDir()
+    }
+
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s
+
+import nextflow.k8s.client.K8sClient
+import nextflow.k8s.client.K8sResponseException
+import nextflow.k8s.client.K8sResponseJson
+import spock.lang.Specification
+import spock.lang.Timeout
+
+@Timeout(10)
+class K8sPodReaperTest extends Specification {
+
+    def 'should create config options' () {
+        when:
+        def config = new K8sConfig([:])
+        then:
+        !config.getAsyncCleanup()
+        config.getCleanupBatchSize() == 50
+        config.getCleanupRateLimit() == 20d
+        config.getCleanupQueueSize() == 10_000
+
+        when:
+        config = new K8sConfig([asyncCleanup: true, cleanupBatchSize: 10, cleanupRateLimit: 5, cleanupQueueSize: 100])
+        then:
+        config.getAsyncCleanup()
+        config.getCleanupBatchSize() == 10
+        config.getCleanupRateLimit() == 5d
+        config.getCleanupQueueSize() == 100
+    }
+
+    def 'should delete queued pods in background' () {
+        given:
+        def client = Mock(K8sClient)
+        def reaper = new K8sPodReaper(client, new K8sConfig([cleanupRateLimit: 1000]), 'foo').start()
+
+        when:
+        reaper.delete('pod-1')
+        reaper.delete('pod-2')
+        reaper.delete('pod-3')
+        reaper.shutdown()
+        then:
+        1 * client.podDelete('pod-1') >> new K8sResponseJson([:])
+        1 * client.podDelete('pod-2') >> new K8sResponseJson([:])
+        1 * client.podDelete('pod-3') >> { throw new K8sResponseException('Not found', new ByteArrayInputStream('{}'.bytes), 404) }
+        and:
+        reaper.pendingCount == 0
+        reaper.deletedCount == 2
+        reaper.failedCount == 0
+    }
+
+    def 'should delete jobs' () {
+        given:
+        def client = Mock(K8sClient)
+        def reaper = new K8sPodReaper(client, new K8sConfig([computeResourceType: 'Job', cleanupRateLimit: 1000]), 'foo').start()
+
+        when:
+        reaper.delete('job-1')
+        reaper.shutdown()
+        then:
+        1 * client.jobDelete('job-1') >> new K8sResponseJson([:])
+        0 * client.podDelete(_)
+    }
+
+    def 'should delete inline when the queue is full' () {
+        given:
+        def client = Mock(K8sClient)
+        // note: the reaper is not started, therefore queued pods are not consumed
+        def reaper = new K8sPodReaper(client, new K8sConfig([cleanupQueueSize: 2]), 'foo')
+
+        when:
+        reaper.delete('pod-1')
+        reaper.delete('pod-2')
+        then:
+        0 * client.podDelete(_)
+        reaper.pendingCount == 2
+
+        when:
+        reaper.delete('pod-3')
+        then:
+        1 * client.podDelete('pod-3') >> new K8sResponseJson([:])
+        reaper.pendingCount == 2
+        reaper.deletedCount == 1
+    }
+
+    def 'should delete the backlog with a collection request on shutdown' () {
+        given:
+        def client = Mock(K8sClient)
+        def reaper = new K8sPodReaper(client, new K8sConfig([cleanupBatchSize: 2]), 'my-run')
+
+        when:
+        reaper.delete('pod-1')
+        reaper.delete('pod-2')
+        reaper.delete('pod-3')
+        reaper.shutdown()
+        then:
+        1 * client.podDeleteCollection('nextflow.io/runName=my-run', 'status.phase=Succeeded') >> new K8sResponseJson([:])
+        0 * client.podDelete(_)
+        reaper.pendingCount == 0
+        reaper.deletedCount == 3
+    }
+
+    def 'should delete the backlog one by one when the collection request fails' () {
+        given:
+        def client = Mock(K8sClient)
+        def reaper = new K8sPodReaper(client, new K8sConfig([cleanupBatchSize: 2, cleanupRateLimit: 1000]), 'my-run')
+
+        when:
+        reaper.delete('pod-1')
+        reaper.delete('pod-2')
+        reaper.delete('pod-3')
+        reaper.shutdown()
+        then:
+        1 * client.podDeleteCollection('nextflow.io/runName=my-run', 'status.phase=Succeeded') >> { throw new IOException('Connection reset') }
+        1 * client.podDelete('pod-1') >> new K8sResponseJson([:])
+        1 * client.podDelete('pod-2') >> new K8sResponseJson([:])
+        1 * client.podDelete('pod-3') >> new K8sResponseJson([:])
+        reaper.pendingCount == 0
+        reaper.deletedCount == 3
+    }
+
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s
+
+import nextflow.k8s.client.K8sClient
+import nextflow.util.Duration
+import spock.lang.Specification
+
+class K8sReplicationPlannerTest extends Specification {
+
+    private static K8sReplicationPlanner.Copy copy(String source, String target) {
+        new K8sReplicationPlanner.Copy(source, target)
+    }
+
+    def 'should queue the files reaching the fan-out threshold' () {
+        given:
+        def planner = new K8sReplicationPlanner(Mock(K8sClient), 'name=mount-foo', '/localWork', 3, 2)
+
+        when:
+        planner.register(['/localWork/ab/ref.fa', '/localWork/cd/sample1.fq'])
+        planner.register(['/localWork/ab/ref.fa', '/localWork/cd/sample2.fq'])
+        then:
+        planner.fanOutOf('/localWork/ab/ref.fa') == 2
+        planner.pendingCount == 0
+
+        when:
+        // the same file given twice to a task is counted once
+        planner.register(['/localWork/ab/ref.fa', '/localWork/ab/ref.fa'])
+        planner.register(['/localWork/ab/ref.fa'])
+        then:
+        planner.fanOutOf('/localWork/ab/ref.fa') == 4
+        // a file is planned only once
+        planner.pendingCount == 1
+
+        when:
+        // files not stored on the local claims are not replicated
+        4.times { planner.register(['/shared/data/ref.fa']) }
+        then:
+        planner.fanOutOf('/shared/data/ref.fa') == 0
+        planner.pendingCount == 1
+    }
+
+    def 'should forget the files once consumed or replicated' () {
+        given:
+        def planner = Spy(K8sReplicationPlanner, constructorArgs: [Mock(K8sClient), 'name=mount-foo', '/localWork', 2, 3])
+
+        when:
+        planner.register(['/localWork/ab/sample1.fq', '/localWork/ab/ref.fa'])
+        planner.release(['/localWork/ab/sample1.fq', '/localWork/ab/ref.fa'])
+        then:
+        planner.fanOutOf('/localWork/ab/sample1.fq') == 0
+        planner.fanOutOf('/localWork/ab/ref.fa') == 0
+
+        when:
+        planner.register(['/localWork/ab/ref.fa'])
+        planner.register(['/localWork/ab/ref.fa'])
+        planner.start()
+        // wait for the planner to pick the file
+        while( planner.pendingCount )
+            sleep 50
+        planner.shutdown()
+        then:
+        1 * planner.replicate('/localWork/ab/ref.fa') >> null
+        and:
+        planner.fanOutOf('/localWork/ab/ref.fa') == 0
+
+        when:
+        // a replicated file is not tracked again
+        planner.register(['/localWork/ab/ref.fa'])
+        then:
+        planner.fanOutOf('/localWork/ab/ref.fa') == 0
+    }
+
+    def 'should create the pod copying a file on the target node' () {
+        given:
+        def client = Mock(K8sClient)
+        def spec = [containers: [[name: 'mount-foo', image: 'vsftpd', volumeMounts: [[name: 'vol-1', mountPath: '/localWork']]]],
+                    volumes: [[name: 'vol-1', hostPath: [path: '/localWork']]],
+                    nodeSelector: [foo: 'bar'] ]
+        def planner = new K8sReplicationPlanner(client, 'name=mount-foo', '/localWork', 1, 3, spec, Duration.of('1 min'), 'elegant_panini')
+
+        when:
+        def name = planner.createCopyPod('/localWork/ab/ref.fa', '10.0.0.1', 'n1', 1000)
+        then:
+        1 * client.podCreate({ Map pod ->
+            def podSpec = pod.spec as Map
+            def container = (podSpec.containers as List<Map>)[0]
+            pod.metadata.name == 'nf-elegant-panini-copy-1' &&
+                    pod.metadata.labels == [app: 'nextflow', 'nextflow.io/app': 'nextflow', 'nextflow.io/runName': 'elegant_panini'] &&
+                    podSpec.nodeName == 'n1' &&
+                    podSpec.restartPolicy == 'Never' &&
+                    !podSpec.nodeSelector &&
+                    podSpec.volumes == spec.volumes &&
+                    container.name == 'nf-elegant-panini-copy-1' &&
+                    container.volumeMounts == [[name: 'vol-1', mountPath: '/localWork']] &&
+                    container.command[0] == 'python3' &&
+                    container.command[3..5] == ['10.0.0.1', '/localWork/ab/ref.fa', '1000'] }) >> null
+        and:
+        name == 'nf-elegant-panini-copy-1'
+        // the template is not modified
+        spec.nodeSelector == [foo: 'bar']
+        spec.containers[0].name == 'mount-foo'
+    }
+
+    def 'should name the copy pods after the run' () {
+        given:
+        def planner = new K8sReplicationPlanner(Mock(K8sClient), 'name=mount-foo', '/localWork', 1, 3, [:], Duration.of('1 min'), RUN)
+
+        expect:
+        planner.copyPodName(COUNT) == EXPECTED
+
+        where:
+        RUN                 | COUNT | EXPECTED
+        'elegant_panini'    | 1     | 'nf-elegant-panini-copy-1'
+        'Foo.Bar'           | 12    | 'nf-foo-bar-copy-12'
+        'x' * 70            | 3     | 'nf-' + 'x' * 53 + '-copy-3'
+    }
+
+    def 'should give up a copy pod not completing in time' () {
+        given:
+        def client = Mock(K8sClient)
+        def planner = new K8sReplicationPlanner(client, 'name=mount-foo', '/localWork', 1, 3, [:], Duration.of('100 ms'))
+
+        when:
+        planner.awaitCopyPod('nf-foo-copy-1')
+        then:
+        (1.._) * client.podState('nf-foo-copy-1') >> [waiting: [reason: 'ImagePullBackOff']]
+        thrown(IOException)
+
+        when:
+        planner.awaitCopyPod('nf-foo-copy-2')
+        then:
+        1 * client.podState('nf-foo-copy-2') >> [terminated: [exitCode: 0]]
+        noExceptionThrown()
+    }
+
+    def 'should plan the copies as a tree' () {
+        expect:
+        K8sReplicationPlanner.planRounds('n0', []) == []
+        K8sReplicationPlanner.planRounds('n0', ['n1']) == [[copy('n0','n1')]]
+        K8sReplicationPlanner.planRounds('n0', ['n1','n2','n3']) == [
+                [copy('n0','n1')],
+                [copy('n0','n2'), copy('n1','n3')] ]
+        K8sReplicationPlanner.planRounds('n0', ['n1','n2','n3','n4','n5','n6','n7','n8']) == [
+                [copy('n0','n1')],
+                [copy('n0','n2'), copy('n1','n3')],
+                [copy('n0','n4'), copy('n1','n5'), copy('n2','n6'), copy('n3','n7')],
+                [copy('n0','n8')] ]
+    }
+
+    def 'should pick the target nodes' () {
+        given:
+        def client = Mock(K8sClient)
+        def planner = new K8sReplicationPlanner(client, 'name=mount-foo', '/localWork', 1, 2)
+
+        when:
+        def targets = planner.targetsOf('n0')
+        then:
+        1 * client.podNodes('name=mount-foo') >> ['n0','n1','n2','n3']
+        targets.size() == 2
+        !targets.contains('n0')
+        ['n1','n2','n3'].containsAll(targets)
+    }
+
+    def 'should replicate a file and register the new locations at once' () {
+        given:
+        def planner = Spy(K8sReplicationPlanner, constructorArgs: [Mock(K8sClient), 'name=mount-foo', '/localWork', 1, 3])
+        planner.start()
+
+        when:
+        planner.replicate('/localWork/ab/ref.fa')
+        then:
+        1 * planner.locationOf('/localWork/ab/ref.fa') >> [node: 'n0', locationWrapperID: 7]
+        1 * planner.targetsOf('n0') >> ['n1','n2','n3']
+        1 * planner.copy('/localWork/ab/ref.fa', 'n0', 'n1') >> [size: 100, timestamp: 1000]
+        1 * planner.copy('/localWork/ab/ref.fa', 'n0', 'n2') >> { throw new IOException('Connection refused') }
+        1 * planner.copy('/localWork/ab/ref.fa', 'n1', 'n3') >> [size: 100, timestamp: 1000]
+        1 * planner.addLocations([
+                [path: '/localWork/ab/ref.fa', size: 100, timestamp: 1000, locationWrapperID: 7, node: 'n1'],
+                [path: '/localWork/ab/ref.fa', size: 100, timestamp: 1000, locationWrapperID: 7, node: 'n3'] ]) >> null
+        and:
+        planner.replicatedCount == 1
+        planner.copyCount == 2
+        planner.copiedBytes == 200
+        planner.failedCount == 1
+
+        cleanup:
+        planner.shutdown()
+    }
+
+    def 'should skip copies from nodes not holding the file' () {
+        given:
+        def planner = Spy(K8sReplicationPlanner, constructorArgs: [Mock(K8sClient), 'name=mount-foo', '/localWork', 1, 3])
+        planner.start()
+
+        when:
+        planner.replicate('/localWork/ab/ref.fa')
+        then:
+        1 * planner.locationOf('/localWork/ab/ref.fa') >> [node: 'n0', locationWrapperID: 7]
+        1 * planner.targetsOf('n0') >> ['n1','n2','n3']
+        1 * planner.copy('/localWork/ab/ref.fa', 'n0', 'n1') >> { throw new IOException('Connection refused') }
+        1 * planner.copy('/localWork/ab/ref.fa', 'n0', 'n2') >> [size: 100, timestamp: 1000]
+        0 * planner.copy('/localWork/ab/ref.fa', 'n1', 'n3')
+        1 * planner.addLocations([
+                [path: '/localWork/ab/ref.fa', size: 100, timestamp: 1000, locationWrapperID: 7, node: 'n2'] ]) >> null
+        and:
+        planner.failedCount == 1
+
+        cleanup:
+        planner.shutdown()
+    }
+
+}
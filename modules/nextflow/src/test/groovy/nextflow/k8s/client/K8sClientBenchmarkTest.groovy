@@ -0,0 +1,95 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s.client
+
+import java.util.concurrent.Executors
+import java.util.concurrent.atomic.LongAdder
+
+import com.sun.net.httpserver.HttpExchange
+import com.sun.net.httpserver.HttpHandler
+import com.sun.net.httpserver.HttpServer
+import spock.lang.Requires
+import spock.lang.Specification
+import spock.lang.Unroll
+/**
+ * Measure the pod state queries per second sustained by the K8s client
+ * against a local stub API server.
+ *
+ * Run it with: NXF_BENCHMARK=true ./gradlew :nextflow:test --tests '*K8sClientBenchmarkTest'
+ */
+@Requires({ System.getenv('NXF_BENCHMARK') })
+class K8sClientBenchmarkTest extends Specification {
+
+    static final String POD_STATUS = '''
+        {
+          "kind": "Pod",
+          "status": {
+            "phase": "Running",
+            "containerStatuses": [ { "name": "nf-bench", "state": { "running": { "startedAt": "2023-01-01T00:00:00Z" } } } ]
+          }
+        }
+        '''.stripIndent()
+
+    @Unroll
+    def 'should benchmark pod state queries [pooled=#POOLED; threads=#THREADS]' () {
+        given:
+        def server = HttpServer.create(new InetSocketAddress(0), 0)
+        server.setExecutor(Executors.newFixedThreadPool(32))
+        server.createContext('/', new HttpHandler() {
+            @Override
+            void handle(HttpExchange exchange) throws IOException {
+                final bytes = POD_STATUS.bytes
+                exchange.sendResponseHeaders(200, bytes.length)
+                exchange.responseBody.withCloseable { it.write(bytes) }
+            }
+        })
+        server.start()
+        and:
+        def config = new ClientConfig(server: "http://localhost:${server.address.port}", namespace: 'bench', httpPool: POOLED)
+        def client = new K8sClient(config)
+        def count = new LongAdder()
+        def deadline = System.currentTimeMillis() + 5_000
+
+        when:
+        def workers = (1..THREADS).collect { int i ->
+            Thread.start {
+                // half the workers query the same pod to exercise requests coalescing
+                final name = "nf-bench-${i % 2 ? i : 0}"
+                while( System.currentTimeMillis() < deadline ) {
+                    client.podState(name)
+                    count.increment()
+                }
+            }
+        }
+        workers.each { it.join() }
+        then:
+        def qps = count.sum() / 5
+        println "K8s pod state queries -- pooled=$POOLED; threads=$THREADS; queries/sec=${qps}"
+        qps > 0
+
+        cleanup:
+        server?.stop(0)
+
+        where:
+        POOLED  | THREADS
+        false   | 1
+        true    | 1
+        false   | 16
+        true    | 16
+    }
+
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s.client
+
+import java.util.concurrent.Executors
+import java.util.concurrent.atomic.AtomicInteger
+
+import com.sun.net.httpserver.HttpExchange
+import com.sun.net.httpserver.HttpHandler
+import com.sun.net.httpserver.HttpServer
+import spock.lang.Specification
+import spock.lang.Timeout
+
+@Timeout(30)
+class K8sHttpTransportTest extends Specification {
+
+    HttpServer server
+    AtomicInteger hits = new AtomicInteger()
+    AtomicInteger running = new AtomicInteger()
+    AtomicInteger maxRunning = new AtomicInteger()
+
+    def setup() {
+        server = HttpServer.create(new InetSocketAddress(0), 0)
+        server.setExecutor(Executors.newFixedThreadPool(20))
+        server.createContext('/', new HttpHandler() {
+            @Override
+            void handle(HttpExchange exchange) throws IOException {
+                hits.incrementAndGet()
+                final current = running.incrementAndGet()
+                maxRunning.accumulateAndGet(current, { int a, int b -> Math.max(a,b) })
+                sleep 200
+                running.decrementAndGet()
+                final path = exchange.requestURI.path
+                final code = path.endsWith('/missing') ? 404 : 200
+                final body = code==200
+                        ? """{"path":"$path","auth":"${exchange.requestHeaders.getFirst('Authorization')}"}"""
+                        : '{"kind":"Status","code":404}'
+                exchange.sendResponseHeaders(code, body.bytes.length)
+                exchange.responseBody.withCloseable { it.write(body.bytes) }
+            }
+        })
+        server.start()
+    }
+
+    def cleanup() {
+        server?.stop(0)
+    }
+
+    protected String getEndpoint() {
+        "http://localhost:${server.address.port}"
+    }
+
+    def 'should send a request' () {
+        given:
+        def transport = new K8sHttpTransport(new ClientConfig(token: 'xyz'), null)
+
+        when:
+        def resp = transport.send('POST', endpoint, '/api/v1/pods', '{"foo":"bar"}')
+        then:
+        resp.code == 200
+        resp.text == '{"path":"/api/v1/pods","auth":"Bearer xyz"}'
+        transport.requestsCount == 1
+    }
+
+    def 'should throw a response exception on error' () {
+        given:
+        def transport = new K8sHttpTransport(new ClientConfig(), null)
+
+        when:
+        transport.send('GET', endpoint, '/api/v1/pods/missing')
+        then:
+        def e = thrown(K8sResponseException)
+        e.errorCode == 404
+        e.response.code == 404
+    }
+
+    def 'should coalesce identical concurrent get requests' () {
+        given:
+        def transport = new K8sHttpTransport(new ClientConfig(), null)
+
+        when:
+        def threads = (1..10).collect { Thread.start { transport.send('GET', endpoint, '/api/v1/namespaces/x/pods/foo/status') } }
+        threads.each { it.join() }
+        then:
+        hits.get() < 10
+        transport.requestsCount + transport.coalescedCount == 10
+        transport.coalescedCount > 0
+    }
+
+    def 'should not coalesce requests issued after the response is received' () {
+        given:
+        def transport = new K8sHttpTransport(new ClientConfig(), null)
+
+        when:
+        transport.send('GET', endpoint, '/api/v1/namespaces/x/pods/foo/status')
+        transport.send('GET', endpoint, '/api/v1/namespaces/x/pods/foo/status')
+        then:
+        hits.get() == 2
+        transport.coalescedCount == 0
+    }
+
+    def 'should fail requests once closed' () {
+        given:
+        def transport = new K8sHttpTransport(new ClientConfig(), null)
+
+        when:
+        transport.close()
+        transport.send('POST', endpoint, '/api/v1/pods', '{}')
+        then:
+        thrown(IllegalStateException)
+        hits.get() == 0
+    }
+
+    def 'should not coalesce log requests' () {
+        given:
+        def transport = new K8sHttpTransport(new ClientConfig(), null)
+
+        expect:
+        transport.isCoalescable('/api/v1/namespaces/x/pods/foo/status')
+        !transport.isCoalescable('/api/v1/namespaces/x/pods/foo/log')
+        !transport.isCoalescable('/api/v1/namespaces/x/pods/foo/log?follow=true')
+    }
+
+    def 'should limit the number of concurrent requests per verb' () {
+        given:
+        def transport = new K8sHttpTransport(new ClientConfig(httpMaxConcurrency: [DELETE: 2]), null)
+
+        when:
+        def threads = (1..8).collect { int i -> Thread.start { transport.send('DELETE', endpoint, "/api/v1/namespaces/x/pods/p$i") } }
+        threads.each { it.join() }
+        then:
+        hits.get() == 8
+        maxRunning.get() <= 2
+    }
+
+    def 'should return default concurrency limits' () {
+        given:
+        def transport = new K8sHttpTransport(new ClientConfig(httpMaxConcurrency: [GET: 5]), null)
+
+        expect:
+        transport.maxConcurrency('GET') == 5
+        transport.maxConcurrency('POST') == 32
+        transport.maxConcurrency('PATCH') == 16
+    }
+
+}
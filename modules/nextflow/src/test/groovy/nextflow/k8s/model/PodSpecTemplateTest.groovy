@@ -0,0 +1,133 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.k8s.model
+
+import groovy.json.JsonSlurper
+import nextflow.util.MemoryUnit
+import spock.lang.Specification
+
+class PodSpecTemplateTest extends Specification {
+
+    private PodSpecBuilder baseBuilder() {
+        final opts = new PodOptions([
+                [volumeClaim: 'first', mountPath: '/work'],
+                [config: 'my-config', mountPath: '/etc/config'],
+                [env: 'ALPHA', value: 'hello'],
+                [label: 'team', value: 'dev'],
+                [nodeSelector: 'gpu=true']
+        ])
+        new PodSpecBuilder()
+                .withImageName('debian:latest')
+                .withPodName('nf-template')
+                .withNamespace('ns1')
+                .withServiceAccount('sa1')
+                .withAnnotations([evict: 'false'])
+                .withPodOptions(opts)
+    }
+
+    def 'should build the same spec as the pod builder' () {
+        given:
+        PodSpecBuilder.VOLUMES.set(0)
+        def template = new PodSpecTemplate(baseBuilder())
+        def task = new PodSpecBuilder()
+                .withPodName('nf-123')
+                .withLabels([taskName: 'foo (1)'])
+                .withCommand(['/bin/bash', '-ue', '/work/.command.run'])
+                .withCpus(2)
+                .withMemory(MemoryUnit.of('1 GB'))
+                .withActiveDeadline(60)
+
+        when:
+        def result = template.build(task)
+        and:
+        PodSpecBuilder.VOLUMES.set(0)
+        def expected = baseBuilder()
+                .withPodName('nf-123')
+                .withLabels([taskName: 'foo (1)'])
+                .withCommand(['/bin/bash', '-ue', '/work/.command.run'])
+                .withCpus(2)
+                .withMemory(MemoryUnit.of('1 GB'))
+                .withActiveDeadline(60)
+                .build()
+        then:
+        result == expected
+        result.metadata.labels == [team: 'dev', taskName: 'foo_1']
+        and:
+        new JsonSlurper().parseText(template.toJson(result)) == expected
+    }
+
+    def 'should share the base spec across tasks' () {
+        given:
+        def template = new PodSpecTemplate(baseBuilder())
+
+        when:
+        def pod1 = template.build(new PodSpecBuilder().withPodName('nf-1').withArgs(['one']))
+        def pod2 = template.build(new PodSpecBuilder().withPodName('nf-2').withArgs(['two']))
+        then:
+        pod1.metadata.name == 'nf-1'
+        pod2.metadata.name == 'nf-2'
+        pod1.spec.containers[0].args == ['one']
+        pod2.spec.containers[0].args == ['two']
+        and:
+        pod1.spec.volumes.is(pod2.spec.volumes)
+        pod1.spec.containers[0].volumeMounts.is(pod2.spec.containers[0].volumeMounts)
+
+        when:
+        pod1.spec.volumes.add([name: 'other'])
+        then:
+        thrown(UnsupportedOperationException)
+    }
+
+    def 'should build a job spec' () {
+        given:
+        def template = new PodSpecTemplate(new PodSpecBuilder().withImageName('busybox').withPodName('nf-template'))
+
+        when:
+        def result = template.buildAsJob(new PodSpecBuilder().withPodName('nf-job').withCommand(['echo']))
+        then:
+        result == [
+                apiVersion: 'batch/v1',
+                kind: 'Job',
+                metadata: [name: 'nf-job', namespace: 'default'],
+                spec: [
+                        backoffLimit: 0,
+                        template: [
+                                spec: [
+                                        restartPolicy: 'Never',
+                                        containers: [ [name: 'nf-job', image: 'busybox', command: ['echo']] ]
+                                ]
+                        ]
+                ]
+        ]
+    }
+
+    def 'should patch the init container work dir' () {
+        given:
+        def base = new PodSpecBuilder()
+                .withImageName('busybox')
+                .withPodName('nf-template')
+                .withInitImageName('ftp')
+                .withInitCommand(['bash', '-c', 'init.sh'])
+        def template = new PodSpecTemplate(base)
+
+        when:
+        def result = template.build(new PodSpecBuilder().withPodName('nf-1').withInitWorkDir(java.nio.file.Paths.get('/work/xy')))
+        then:
+        result.spec.initContainers == [ [name: 'setup-environment', image: 'ftp', command: ['bash', '-c', 'init.sh'], workingDir: '/work/xy'] ]
+    }
+
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import nextflow.Session
+import nextflow.dag.DAG
+import spock.lang.Specification
+
+class CriticalPathRankerTest extends Specification {
+
+    def setupSpec() {
+        new Session()
+    }
+
+    private DAG.Vertex process(DAG dag, String name) {
+        def proc = Mock(TaskProcessor) { getName() >> name }
+        dag.createVertex(DAG.Type.PROCESS, name, proc)
+    }
+
+    def 'should reduce the dag to the processes graph' () {
+        given:
+        def dag = new DAG()
+        def a = process(dag, 'A')
+        def op1 = dag.createVertex(DAG.Type.OPERATOR, 'map')
+        def b = process(dag, 'B')
+        def c = process(dag, 'C')
+        def op2 = dag.createVertex(DAG.Type.OPERATOR, 'mix')
+        def d = process(dag, 'D')
+        and:
+        dag.createEdge(a, op1)
+        dag.createEdge(op1, b)
+        dag.createEdge(op1, c)
+        dag.createEdge(b, op2)
+        dag.createEdge(c, op2)
+        dag.createEdge(op2, d)
+
+        expect:
+        CriticalPathRanker.processGraph(dag) == [A: ['B','C'] as Set, B: ['D'] as Set, C: ['D'] as Set, D: [] as Set]
+    }
+
+    def 'should compute upward ranks' () {
+        given:
+        def graph = [A: ['B','C'] as Set, B: ['D'] as Set, C: ['D'] as Set, D: [] as Set]
+        def durations = [A: 1d, B: 10d, C: 2d, D: 5d]
+
+        when:
+        def ranks = CriticalPathRanker.upwardRanks(graph, { String it -> durations[it] })
+        then:
+        ranks == [A: 16d, B: 15d, C: 7d, D: 5d]
+    }
+
+    def 'should not loop on cycles' () {
+        given:
+        def graph = [A: ['B'] as Set, B: ['A'] as Set]
+
+        when:
+        def ranks = CriticalPathRanker.upwardRanks(graph, { String it -> 1d })
+        then:
+        ranks.A + ranks.B == 3d
+    }
+
+    def 'should use the mean duration for unknown processes' () {
+        expect:
+        new CriticalPathRanker(new DAG(), [A: 10d, B: 20d]).duration('X') == 15d
+        new CriticalPathRanker(new DAG(), [A: 10d, B: 20d]).duration('A') == 10d
+        new CriticalPathRanker(new DAG(), null).duration('X') == 1d
+    }
+
+    def 'should order tasks by rank' () {
+        given:
+        def dag = new DAG()
+        def a = process(dag, 'A')
+        def b = process(dag, 'B')
+        def w = process(dag, 'W')
+        dag.createEdge(a, b)
+        and:
+        def ranker = new CriticalPathRanker(dag, [A: 10d, B: 10d, W: 1d])
+        def handler = { String name -> Mock(TaskHandler) { getTask() >> Mock(TaskRun) { getProcessor() >> Mock(TaskProcessor) { getName() >> name } } } }
+        def w1 = handler('W'); def w2 = handler('W'); def b1 = handler('B'); def a1 = handler('A'); def x1 = handler('X')
+
+        when:
+        def queue = ranker.createQueue()
+        queue.addAll([w1, w2, x1, b1, a1])
+        then:
+        queue.size() == 5
+        queue.toList() == [a1, b1, w1, w2, x1]
+        and:
+        ranker.rank('A') == 20d
+        ranker.rank('B') == 10d
+        ranker.rank('X') == 0d
+
+        when:
+        // the ranks are updated when the dag changes
+        def c = process(dag, 'C')
+        dag.createEdge(b, c)
+        then:
+        ranker.rank('A') == 27d
+
+        when:
+        def itr = queue.iterator()
+        itr.next(); itr.next(); itr.remove()
+        then:
+        queue.size() == 4
+        queue.toList() == [a1, w1, w2, x1]
+        and:
+        queue.poll().is(a1)
+        queue.size() == 3
+    }
+
+    def 'should reduce the makespan of long chains behind a wide fan-out' () {
+        given:
+        def graph = [W: [] as Set, A1: ['A2'] as Set, A2: ['A3'] as Set, A3: ['A4'] as Set, A4: ['A5'] as Set, A5: [] as Set]
+        def durations = [W: 1d, A1: 10d, A2: 10d, A3: 10d, A4: 10d, A5: 10d]
+        def sim = new SchedulingSimulator(graph: graph, tasks: [W: 100, A1: 1, A2: 1, A3: 1, A4: 1, A5: 1], durations: durations, slots: 4)
+
+        when:
+        def fifo = sim.run()
+        def ranked = sim.run(CriticalPathRanker.upwardRanks(graph, { String it -> durations[it] }))
+        then:
+        fifo == 75d
+        ranked == 50d
+    }
+
+}
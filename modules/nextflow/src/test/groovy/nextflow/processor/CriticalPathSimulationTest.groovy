@@ -0,0 +1,84 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import spock.lang.Requires
+import spock.lang.Specification
+import spock.lang.Unroll
+/**
+ * Compare the makespan of the fifo and critical path submit policies on random
+ * layered workflows mixing long process chains and wide fan-outs of short tasks.
+ *
+ * Run it with: NXF_BENCHMARK=true ./gradlew :nextflow:test --tests '*CriticalPathSimulationTest'
+ */
+@Requires({ System.getenv('NXF_BENCHMARK') })
+class CriticalPathSimulationTest extends Specification {
+
+    static SchedulingSimulator randomWorkflow(long seed, int layers, int width, int slots) {
+        final rnd = new Random(seed)
+        final graph = new LinkedHashMap<String,Set<String>>()
+        final tasks = new HashMap<String,Integer>()
+        final durations = new HashMap<String,Double>()
+        List<String> previous = []
+        for( int l=0; l<layers; l++ ) {
+            final current = (0..<width).collect { "P${l}_${it}".toString() }
+            for( String p : current ) {
+                graph.put(p, new LinkedHashSet<String>())
+                // either a wide fan-out of short tasks or a few long tasks
+                final wide = rnd.nextInt(3)==0
+                tasks.put(p, wide ? 20 + rnd.nextInt(200) : 1 + rnd.nextInt(3))
+                durations.put(p, wide ? 1 + rnd.nextInt(5) as double : 20 + rnd.nextInt(100) as double)
+                if( previous ) {
+                    graph.get(previous[rnd.nextInt(previous.size())]).add(p)
+                    if( rnd.nextBoolean() )
+                        graph.get(previous[rnd.nextInt(previous.size())]).add(p)
+                }
+            }
+            previous = current
+        }
+        return new SchedulingSimulator(graph: graph, tasks: tasks, durations: durations, slots: slots)
+    }
+
+    @Unroll
+    def 'should compare makespans [layers=#LAYERS; width=#WIDTH; slots=#SLOTS]' () {
+        given:
+        def fifo = 0d
+        def ranked = 0d
+        def better = 0
+
+        when:
+        for( long seed=0; seed<RUNS; seed++ ) {
+            final sim = randomWorkflow(seed, LAYERS, WIDTH, SLOTS)
+            final ranks = CriticalPathRanker.upwardRanks(sim.graph, { String it -> sim.durations[it] })
+            final m1 = sim.run()
+            final m2 = sim.run(ranks)
+            fifo += m1
+            ranked += m2
+            if( m2 < m1 ) better++
+        }
+        then:
+        println "Makespan -- layers=$LAYERS; width=$WIDTH; slots=$SLOTS; fifo=${fifo/RUNS}; critical-path=${ranked/RUNS}; speedup=${String.format('%.3f', fifo/ranked)}; improved runs=$better/$RUNS"
+        ranked <= fifo
+
+        where:
+        RUNS | LAYERS | WIDTH | SLOTS
+        50   | 5      | 3     | 8
+        50   | 10     | 4     | 16
+        50   | 20     | 5     | 32
+    }
+
+}
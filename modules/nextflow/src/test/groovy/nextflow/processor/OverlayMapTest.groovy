@@ -0,0 +1,118 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import spock.lang.Specification
+
+class OverlayMapTest extends Specification {
+
+    def 'should read through the base map' () {
+        given:
+        def base = Collections.unmodifiableMap([cpus: 1, memory: '1 GB'])
+        def map = new OverlayMap(base)
+
+        expect:
+        map.cpus == 1
+        map.memory == '1 GB'
+        map.containsKey('cpus')
+        !map.containsKey('time')
+        map.size() == 2
+        map.overrides == 0
+    }
+
+    def 'should not modify the base map' () {
+        given:
+        def base = Collections.unmodifiableMap([cpus: 1, memory: '1 GB', time: '1h'])
+        def map = new OverlayMap(base)
+
+        when:
+        def prev = map.put('cpus', 4)
+        map.put('disk', '10 GB')
+        map.remove('time')
+        then:
+        prev == 1
+        map.cpus == 4
+        map.disk == '10 GB'
+        map.time == null
+        !map.containsKey('time')
+        map == [cpus: 4, memory: '1 GB', disk: '10 GB']
+        map.overrides == 3
+        and:
+        base == [cpus: 1, memory: '1 GB', time: '1h']
+
+        when:
+        map.put('time', '2h')
+        then:
+        map.time == '2h'
+        map.size() == 4
+
+        when:
+        map.clear()
+        then:
+        map.isEmpty()
+        map.cpus == null
+        base.size() == 3
+    }
+
+    def 'should write through the entry set' () {
+        given:
+        def base = Collections.unmodifiableMap([cpus: 1, memory: '1 GB', time: '1h'])
+        def map = new OverlayMap(base)
+        map.put('disk', '10 GB')
+
+        when:
+        for( Map.Entry entry : map.entrySet() ) {
+            if( entry.key == 'cpus' )
+                entry.setValue(4)
+        }
+        def itr = map.entrySet().iterator()
+        while( itr.hasNext() ) {
+            final key = itr.next().key
+            if( key == 'time' || key == 'disk' )
+                itr.remove()
+        }
+        then:
+        map == [cpus: 4, memory: '1 GB']
+        map.size() == 2
+        map.entrySet().size() == 2
+        !map.isEmpty()
+        and:
+        base == [cpus: 1, memory: '1 GB', time: '1h']
+
+        when:
+        map.keySet().removeAll(['cpus', 'memory'])
+        then:
+        map.isEmpty()
+        map.size() == 0
+    }
+
+    def 'should copy the local layer' () {
+        given:
+        def base = Collections.unmodifiableMap([cpus: 1, memory: '1 GB'])
+        def map = new OverlayMap(base)
+        map.put('cpus', 2)
+
+        when:
+        def copy = map.copy()
+        copy.put('cpus', 8)
+        copy.remove('memory')
+        then:
+        map == [cpus: 2, memory: '1 GB']
+        copy == [cpus: 8]
+    }
+
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import java.nio.file.Paths
+
+import nextflow.file.FileHolder
+import nextflow.script.params.FileInParam
+import nextflow.script.params.ValueInParam
+import nextflow.util.MemoryUnit
+import spock.lang.Specification
+
+class PendingTaskSpillTest extends Specification {
+
+    private TaskRun createTask(int id) {
+        final config = new TaskConfig()
+        final context = new TaskContext(Mock(Script), [sample: "s$id".toString(), reads: Paths.get("/data/s${id}.fq")], 'foo')
+        final task = new TaskRun(id: new TaskId(id), name: "foo ($id)", config: config, context: context)
+        config.setContext(context)
+        task.setInput(new ValueInParam(new Binding(), []), "s$id".toString())
+        task.setInput(new FileInParam(new Binding(), []), [new FileHolder(Paths.get("/data/s${id}.fq"))])
+        task.script = "echo s$id".toString()
+        return task
+    }
+
+    def 'should spill and restore tasks' () {
+        given:
+        def spill = new PendingTaskSpill(10)
+        def task1 = createTask(1)
+        def task2 = createTask(2)
+
+        when:
+        def done = spill.spill(task1) && spill.spill(task2)
+        then:
+        done
+        spill.size == 2
+        spill.isSpilled(task1)
+        and:
+        task1.script == null
+        task1.inputs.values() as List == [null, null]
+        task1.context.getHolder().keySet() == ['task'] as Set
+        task1.context.getHolder().task.is(task1.config)
+
+        when:
+        spill.restore(task2)
+        then:
+        spill.size == 1
+        !spill.isSpilled(task2)
+        task2.script == 'echo s2'
+        task2.inputs.values() as List == ['s2', [new FileHolder(Paths.get('/data/s2.fq'))]]
+        task2.context.sample == 's2'
+        task2.context.reads == Paths.get('/data/s2.fq')
+        task2.context.getHolder().task.is(task2.config)
+
+        when:
+        spill.restore(task1)
+        spill.restore(task1)
+        then:
+        spill.size == 0
+        spill.restoredCount == 2
+        task1.script == 'echo s1'
+        task1.context.sample == 's1'
+
+        cleanup:
+        spill?.close()
+    }
+
+    def 'should resolve the dynamic resource directives before spilling' () {
+        given:
+        def spill = new PendingTaskSpill(10)
+        def task1 = createTask(1)
+        task1.config.put('cpus', { sample.size() })
+        task1.config.put('memory', { "${sample.size()} GB" })
+        def task2 = createTask(2)
+        task2.config.put('cpus', { missing.size() })
+
+        when:
+        def done = spill.spill(task1)
+        then:
+        done
+        task1.context.getHolder().keySet() == ['task'] as Set
+        task1.config.getCpus() == 2
+        task1.config.getMemory() == MemoryUnit.of('2 GB')
+
+        when:
+        // a directive that cannot be resolved is reported when the task is submitted
+        done = spill.spill(task2)
+        then:
+        !done
+        !spill.isSpilled(task2)
+        task2.script == 'echo s2'
+
+        cleanup:
+        spill?.close()
+    }
+
+    def 'should keep in memory tasks that cannot be serialized' () {
+        given:
+        def spill = new PendingTaskSpill(10) {
+            @Override protected byte[] serialize(List payload) { throw new IllegalArgumentException('Not serializable') }
+        }
+        def task = createTask(1)
+
+        when:
+        def result = spill.spill(task)
+        then:
+        !result
+        spill.size == 0
+        task.script == 'echo s1'
+        task.context.sample == 's1'
+
+        cleanup:
+        spill?.close()
+    }
+
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import groovy.transform.CompileStatic
+/**
+ * Simulates the execution of a workflow on a fixed number of slots to compare
+ * the makespan of the task submission policies.
+ *
+ * Each process runs a number of tasks of the same duration. The task {@code i} of a process
+ * can be submitted when the task {@code i} of each upstream process is completed (or its
+ * last task when the upstream process has fewer tasks). The pending tasks are submitted in
+ * the order they become ready, unless a rank is given for the processes, in which case
+ * the tasks with the higher rank are submitted first.
+ */
+@CompileStatic
+class SchedulingSimulator {
+
+    static class Task {
+        String process
+        int index
+        double end
+    }
+
+    /**
+     * The processes graph, associating each process to the downstream processes
+     */
+    Map<String,Set<String>> graph
+
+    /**
+     * The number of tasks of each process
+     */
+    Map<String,Integer> tasks
+
+    /**
+     * The duration of the tasks of each process
+     */
+    Map<String,Double> durations
+
+    /**
+     * The number of tasks that can run at the same time
+     */
+    int slots
+
+    /**
+     * Run the simulation
+     *
+     * @param ranks The rank of each process or {@code null} to submit the tasks in arrival order
+     * @return The workflow makespan
+     */
+    double run(Map<String,Double> ranks=null) {
+        final upstream = new HashMap<String,List<String>>()
+        for( Map.Entry<String,Set<String>> entry : graph.entrySet() )
+            for( String it : entry.value )
+                upstream.computeIfAbsent(it, { k -> new ArrayList<String>() }).add(entry.key)
+        final done = new HashMap<String,boolean[]>()
+        final queued = new HashMap<String,boolean[]>()
+        for( String it : graph.keySet() ) {
+            done.put(it, new boolean[tasks.get(it)])
+            queued.put(it, new boolean[tasks.get(it)])
+        }
+
+        final pending = new ArrayList<Task>()
+        final running = new PriorityQueue<Task>({ Task a, Task b -> Double.compare(a.end, b.end) } as Comparator<Task>)
+        final Closure<Void> enqueue = { String process ->
+            final n = tasks.get(process)
+            for( int i=0; i<n; i++ ) {
+                if( queued.get(process)[i] )
+                    continue
+                boolean ready = true
+                for( String up : upstream.getOrDefault(process, Collections.<String>emptyList()) ) {
+                    final flags = done.get(up)
+                    if( !flags[Math.min(i, flags.length-1)] ) { ready = false; break }
+                }
+                if( ready ) {
+                    queued.get(process)[i] = true
+                    pending.add(new Task(process: process, index: i))
+                }
+            }
+            return null
+        }
+
+        for( String it : graph.keySet() )
+            enqueue.call(it)
+        double now = 0
+        while( pending || running ) {
+            if( ranks != null )
+                pending.sort { Task a, Task b -> Double.compare(ranks.get(b.process), ranks.get(a.process)) }
+            while( running.size() < slots && pending ) {
+                final task = pending.remove(0)
+                task.end = now + durations.get(task.process)
+                running.add(task)
+            }
+            final task = running.poll()
+            now = task.end
+            done.get(task.process)[task.index] = true
+            for( String it : graph.get(task.process) )
+                enqueue.call(it)
+        }
+        return now
+    }
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import java.util.concurrent.ConcurrentLinkedQueue
+import java.util.concurrent.CountDownLatch
+
+import nextflow.Session
+import nextflow.executor.Executor
+import spock.lang.Specification
+import spock.lang.Timeout
+
+@Timeout(10)
+class TaskCleanupTest extends Specification {
+
+    def 'should validate options' () {
+        when:
+        new TaskCleanup('foo', THREADS, RATE, QUEUE)
+        then:
+        thrown(IllegalArgumentException)
+
+        where:
+        THREADS | RATE | QUEUE
+        0       | 1    | 1
+        1       | 0    | 1
+        1       | 1    | 0
+    }
+
+    def 'should run actions in background' () {
+        given:
+        def done = new ConcurrentLinkedQueue<String>()
+        def threads = new ConcurrentLinkedQueue<Thread>()
+        def cleanup = new TaskCleanup('foo', 2, 1000, 100).start()
+
+        when:
+        cleanup.submit('a') { threads.add(Thread.currentThread()); done.add('a') }
+        cleanup.submit('b') { threads.add(Thread.currentThread()); done.add('b') }
+        cleanup.submit('c') { throw new IllegalStateException('Oops') }
+        cleanup.shutdown()
+        then:
+        done.sort() == ['a','b']
+        threads.every { it != Thread.currentThread() && it.priority == Thread.MIN_PRIORITY }
+        and:
+        cleanup.pendingCount == 0
+        cleanup.completedCount == 2
+        cleanup.failedCount == 1
+        cleanup.inlineCount == 0
+    }
+
+    def 'should run action inline when the queue is full' () {
+        given:
+        def done = new ConcurrentLinkedQueue<String>()
+        def cleanup = new TaskCleanup('foo', 1, 1000, 1)
+        def caller = Thread.currentThread()
+        Thread executed
+
+        when:
+        // the workers are not started, the first action fills the queue
+        cleanup.submit('a') { done.add('a') }
+        cleanup.submit('b') { executed = Thread.currentThread(); done.add('b') }
+        then:
+        done.toList() == ['b']
+        executed == caller
+        cleanup.pendingCount == 1
+        cleanup.inlineCount == 1
+
+        when:
+        cleanup.shutdown()
+        then:
+        done.toList() == ['b','a']
+        cleanup.pendingCount == 0
+    }
+
+    def 'should run action inline after shutdown' () {
+        given:
+        def cleanup = new TaskCleanup('foo').start()
+        def done = false
+        cleanup.shutdown()
+
+        when:
+        cleanup.submit('a') { done = true }
+        then:
+        done
+        cleanup.inlineCount == 1
+    }
+
+    def 'should not pace the actions on shutdown' () {
+        given:
+        def cleanup = new TaskCleanup('foo', 1, 1, 100)
+        100.times { cleanup.submit("action-$it") { } }
+
+        when:
+        // at the rate of one action per second the queue would take 100 seconds to drain
+        cleanup.start()
+        cleanup.shutdown()
+        then:
+        cleanup.pendingCount == 0
+        cleanup.completedCount == 100
+        cleanup.inlineCount == 0
+    }
+
+    def 'should defer cleanup action of the task handler' () {
+        given:
+        def latch = new CountDownLatch(1)
+        def cleanup = new TaskCleanup('foo').start()
+        def monitor = Mock(TaskPollingMonitor) { getTaskCleanup() >> cleanup }
+        def executor = Mock(Executor) { getMonitor() >> monitor }
+        def processor = Mock(TaskProcessor) { getExecutor() >> executor }
+        def handler = Spy(TaskHandler)
+        handler.task = new TaskRun(processor: processor)
+        def thread = null
+
+        when:
+        handler.deferCleanup('foo') { latch.await(); thread = Thread.currentThread() }
+        then:
+        thread == null
+
+        when:
+        latch.countDown()
+        cleanup.shutdown()
+        then:
+        thread != null
+        thread != Thread.currentThread()
+        cleanup.completedCount == 1
+    }
+
+    def 'should run cleanup action inline when not enabled' () {
+        given:
+        def monitor = Mock(TaskPollingMonitor) { getTaskCleanup() >> null }
+        def executor = Mock(Executor) { getMonitor() >> monitor }
+        def processor = Mock(TaskProcessor) { getExecutor() >> executor }
+        def handler = Spy(TaskHandler)
+        handler.task = new TaskRun(processor: processor)
+        def thread = null
+
+        when:
+        handler.deferCleanup('foo') { thread = Thread.currentThread() }
+        then:
+        thread == Thread.currentThread()
+    }
+
+    def 'should create task cleanup from executor config' () {
+        given:
+        def session = Mock(Session)
+        def monitor = new TaskPollingMonitor(name: 'foo', session: session, capacity: 10, pollInterval: '1s')
+
+        when:
+        def cleanup = monitor.createTaskCleanup()
+        then:
+        1 * session.getExecConfigProp('foo', 'asyncCleanup', false) >> false
+        cleanup == null
+
+        when:
+        cleanup = monitor.createTaskCleanup()
+        then:
+        1 * session.getExecConfigProp('foo', 'asyncCleanup', false) >> true
+        1 * session.getExecConfigProp('foo', 'cleanupThreads', 1) >> 2
+        1 * session.getExecConfigProp('foo', 'cleanupRateLimit', 20) >> 5
+        1 * session.getExecConfigProp('foo', 'cleanupQueueSize', 10_000) >> 10
+        cleanup != null
+
+        cleanup:
+        cleanup?.shutdown()
+    }
+
+}
@@ -32,6 +32,42 @@ import spock.lang.Specification
 class TaskConfigTest extends Specification {
 
 
+    def 'should create a task config sharing the process config' () {
+        given:
+        def shared = Collections.unmodifiableMap([cpus: 2, memory: { "${x} GB" }, ext: [args: { "--x ${x}" }]])
+
+        when:
+        def config1 = TaskConfig.overlay(shared).setContext(x: 1)
+        def config2 = TaskConfig.overlay(shared).setContext(x: 2)
+        then:
+        config1.isDynamic()
+        config1.memory == MemoryUnit.of('1 GB')
+        config2.memory == MemoryUnit.of('2 GB')
+        config1.ext.args == '--x 1'
+        config2.ext.args == '--x 2'
+
+        when:
+        config1.cpus = 8
+        then:
+        config1.cpus == 8
+        config2.cpus == 2
+        shared.cpus == 2
+
+        when:
+        def copy = config1.clone()
+        copy.cpus = 16
+        then:
+        copy.cpus == 16
+        config1.cpus == 8
+    }
+
+    def 'should not be dynamic when sharing static values' () {
+        expect:
+        !TaskConfig.overlay([cpus: 2, memory: '1 GB']).isDynamic()
+        TaskConfig.overlay([module: ['a', { 'b' }]]).isDynamic()
+        TaskConfig.overlay([ext: [args: { 'x' }]]).isDynamic()
+    }
+
     def testShell() {
 
         when:
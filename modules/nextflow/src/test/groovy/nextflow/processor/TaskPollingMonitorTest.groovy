@@ -71,6 +71,25 @@ class TaskPollingMonitorTest extends Specification {
     }
 
 
+    def 'should create the pending tasks spill' () {
+        given:
+        def session = Mock(Session)
+        def monitor = new TaskPollingMonitor(name:'local', session: session, pollInterval: '1s', capacity: 100)
+
+        when:
+        def spill = monitor.createPendingSpill()
+        then:
+        1 * session.getExecConfigProp('local', 'spillThreshold', 0) >> THRESHOLD
+        spill?.threshold == EXPECTED
+
+        where:
+        THRESHOLD   | EXPECTED
+        0           | null
+        -1          | null
+        1000        | 1000
+        '50'        | 50
+    }
+
     def 'check equals and hash code' () {
         expect:
         new RateUnit(2.1) == new RateUnit(2.1)
@@ -79,6 +98,34 @@ class TaskPollingMonitorTest extends Specification {
         new RateUnit(2.1).hashCode() != new RateUnit(3.3).hashCode()
     }
 
+    def 'should submit pending tasks by critical path rank' () {
+        given:
+        def session = Mock(Session) { isSuccess() >> true }
+        def monitor = Spy(new TaskPollingMonitor(name:'foo', session: session, pollInterval: Duration.of('1min')))
+        def ranker = Mock(CriticalPathRanker) { rank('A') >> 1d; rank('B') >> 2d; rank('C') >> 3d }
+        monitor.@pendingQueue = new CriticalPathRanker.RankedQueue(ranker)
+        and:
+        def handler = { String name -> Mock(TaskHandler) { getTask() >> Mock(TaskRun) { getProcessor() >> Mock(TaskProcessor) { getName() >> name } } } }
+        def h1 = handler('A')
+        def h2 = handler('B')
+        def h3 = handler('C')
+        monitor.getPendingQueue().addAll([h1, h2, h3])
+
+        when:
+        def count = monitor.submitPendingTasks()
+        then:
+        1 * monitor.canSubmit(h3) >> true
+        1 * monitor.submit(h3) >> null
+        then:
+        1 * monitor.canSubmit(h2) >> false
+        then:
+        1 * monitor.canSubmit(h1) >> true
+        1 * monitor.submit(h1) >> null
+        and:
+        count == 2
+        monitor.getPendingQueue().toList() == [h2]
+    }
+
     def 'should stringify' () {
         expect:
         new RateUnit(0.1).toString() == '0.10/sec'
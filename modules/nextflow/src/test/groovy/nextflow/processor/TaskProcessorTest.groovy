@@ -793,6 +793,26 @@ class TaskProcessorTest extends Specification {
 
     }
 
+    def 'should share the context variable names' () {
+        given:
+        def body = Mock(BodyDef) { getValNames() >> (['x', 'y', 'z'] as Set) }
+        def proc = Spy(TaskProcessor)
+        proc.@taskBody = body
+
+        when:
+        def names1 = proc.getContextVariableNames()
+        def names2 = proc.getContextVariableNames()
+        then:
+        1 * proc.getDeclaredNames() >> (['y'] as Set)
+        names1 == ['x', 'z'] as Set
+        names1.is(names2)
+
+        when:
+        names1.add('w')
+        then:
+        thrown(UnsupportedOperationException)
+    }
+
     def 'should normalise to path' () {
         given:
         def proc = new TaskProcessor()
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.processor
+
+import nextflow.script.BaseScript
+import nextflow.script.ProcessConfig
+import spock.lang.Requires
+import spock.lang.Specification
+import spock.lang.Unroll
+/**
+ * Measure the heap retained by pending tasks, comparing the task config
+ * sharing the process config with a full copy of it for each task.
+ *
+ * Run it with: NXF_BENCHMARK=true ./gradlew :nextflow:test --tests '*TaskRunHeapBenchmarkTest'
+ */
+@Requires({ System.getenv('NXF_BENCHMARK') })
+class TaskRunHeapBenchmarkTest extends Specification {
+
+    static final int TASKS = 100_000
+
+    static long usedHeap() {
+        final rt = Runtime.getRuntime()
+        for( int i=0; i<3; i++ ) {
+            System.gc()
+            sleep 100
+        }
+        return rt.totalMemory() - rt.freeMemory()
+    }
+
+    @Unroll
+    def 'should measure heap of pending tasks [shared=#SHARED]' () {
+        given:
+        def config = new ProcessConfig(Mock(BaseScript), 'bench')
+        config.cpus = 2
+        config.memory = { 2.GB * task.attempt }
+        config.time = '1h'
+        config.container = 'ubuntu:22.04'
+        config.publishDir '/data/results'
+        config.ext.args = '--fast'
+        config.label 'small'
+        and:
+        def tasks = new ArrayList<TaskRun>(TASKS)
+        def before = usedHeap()
+
+        when:
+        for( int i=0; i<TASKS; i++ ) {
+            final taskConfig = SHARED ? config.createTaskConfig() : new TaskConfig(config)
+            final task = new TaskRun(id: new TaskId(i), index: i, name: "bench ($i)", config: taskConfig)
+            task.config.index = i
+            task.config.process = 'bench'
+            task.config.executor = 'local'
+            tasks.add(task)
+        }
+        def used = usedHeap() - before
+        then:
+        println "Pending tasks heap -- shared=$SHARED; tasks=$TASKS; used=${used >> 20} MB; per task=${used.intdiv(TASKS)} bytes"
+        tasks.size() == TASKS
+
+        where:
+        SHARED << [false, true]
+    }
+
+}
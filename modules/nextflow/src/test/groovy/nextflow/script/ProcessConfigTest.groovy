@@ -273,6 +273,30 @@ class ProcessConfigTest extends Specification {
 
     }
 
+    def 'should share the process config among task configs' () {
+        given:
+        def config = new ProcessConfig(Mock(BaseScript))
+        config.cpus = 2
+
+        when:
+        def task1 = config.createTaskConfig()
+        def task2 = config.createTaskConfig()
+        task1.cpus = 4
+        then:
+        task1.cpus == 4
+        task2.cpus == 2
+        config.cpus == 2
+        config.@taskConfigBase.is(task2.getTarget().@base)
+
+        when:
+        def snapshot = config.@taskConfigBase
+        config.memory = '1 GB'
+        def task3 = config.createTaskConfig()
+        then:
+        task3.memory == MemoryUnit.of('1 GB')
+        !config.@taskConfigBase.is(snapshot)
+    }
+
     def 'should create PublishDir object' () {
 
         setup:
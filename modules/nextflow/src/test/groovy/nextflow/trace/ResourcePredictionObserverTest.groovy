@@ -0,0 +1,56 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.trace
+
+import java.nio.file.Files
+
+import nextflow.util.MemoryUnit
+import spock.lang.Specification
+
+class ResourcePredictionObserverTest extends Specification {
+
+    static final long MB = 1024 * 1024
+
+    def 'should render the predictions report' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def file = folder.resolve('report.tsv')
+        def predictor = new ResourcePredictor([:])
+        def observer = new ResourcePredictionObserver(predictor, file)
+        and:
+        def pred = new ResourcePredictor.Prediction(process: 'foo', cpus: 2, memory: MemoryUnit.of('1 GB'))
+        def t1 = new TraceRecord(); t1.putAll(status: 'COMPLETED', '%cpu': 150d, peak_rss: 512 * MB)
+        def t2 = new TraceRecord(); t2.putAll(status: 'FAILED', '%cpu': 50d, peak_rss: 1536 * MB)
+
+        expect:
+        predictor.tracking
+
+        when:
+        observer.add(pred, t1)
+        observer.add(pred, t2)
+        observer.onFlowComplete()
+        then:
+        file.text == '''\
+            process\ttasks\tfailed\tpred_cpus\tused_cpus\tpred_memory\tpeak_rss\tmax_peak_rss\tunder_predicted
+            foo\t2\t1\t2.00\t1.00\t1 GB\t1 GB\t1.5 GB\t1
+            '''.stripIndent()
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.trace
+
+import java.nio.file.Files
+
+import nextflow.processor.TaskConfig
+import nextflow.processor.TaskId
+import nextflow.processor.TaskProcessor
+import nextflow.processor.TaskRun
+import nextflow.util.MemoryUnit
+import spock.lang.Specification
+
+class ResourcePredictorTest extends Specification {
+
+    static final long MB = 1024 * 1024
+
+    private TraceRecord record(Map fields) {
+        def result = new TraceRecord()
+        result.putAll([status: 'COMPLETED'] + fields)
+        return result
+    }
+
+    def 'should not create the predictor when not enabled' () {
+        expect:
+        ResourcePredictor.create([:], null, null, 'foo') == null
+        ResourcePredictor.create(null, null, null, 'foo') == null
+    }
+
+    def 'should validate options' () {
+        when:
+        new ResourcePredictor([quantile: 1.5])
+        then:
+        thrown(IllegalArgumentException)
+
+        when:
+        new ResourcePredictor([margin: -1])
+        then:
+        thrown(IllegalArgumentException)
+    }
+
+    def 'should skip cached, failed and incomplete records' () {
+        given:
+        def predictor = new ResourcePredictor(minSamples: 1)
+
+        when:
+        def cached = record(process: 'foo', peak_rss: 100 * MB); cached.setCached(true)
+        predictor.add(cached)
+        predictor.add(record(process: 'foo', peak_rss: 100 * MB, status: 'FAILED'))
+        predictor.add(record(process: 'foo'))
+        predictor.add(record(peak_rss: 100 * MB))
+        predictor.fit()
+        then:
+        predictor.getModel('foo') == null
+        predictor.predict('foo', null) == null
+    }
+
+    def 'should predict resources from the quantile of the usage' () {
+        given:
+        def predictor = new ResourcePredictor(minSamples: 10, quantile: 0.9, margin: 0.5)
+
+        when:
+        // peak rss from 100 MB to 1000 MB, cpu usage from 10% to 100%
+        (1..10).each { predictor.add(record(process: 'foo', peak_rss: it * 100 * MB, '%cpu': it * 10 as Double)) }
+        // not enough samples
+        (1..5).each { predictor.add(record(process: 'bar', peak_rss: it * 100 * MB)) }
+        predictor.fit()
+        then:
+        predictor.getModel('foo').samples == 10
+        predictor.getModel('foo').slope == 0
+        predictor.getModel('foo').intercept == 900 * MB
+        predictor.getModel('foo').cpus == 0.9d
+        predictor.getModel('bar') == null
+
+        when:
+        def result = predictor.predict('foo', null)
+        then:
+        result.process == 'foo'
+        result.memory == MemoryUnit.of(1350 * MB)
+        result.cpus == 2
+    }
+
+    def 'should fit memory over the input size' () {
+        given:
+        def predictor = new ResourcePredictor(minSamples: 5, quantile: 1, margin: 0)
+
+        when:
+        // memory is 100 MB + 2 x input size, the last sample uses 10 MB more
+        (1..5).each { predictor.add(record(process: 'foo', input_bytes: it * 50 * MB, peak_rss: (100 + it * 100 + (it==5 ? 10 : 0)) * MB)) }
+        predictor.fit()
+        and:
+        def model = predictor.getModel('foo')
+        then:
+        model.slope > 1.9 && model.slope < 2.1
+        and:
+        // the prediction covers all the samples
+        predictor.predict('foo', 250 * MB).memory.toBytes() >= 610 * MB
+        predictor.predict('foo', 1000 * MB).memory.toBytes() > 2000 * MB
+    }
+
+    def 'should cap the predicted resources' () {
+        given:
+        def predictor = new ResourcePredictor(minSamples: 1, maxCpus: 2, maxMemory: '1 GB')
+
+        when:
+        predictor.add(record(process: 'foo', peak_rss: 4000 * MB, '%cpu': 800d))
+        predictor.fit()
+        def result = predictor.predict('foo', null)
+        then:
+        result.cpus == 2
+        result.memory == MemoryUnit.of('1 GB')
+    }
+
+    def 'should apply the prediction to the task' () {
+        given:
+        def predictor = new ResourcePredictor(minSamples: 1, margin: 0)
+        predictor.tracking = true
+        predictor.add(record(process: 'foo', peak_rss: 500 * MB, '%cpu': 150d))
+        predictor.fit()
+        and:
+        def processor = Mock(TaskProcessor) { getName() >> PROCESS }
+        def task = new TaskRun(id: TaskId.of(1), processor: processor, config: new TaskConfig(memory: '1 GB', cpus: 4, attempt: ATTEMPT))
+
+        when:
+        predictor.apply(task)
+        then:
+        task.inputBytes == 0
+        task.config.getMemory() == MemoryUnit.of(MEMORY)
+        task.config.getCpus() == CPUS
+        and:
+        (predictor.remove(TaskId.of(1)) != null) == PREDICTED
+
+        where:
+        PROCESS | ATTEMPT | MEMORY    | CPUS  | PREDICTED
+        'foo'   | 1       | '500 MB'  | 2     | true
+        'foo'   | 2       | '1 GB'    | 4     | true
+        'bar'   | 1       | '1 GB'    | 4     | false
+    }
+
+    def 'should check the size of an input file once' () {
+        given:
+        def predictor = new ResourcePredictor([:])
+        def file = Files.createTempFile('test', '.txt')
+        file.text = 'hello'
+
+        expect:
+        predictor.sizeOf(file) == 5
+
+        when:
+        file.text = 'hello world'
+        then:
+        predictor.sizeOf(file) == 5
+        predictor.sizeOf(file.resolveSibling('missing')) == 0
+
+        cleanup:
+        file?.delete()
+    }
+
+}
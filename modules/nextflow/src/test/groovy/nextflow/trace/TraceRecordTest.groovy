@@ -196,6 +196,29 @@ class TraceRecordTest extends Specification {
         trace.getFmtStr('peak_rss') == '192.5 MB'
     }
 
+    def 'should parse the file scan timing and strategy'() {
+
+        given:
+        def file = TestHelper.createInMemTempFile('trace')
+        file.text = '''\
+            nextflow.trace/v2
+            realtime=12021
+            infiles_time=15
+            infiles_strategy=getdents
+            outfiles_time=3
+            outfiles_strategy=
+            '''.stripIndent().leftTrim()
+
+        when:
+        def trace = ([:] as TraceRecord).parseTraceFile(file)
+
+        then:
+        trace.infiles_time == 15
+        trace.infiles_strategy == 'getdents'
+        trace.outfiles_time == 3
+        !trace.containsKey('outfiles_strategy')
+    }
+
     def 'should parse a legacy trace file and return a TraceRecord object'() {
 
         given:
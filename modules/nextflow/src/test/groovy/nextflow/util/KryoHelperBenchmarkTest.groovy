@@ -0,0 +1,97 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.util
+
+import java.nio.file.Paths
+
+import com.esotericsoftware.kryo.Kryo
+import com.esotericsoftware.kryo.io.Input
+import com.esotericsoftware.kryo.io.Output
+import nextflow.trace.TraceRecord
+import spock.lang.Requires
+import spock.lang.Specification
+/**
+ * Compare the serialization throughput and size of the cache records using
+ * unregistered classes and fresh buffers with the {@link KryoHelper} defaults.
+ *
+ * Run it with: NXF_BENCHMARK=true ./gradlew :nextflow:test --tests '*KryoHelperBenchmarkTest'
+ */
+@Requires({ System.getenv('NXF_BENCHMARK') })
+class KryoHelperBenchmarkTest extends Specification {
+
+    static final int RECORDS = 200_000
+
+    static Object record(int i) {
+        final trace = new TraceRecord([task_id: i, hash: 'ab/123456', name: "foo ($i)".toString(), status: 'COMPLETED', exit: 0, realtime: 1000L+i, '%cpu': 98.5d, rss: 1024L*i, workdir: "/work/ab/${i}".toString()])
+        final context = new LinkedHashMap([sample: "sample_$i".toString(), reads: new ArrayBag([Paths.get("/data/r${i}_1.fq"), Paths.get("/data/r${i}_2.fq")]), index: i, opts: [x: 1, y: [1,2,3]]])
+        return [trace.serialize(), context, 1, 'foo']
+    }
+
+    static byte[] legacySerialize(Kryo kryo, Object object) {
+        final buffer = new ByteArrayOutputStream(4*1024)
+        final output = new Output(buffer)
+        kryo.writeClassAndObject(output, object)
+        output.flush()
+        return buffer.toByteArray()
+    }
+
+    static Object legacyDeserialize(Kryo kryo, byte[] binary) {
+        kryo.readClassAndObject(new Input(new ByteArrayInputStream(binary)))
+    }
+
+    def 'should benchmark serialization' () {
+        given:
+        def legacy = KryoHelper.newInstance(false)
+        def records = (0..<1000).collect { record(it) }
+
+        when:
+        // warm up
+        for( int i=0; i<RECORDS; i++ ) {
+            legacyDeserialize(legacy, legacySerialize(legacy, records[i % records.size()]))
+            KryoHelper.deserialize(KryoHelper.serialize(records[i % records.size()]))
+        }
+        and:
+        long bytes1 = 0
+        def t1 = System.nanoTime()
+        for( int i=0; i<RECORDS; i++ )
+            bytes1 += legacySerialize(legacy, records[i % records.size()]).length
+        def ser1 = System.nanoTime() - t1
+        long bytes2 = 0
+        def t2 = System.nanoTime()
+        for( int i=0; i<RECORDS; i++ )
+            bytes2 += KryoHelper.serialize(records[i % records.size()]).length
+        def ser2 = System.nanoTime() - t2
+        and:
+        def legacyBinary = records.collect { legacySerialize(legacy, it) }
+        def binary = records.collect { KryoHelper.serialize(it) }
+        def t3 = System.nanoTime()
+        for( int i=0; i<RECORDS; i++ )
+            legacyDeserialize(legacy, legacyBinary[i % records.size()])
+        def deser1 = System.nanoTime() - t3
+        def t4 = System.nanoTime()
+        for( int i=0; i<RECORDS; i++ )
+            KryoHelper.deserialize(binary[i % records.size()])
+        def deser2 = System.nanoTime() - t4
+
+        then:
+        println "Kryo serialize   -- legacy: ${RECORDS * 1_000_000_000L / ser1} ops/s; pooled+registered: ${RECORDS * 1_000_000_000L / ser2} ops/s"
+        println "Kryo deserialize -- legacy: ${RECORDS * 1_000_000_000L / deser1} ops/s; pooled+registered: ${RECORDS * 1_000_000_000L / deser2} ops/s"
+        println "Kryo record size -- legacy: ${bytes1.intdiv(RECORDS)} bytes; pooled+registered: ${bytes2.intdiv(RECORDS)} bytes"
+        bytes2 < bytes1
+    }
+
+}
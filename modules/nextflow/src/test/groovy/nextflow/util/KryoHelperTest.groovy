@@ -16,6 +16,10 @@
 
 package nextflow.util
 
+import com.esotericsoftware.kryo.Kryo
+import com.esotericsoftware.kryo.KryoSerializable
+import com.esotericsoftware.kryo.io.Input
+import com.esotericsoftware.kryo.io.Output
 import groovy.transform.EqualsAndHashCode
 import nextflow.container.ContainerConfig
 import nextflow.file.FileHelper
@@ -182,4 +186,83 @@ class KryoHelperTest extends  Specification {
         copy == data
     }
 
+    def 'should register common classes with stable ids' () {
+        given:
+        def kryo = KryoHelper.newInstance()
+
+        expect:
+        kryo.getRegistration(ArrayList).id == 100
+        kryo.getRegistration(LinkedHashMap).id == 103
+        kryo.getRegistration(ArrayBag).id == 115
+        kryo.getRegistration(nextflow.trace.TraceRecord).id == 116
+        and:
+        !KryoHelper.newInstance(false).getClassResolver().getRegistration(ArrayBag)
+    }
+
+    def 'should not write the class name of common classes' () {
+        given:
+        def record = new nextflow.trace.TraceRecord([task_id: 1, name: 'foo', realtime: 100L, workdir: '/some/path'])
+
+        when:
+        def buffer = record.serialize()
+        then:
+        !new String(buffer).contains('java.util.LinkedHashMap')
+        nextflow.trace.TraceRecord.deserialize(buffer) == record
+    }
+
+    def 'should read data serialized with the class name' () {
+        given:
+        def data = [alpha: [1,2,3], beta: new ArrayBag(['x','y']), gamma: "Hello ${'world'}"]
+        def buffer = new ByteArrayOutputStream()
+        def output = new Output(buffer)
+        KryoHelper.newInstance(false).writeClassAndObject(output, data)
+        output.flush()
+
+        when:
+        def copy = KryoHelper.deserialize(buffer.toByteArray())
+        then:
+        copy == data
+        copy.beta instanceof ArrayBag
+    }
+
+    def 'should reuse pooled buffers' () {
+        given:
+        def large = 'x' * 10_000
+
+        when:
+        def b1 = KryoHelper.serialize([large])
+        def b2 = KryoHelper.serialize('hello')
+        def b3 = KryoHelper.serialize([large, large])
+        then:
+        KryoHelper.deserialize(b1) == [large]
+        KryoHelper.deserialize(b2) == 'hello'
+        KryoHelper.deserialize(b3) == [large, large]
+    }
+
+    static class Nested implements KryoSerializable {
+        Object value
+
+        @Override
+        void write(Kryo kryo, Output output) {
+            // serialize the value with a nested invocation
+            final bytes = KryoHelper.serialize(value)
+            output.writeInt(bytes.length)
+            output.writeBytes(bytes)
+        }
+
+        @Override
+        void read(Kryo kryo, Input input) {
+            value = KryoHelper.deserialize(input.readBytes(input.readInt()))
+        }
+    }
+
+    def 'should serialize with nested invocations' () {
+        when:
+        def buffer = KryoHelper.serialize([new Nested(value: [1,2,3]), 'foo'])
+        def copy = (List)KryoHelper.deserialize(buffer)
+        then:
+        copy[1] == 'foo'
+        (copy[0] as Nested).value == [1,2,3]
+    }
+
 }
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.util
+
+import java.nio.file.Path
+import java.nio.file.Paths
+
+import com.esotericsoftware.kryo.io.Input
+import com.esotericsoftware.kryo.io.Output
+import spock.lang.Specification
+
+class PathDictionaryTest extends Specification {
+
+    def 'should write and read paths with shared prefixes' () {
+        given:
+        def kryo = KryoHelper.newInstance()
+        def paths = ['/work/ab/1234/foo.txt', '/work/ab/1234/bar.txt', 'rel.txt', '/work/cd/5678/foo.txt', '/work/ab/1234/baz.txt', '/']
+        def output = new Output(1024)
+
+        when:
+        paths.each { PathDictionary.write(kryo, output, it) }
+        and:
+        def input = new Input(output.toBytes())
+        def result = paths.collect { assert input.readString() == null; PathDictionary.read(kryo, input) }
+        then:
+        result == paths
+        input.eof()
+    }
+
+    def 'should serialize paths in the same directory only once' () {
+        given:
+        def paths = (1..100).collect { Paths.get("/some/long/work/directory/path/ab/cdef1234567890/file_${it}.txt") }
+
+        when:
+        def buffer = KryoHelper.serialize(paths)
+        def copy = (List<Path>)KryoHelper.deserialize(buffer)
+        then:
+        copy == paths
+        and:
+        new String(buffer).count('/some/long/work/directory') == 1
+    }
+
+    def 'should read legacy path format' () {
+        given:
+        def output = new Output(1024)
+        output.writeString('file')
+        output.writeString('/some/path/file.txt')
+
+        when:
+        def path = new PathSerializer().read(KryoHelper.kryo(), new Input(output.toBytes()), Path)
+        then:
+        path == Paths.get('/some/path/file.txt')
+    }
+
+    def 'should reset the dictionary for each record' () {
+        given:
+        def p1 = Paths.get('/some/path/file1.txt')
+        def p2 = Paths.get('/some/path/file2.txt')
+
+        when:
+        def b1 = KryoHelper.serialize([p1])
+        def b2 = KryoHelper.serialize([p2])
+        then:
+        KryoHelper.deserialize(b2) == [p2]
+        KryoHelper.deserialize(b1) == [p1]
+    }
+
+}
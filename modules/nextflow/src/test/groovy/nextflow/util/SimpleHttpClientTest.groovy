@@ -17,6 +17,8 @@
 
 package nextflow.util
 
+import java.util.zip.GZIPInputStream
+
 import com.sun.net.httpserver.HttpExchange
 import com.sun.net.httpserver.HttpHandler
 import com.sun.net.httpserver.HttpServer
@@ -160,4 +162,39 @@ class SimpleHttpClientTest extends Specification{
     }
 
 
+    @Timeout(5)
+    def 'should compress the request body' () {
+        given:
+        def SMALL = '{"hello":"world!"}'
+        def LARGE = '{"data":"' + ('x' * 5_000) + '"}'
+        def received = []
+        def encodings = []
+
+        def server = HttpServer.create(new InetSocketAddress(0), 0)
+        server.createContext("/", new HttpHandler() {
+            @Override
+            void handle(HttpExchange exchange) throws IOException {
+                final encoding = exchange.requestHeaders.getFirst('Content-Encoding')
+                encodings << encoding
+                received << (encoding == 'gzip' ? new GZIPInputStream(exchange.requestBody).text : exchange.requestBody.text)
+                exchange.sendResponseHeaders(200, 2)
+                exchange.responseBody.withCloseable { it.write('OK'.bytes) }
+            }
+        })
+        server.start()
+        def ENDPOINT = "http://localhost:${server.address.port}/foo"
+
+        when:
+        def client = new SimpleHttpClient().setCompression(true)
+        client.sendHttpMessage( ENDPOINT, SMALL )
+        client.sendHttpMessage( ENDPOINT, LARGE )
+        then:
+        client.responseCode == 200
+        received == [SMALL, LARGE]
+        encodings == [null, 'gzip']
+
+        cleanup:
+        server?.stop(0)
+    }
+
 }
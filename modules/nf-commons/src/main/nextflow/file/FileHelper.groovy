@@ -827,6 +827,9 @@ class FileHelper {
         final singleParam = action.getMaximumNumberOfParameters() == 1
 
         final boolean outFileExists = new File(folder.resolve(".command.outfiles").toString()).exists()
+        // skip the directories not matching the literal prefix of the glob pattern
+        final dirFilter = syntax=='glob' && !outFileExists ? GlobDirFilter.create(filePattern, folder.fileSystem) : null
+        final threads = outFileExists ? 0 : getWalkThreads(options.parallel, folder)
 
         def visitor = new SimpleFileVisitor<Path>() {
 
@@ -842,6 +845,9 @@ class FileHelper {
                     singleParam ? action.call(result) : action.call(result,attrs)
                 }
 
+                if( depth>0 && dirFilter && !dirFilter.canMatch(path) )
+                    return FileVisitResult.SKIP_SUBTREE
+
                 return depth > maxDepth ? FileVisitResult.SKIP_SUBTREE : FileVisitResult.CONTINUE
             }
 
@@ -880,6 +886,8 @@ class FileHelper {
 
         if( outFileExists ){
             LocalFileWalker.walkFileTree(folder, walkOptions, Integer.MAX_VALUE, visitor, folder)
+        } else if( threads > 1 ) {
+            ParallelFileWalker.walkFileTree(folder, walkOptions, threads, visitor)
         } else {
             Files.walkFileTree(folder, walkOptions, Integer.MAX_VALUE, visitor)
         }
@@ -887,6 +895,20 @@ class FileHelper {
 
     }
 
+    /**
+     * @param value The {@code parallel} option, either a boolean or the number of threads
+     * @param folder The folder to be visited
+     * @return The number of threads to be used to visit the folder, parallel visit is only supported by the default file system
+     */
+    @PackageScope
+    static int getWalkThreads( value, Path folder ) {
+        if( value == null || value == false || folder.fileSystem != FileSystems.default )
+            return 0
+        if( value == true )
+            return Runtime.runtime.availableProcessors()
+        return value as int
+    }
+
     static protected Path relativize0(Path folder, Path fullPath) {
         def result = folder.relativize(fullPath)
         String str
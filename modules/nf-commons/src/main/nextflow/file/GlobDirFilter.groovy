@@ -0,0 +1,83 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.file
+
+import java.nio.file.FileSystem
+import java.nio.file.Path
+import java.nio.file.PathMatcher
+
+import groovy.transform.CompileStatic
+/**
+ * Decides whenever a directory visited while expanding a glob pattern can
+ * contain any matching path, so that non-matching sub-trees can be pruned early.
+ *
+ * The pattern is split in path segments. The segments preceding the first {@code **}
+ * wildcard must be matched by the corresponding components of the directory path,
+ * deeper directories cannot be pruned.
+ */
+@CompileStatic
+class GlobDirFilter {
+
+    final private List<PathMatcher> segments
+
+    private GlobDirFilter(List<PathMatcher> segments) {
+        this.segments = segments
+    }
+
+    /**
+     * Create a filter for the given glob pattern
+     *
+     * @param pattern The glob pattern relative to the visited folder
+     * @param fs The file system of the visited folder
+     * @return The {@link GlobDirFilter} instance or {@code null} if the pattern does not allow any pruning
+     */
+    static GlobDirFilter create(String pattern, FileSystem fs) {
+        if( !pattern || !pattern.contains('/') )
+            return null
+        // alternatives spanning multiple segments cannot be split
+        if( pattern.contains('{') || pattern.contains('\\') )
+            return null
+
+        final tokens = pattern.tokenize('/')
+        final matchers = new ArrayList<PathMatcher>()
+        // the last segment is matched by the files, only the parent ones are used
+        for( int i=0; i<tokens.size()-1; i++ ) {
+            final token = tokens.get(i)
+            if( token.contains('**') )
+                break
+            matchers.add(FileHelper.getPathMatcherFor("glob:$token", fs))
+        }
+        return matchers ? new GlobDirFilter(matchers) : null
+    }
+
+    /**
+     * @param dir The directory path relative to the visited folder
+     * @return {@code true} when the directory or any sub-directory can contain a matching path
+     */
+    boolean canMatch(Path dir) {
+        final count = Math.min(dir.nameCount, segments.size())
+        for( int i=0; i<count; i++ ) {
+            final name = dir.getName(i)
+            if( !name.toString() )
+                return true
+            if( !segments.get(i).matches(name) )
+                return false
+        }
+        return true
+    }
+
+}
@@ -180,33 +180,8 @@ class LocalFileWalker {
     }
 
     static Path exists( final File outfile, final Path file, final Path workDir, final LinkOption option ){
-
-        String rootDirString
-        Scanner sc = new Scanner( outfile )
-        if( sc.hasNext() )
-            rootDirString = sc.next().split(";")[0]
-        else
-           return null
-
-        final Path rootDir = rootDirString as Path
-        final Path fakePath = FileHelper.fakePath( file, rootDir )
-
-        //TODO ignore link
-        final Optional<Path> first = Files.lines( outfile.toPath() )
-                .parallel()
-                .map {line ->
-                    String[] data = line.split(';')
-                    Path currentPath = data[ VIRTUAL_PATH ] as Path
-                    log.trace "Compare $currentPath and $fakePath match: ${(currentPath == fakePath)}"
-                    return ( currentPath == fakePath )
-                            ? createLocalPath.apply( currentPath, new FileAttributes( data ), workDir )
-                            : null
-                }
-                .filter{ it != null }
-                .findFirst()
-
-        return first.isPresent() ? first.get() : null
-
+        final listing = OutfilesListing.parse( Files.readAllLines( outfile.toPath() ) )
+        return listing.resolve( file, workDir )
     }
 
     static interface TriFunction {
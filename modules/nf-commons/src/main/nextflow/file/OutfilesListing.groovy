@@ -0,0 +1,151 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.file
+
+import java.nio.file.FileSystems
+import java.nio.file.Files
+import java.nio.file.NoSuchFileException
+import java.nio.file.Path
+import java.nio.file.Paths
+
+import groovy.transform.CompileStatic
+/**
+ * The listing of the files produced by a task, as written to the {@code .command.outfiles}
+ * file by the native scanner when the task completes.
+ *
+ * The listing is read once and indexed by path, so that each declared output
+ * is resolved with a lookup instead of parsing the whole file again. The entries
+ * are also indexed by parent directory to walk the content of an output directory.
+ */
+@CompileStatic
+class OutfilesListing {
+
+    static final public String NAME = '.command.outfiles'
+
+    final private Path rootDir
+
+    final private Map<Path,String[]> entries
+
+    final private Map<Path,List<Path>> children
+
+    private OutfilesListing(Path rootDir, Map<Path,String[]> entries, Map<Path,List<Path>> children) {
+        this.rootDir = rootDir
+        this.entries = entries
+        this.children = children
+    }
+
+    /**
+     * Read the outfiles listing of a task work directory
+     *
+     * @param workDir The task work directory
+     * @return The {@link OutfilesListing} object or {@code null} when the work directory does not contain it
+     */
+    static OutfilesListing read(Path workDir) {
+        final file = workDir.resolve(NAME)
+        // the listing is only available on the local (or mounted) work directory
+        if( file.fileSystem != FileSystems.getDefault() )
+            return null
+        try {
+            return parse(Files.readAllLines(file))
+        }
+        catch( NoSuchFileException e ) {
+            return null
+        }
+    }
+
+    static OutfilesListing parse(List<String> lines) {
+        if( !lines )
+            return new OutfilesListing(null, Collections.<Path,String[]>emptyMap(), Collections.<Path,List<Path>>emptyMap())
+        final result = new HashMap<Path,String[]>(lines.size() * 2)
+        final children = new HashMap<Path,List<Path>>()
+        for( String line : lines ) {
+            if( !line )
+                continue
+            final String[] data = line.split(';')
+            final path = Paths.get(data[LocalFileWalker.VIRTUAL_PATH])
+            if( result.put(path, data) == null && path.parent != null )
+                children.computeIfAbsent(path.parent, { k -> new ArrayList<Path>() }).add(path)
+        }
+        final root = Paths.get(lines[0].split(';')[LocalFileWalker.VIRTUAL_PATH])
+        return new OutfilesListing(root, result, children)
+    }
+
+    /**
+     * @return The directory scanned to create the listing i.e. the task local work directory
+     */
+    Path getRootDir() { rootDir }
+
+    /**
+     * @return The number of entries in the listing
+     */
+    int size() { entries.size() }
+
+    /**
+     * Find the listing entry of a task output file
+     *
+     * @param file The output file path in the task work directory
+     * @return The entry fields or {@code null} if the file is not included in the listing
+     */
+    String[] entry(Path file) {
+        if( rootDir == null )
+            return null
+        return entries.get(FileHelper.fakePath(file, rootDir))
+    }
+
+    /**
+     * Find the listing entries of a task output i.e. the entry of the output itself
+     * and, when it's a directory, the entries of all the files it contains
+     *
+     * @param file The output file path in the task work directory
+     * @return The list of entry fields, empty if the file is not included in the listing
+     */
+    List<String[]> walk(Path file) {
+        if( rootDir == null )
+            return Collections.<String[]>emptyList()
+        final result = new ArrayList<String[]>()
+        final stack = new ArrayDeque<Path>()
+        stack.push(FileHelper.fakePath(file, rootDir))
+        while( stack ) {
+            final path = stack.pop()
+            final data = entries.get(path)
+            if( data != null )
+                result.add(data)
+            final nested = children.get(path)
+            if( nested )
+                stack.addAll(nested)
+        }
+        return result
+    }
+
+    /**
+     * Resolve a task output file against the listing
+     *
+     * @param file The output file path in the task work directory
+     * @param workDir The task work directory
+     * @return
+     *      The path of the output file as created by {@link LocalFileWalker#createLocalPath} or
+     *      {@code null} when the file is not listed or it was reported as missing when the listing was created
+     */
+    Path resolve(Path file, Path workDir) {
+        final data = entry(file)
+        if( data == null || data[LocalFileWalker.FILE_EXISTS] == '0' )
+            return null
+        final path = Paths.get(data[LocalFileWalker.VIRTUAL_PATH])
+        return LocalFileWalker.createLocalPath.apply(path, new LocalFileWalker.FileAttributes(data), workDir)
+    }
+
+}
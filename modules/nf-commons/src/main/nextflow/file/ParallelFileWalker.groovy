@@ -0,0 +1,186 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.file
+
+import java.nio.file.DirectoryStream
+import java.nio.file.FileSystemLoopException
+import java.nio.file.FileVisitOption
+import java.nio.file.FileVisitResult
+import java.nio.file.FileVisitor
+import java.nio.file.Files
+import java.nio.file.LinkOption
+import java.nio.file.Path
+import java.nio.file.attribute.BasicFileAttributes
+import java.util.concurrent.ForkJoinPool
+import java.util.concurrent.RecursiveAction
+
+import groovy.transform.CompileStatic
+import groovy.util.logging.Slf4j
+/**
+ * Walks a file tree visiting the directories concurrently.
+ *
+ * It applies the same {@link FileVisitor} protocol of {@link Files#walkFileTree}, with the
+ * exception of {@link FileVisitor#postVisitDirectory} which is never invoked, and the
+ * visit order which is not defined. Therefore the visitor must be thread safe.
+ */
+@Slf4j
+@CompileStatic
+class ParallelFileWalker {
+
+    static final private LinkOption[] NO_FOLLOW = [LinkOption.NOFOLLOW_LINKS] as LinkOption[]
+
+    static final private LinkOption[] FOLLOW = new LinkOption[0]
+
+    final private FileVisitor<? super Path> visitor
+
+    final private boolean followLinks
+
+    private ParallelFileWalker(FileVisitor<? super Path> visitor, boolean followLinks) {
+        this.visitor = visitor
+        this.followLinks = followLinks
+    }
+
+    /**
+     * Walk a file tree
+     *
+     * @param start The starting path
+     * @param options The walk options, only {@link FileVisitOption#FOLLOW_LINKS} is supported
+     * @param threads The number of threads used to visit the tree
+     * @param visitor The thread-safe visitor invoked for each file and directory
+     * @throws IOException if an I/O error is thrown by the visitor
+     */
+    static void walkFileTree(Path start, Set<FileVisitOption> options, int threads, FileVisitor<? super Path> visitor) throws IOException {
+        final walker = new ParallelFileWalker(visitor, options.contains(FileVisitOption.FOLLOW_LINKS))
+        final attrs = Files.readAttributes(start, BasicFileAttributes, walker.followLinks ? FOLLOW : NO_FOLLOW)
+        if( !attrs.isDirectory() ) {
+            visitor.visitFile(start, attrs)
+            return
+        }
+
+        final pool = new ForkJoinPool(threads)
+        try {
+            pool.invoke(new DirTask(walker, start, attrs, null))
+        }
+        catch( UncheckedIOException e ) {
+            // the fork-join pool may re-create the exception thrown by a worker thread
+            Throwable cause = e.cause
+            while( cause instanceof UncheckedIOException )
+                cause = cause.cause
+            throw (IOException)cause
+        }
+        finally {
+            pool.shutdown()
+        }
+    }
+
+    private BasicFileAttributes readAttributes(Path path) throws IOException {
+        if( !followLinks )
+            return Files.readAttributes(path, BasicFileAttributes, NO_FOLLOW)
+        try {
+            return Files.readAttributes(path, BasicFileAttributes, FOLLOW)
+        }
+        catch( IOException e ) {
+            // broken link, fallback on the link attributes as done by Files#walkFileTree
+            return Files.readAttributes(path, BasicFileAttributes, NO_FOLLOW)
+        }
+    }
+
+    /**
+     * Visit a directory, files are visited by the current thread while
+     * sub-directories are forked as new tasks
+     */
+    static private class DirTask extends RecursiveAction {
+
+        final private ParallelFileWalker walker
+
+        final private Path dir
+
+        final private BasicFileAttributes attrs
+
+        /**
+         * The file keys of the ancestor directories, used to detect loops when following links
+         */
+        final private List<Object> ancestors
+
+        DirTask(ParallelFileWalker walker, Path dir, BasicFileAttributes attrs, List<Object> ancestors) {
+            this.walker = walker
+            this.dir = dir
+            this.attrs = attrs
+            this.ancestors = ancestors
+        }
+
+        @Override
+        protected void compute() {
+            try {
+                compute0()
+            }
+            catch( IOException e ) {
+                throw new UncheckedIOException(e)
+            }
+        }
+
+        private void compute0() throws IOException {
+            final visitor = walker.visitor
+            if( visitor.preVisitDirectory(dir, attrs) != FileVisitResult.CONTINUE )
+                return
+
+            List<Object> keys = ancestors
+            if( walker.followLinks && attrs.fileKey() != null ) {
+                keys = ancestors != null ? new ArrayList<Object>(ancestors) : new ArrayList<Object>()
+                keys.add(attrs.fileKey())
+            }
+
+            final subtasks = new ArrayList<DirTask>()
+            DirectoryStream<Path> stream
+            try {
+                stream = Files.newDirectoryStream(dir)
+            }
+            catch( IOException e ) {
+                visitor.visitFileFailed(dir, e)
+                return
+            }
+            try {
+                for( Path entry : stream ) {
+                    BasicFileAttributes entryAttrs
+                    try {
+                        entryAttrs = walker.readAttributes(entry)
+                    }
+                    catch( IOException e ) {
+                        visitor.visitFileFailed(entry, e)
+                        continue
+                    }
+                    if( !entryAttrs.isDirectory() ) {
+                        visitor.visitFile(entry, entryAttrs)
+                    }
+                    else if( keys != null && entryAttrs.fileKey() != null && keys.contains(entryAttrs.fileKey()) ) {
+                        visitor.visitFileFailed(entry, new FileSystemLoopException(entry.toString()))
+                    }
+                    else {
+                        subtasks.add(new DirTask(walker, entry, entryAttrs, keys))
+                    }
+                }
+            }
+            finally {
+                stream.close()
+            }
+
+            if( subtasks )
+                invokeAll(subtasks)
+        }
+    }
+
+}
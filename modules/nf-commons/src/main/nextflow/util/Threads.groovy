@@ -31,6 +31,14 @@ class Threads {
         SysEnv.get('NXF_ENABLE_VIRTUAL_THREADS')=='true'
     }
 
+    /**
+     * @return {@code true} when dataflow operators should run on virtual threads, while
+     * processes keep using the default thread pool
+     */
+    static boolean useVirtualOperators() {
+        SysEnv.get('NXF_ENABLE_VIRTUAL_OPERATORS')=='true'
+    }
+
     static Thread start(Closure action) {
         return useVirtual()
                 ? Thread.startVirtualThread(action)
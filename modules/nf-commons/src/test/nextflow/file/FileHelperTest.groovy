@@ -488,6 +488,84 @@ class FileHelperTest extends Specification {
         folder?.deleteDir()
     }
 
+    def 'visit files in parallel' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        and:
+        folder.resolve('file1.fa').text = 'file 1'
+        folder.resolve('dir1/dir2').mkdirs()
+        folder.resolve('dir1/file2.fa').text = 'file 2'
+        folder.resolve('dir1/dir2/file3.fa').text = 'file 3'
+        folder.resolve('dir1/dir2/file4.txt').text = 'file 4'
+        folder.resolve('dir3').mkdirs()
+        folder.resolve('dir3/file5.fa').text = 'file 5'
+        and:
+        Files.createSymbolicLink(folder.resolve('dir1/dir2/loop'), folder.resolve('dir1'))
+
+        when:
+        def result = Collections.synchronizedList([])
+        FileHelper.visitFiles(folder, '**.fa', relative: true, parallel: true) { result << it.toString() }
+        then:
+        result.sort() == ['dir1/dir2/file3.fa', 'dir1/file2.fa', 'dir3/file5.fa', 'file1.fa']
+
+        when:
+        result = Collections.synchronizedList([])
+        FileHelper.visitFiles(folder, 'dir*', relative: true, type: 'dir', parallel: 4) { result << it.toString() }
+        then:
+        result.sort() == ['dir1', 'dir3']
+
+        when:
+        result = Collections.synchronizedList([])
+        FileHelper.visitFiles(folder, '**', relative: true, followLinks: false, parallel: 2) { result << it.toString() }
+        then:
+        result.sort() == ['dir1/dir2/file3.fa', 'dir1/dir2/file4.txt', 'dir1/dir2/loop', 'dir1/file2.fa', 'dir3/file5.fa', 'file1.fa']
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+    def 'should prune directories not matching the glob prefix' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        and:
+        folder.resolve('data/run1/sub').mkdirs()
+        folder.resolve('data/run1/a.fq').text = 'a'
+        folder.resolve('data/run1/sub/b.fq').text = 'b'
+        folder.resolve('data/other').mkdirs()
+        folder.resolve('data/other/c.fq').text = 'c'
+        folder.resolve('skip').mkdirs()
+        folder.resolve('skip/d.fq').text = 'd'
+
+        when:
+        def result = []
+        FileHelper.visitFiles(folder, 'data/run*/**.fq', relative: true) { result << it.toString() }
+        then:
+        result.sort() == ['data/run1/a.fq', 'data/run1/sub/b.fq']
+
+        when:
+        result = []
+        FileHelper.visitFiles(folder, '*/*/*.fq', relative: true) { result << it.toString() }
+        then:
+        result.sort() == ['data/other/c.fq', 'data/run1/a.fq']
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+    def 'should get walk threads' () {
+        expect:
+        FileHelper.getWalkThreads(VALUE, Paths.get('/some/path')) == EXPECTED
+        FileHelper.getWalkThreads(VALUE, fs.getPath('/some/path')) == 0
+
+        where:
+        VALUE   | EXPECTED
+        null    | 0
+        false   | 0
+        1       | 1
+        8       | 8
+        true    | Runtime.runtime.availableProcessors()
+    }
+
     def 'visit files in a base path with glob characters' () {
         given:
         def folder = Files.createTempDirectory('test[a-b]')
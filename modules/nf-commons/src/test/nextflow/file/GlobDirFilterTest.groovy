@@ -0,0 +1,60 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.file
+
+import java.nio.file.FileSystems
+import java.nio.file.Paths
+
+import spock.lang.Specification
+import spock.lang.Unroll
+
+class GlobDirFilterTest extends Specification {
+
+    @Unroll
+    def 'should not create filter for pattern: #PATTERN' () {
+        expect:
+        GlobDirFilter.create(PATTERN, FileSystems.default) == null
+
+        where:
+        PATTERN << ['*.fa', '**.fa', '**/*.fa', '{a,b/c}/*.fa', 'a\\*/*.fa', '']
+    }
+
+    @Unroll
+    def 'should check dir #DIR with pattern #PATTERN' () {
+        given:
+        def filter = GlobDirFilter.create(PATTERN, FileSystems.default)
+
+        expect:
+        filter.canMatch(Paths.get(DIR)) == EXPECTED
+
+        where:
+        PATTERN                 | DIR               | EXPECTED
+        'data/*.fq'             | 'data'            | true
+        'data/*.fq'             | 'other'           | false
+        'data/*.fq'             | 'data/sub'        | true
+        'data/run*/**.fq'       | 'data'            | true
+        'data/run*/**.fq'       | 'data/run1'       | true
+        'data/run*/**.fq'       | 'data/run1/x/y'   | true
+        'data/run*/**.fq'       | 'data/other'      | false
+        'data/run*/**.fq'       | 'skip'            | false
+        '*/sample_?/*.fq'       | 'foo/sample_1'    | true
+        '*/sample_?/*.fq'       | 'foo/sample_10'   | false
+        'a/**/b/*.fq'           | 'a/x/y'           | true
+        'a/**/b/*.fq'           | 'z'               | false
+    }
+
+}
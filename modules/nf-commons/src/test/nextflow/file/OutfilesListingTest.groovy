@@ -0,0 +1,103 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.file
+
+import java.nio.file.Files
+import java.nio.file.Path
+
+import spock.lang.Specification
+
+class OutfilesListingTest extends Specification {
+
+    static final String LISTING = '''\
+        /localwork/ab/cdef/;1;;4096;directory;16000000001;16000000002;16000000003
+        /localwork/ab/cdef/out.txt;1;;12;regular file;16000000001;16000000002;16000000003
+        /localwork/ab/cdef/res;1;;4096;directory;16000000001;16000000002;16000000003
+        /localwork/ab/cdef/res/data.csv;1;;100;regular file;16000000001;16000000002;16000000003
+        /localwork/ab/cdef/broken;0;/missing/file;symbolic link
+        '''.stripIndent()
+
+    def saved = LocalFileWalker.createLocalPath
+
+    def setup() {
+        LocalFileWalker.createLocalPath = { Path path, LocalFileWalker.FileAttributes attrs, Path workDir -> workDir.resolve('local').resolve(path.fileName) } as LocalFileWalker.TriFunction
+    }
+
+    def cleanup() {
+        LocalFileWalker.createLocalPath = saved
+    }
+
+    def 'should parse the listing' () {
+        when:
+        def listing = OutfilesListing.parse(LISTING.readLines())
+        then:
+        listing.rootDir == Path.of('/localwork/ab/cdef')
+        listing.size() == 5
+        listing.entry(Path.of('/work/ab/cdef/out.txt'))[LocalFileWalker.SIZE] == '12'
+        listing.entry(Path.of('/work/ab/cdef/res/data.csv'))[LocalFileWalker.SIZE] == '100'
+        listing.entry(Path.of('/work/ab/cdef/other.txt')) == null
+    }
+
+    def 'should resolve the listed files' () {
+        given:
+        def workDir = Path.of('/work/ab/cdef')
+        def listing = OutfilesListing.parse(LISTING.readLines())
+
+        expect:
+        listing.resolve(workDir.resolve('out.txt'), workDir) == Path.of('/work/ab/cdef/local/out.txt')
+        listing.resolve(workDir.resolve('res/data.csv'), workDir) == Path.of('/work/ab/cdef/local/data.csv')
+        and:
+        // not listed or missing files are not resolved
+        listing.resolve(workDir.resolve('other.txt'), workDir) == null
+        listing.resolve(workDir.resolve('broken'), workDir) == null
+    }
+
+    def 'should walk the entries of an output' () {
+        given:
+        def listing = OutfilesListing.parse(LISTING.readLines())
+
+        expect:
+        listing.walk(Path.of('/work/ab/cdef/res')).collect { it[LocalFileWalker.VIRTUAL_PATH] }.sort() == ['/localwork/ab/cdef/res', '/localwork/ab/cdef/res/data.csv']
+        listing.walk(Path.of('/work/ab/cdef/out.txt')).collect { it[LocalFileWalker.VIRTUAL_PATH] } == ['/localwork/ab/cdef/out.txt']
+        listing.walk(Path.of('/work/ab/cdef/other.txt')) == []
+        OutfilesListing.parse([]).walk(Path.of('/work/ab/cdef/out.txt')) == []
+    }
+
+    def 'should read the listing from the work dir' () {
+        given:
+        def workDir = Files.createTempDirectory('test')
+
+        expect:
+        OutfilesListing.read(workDir) == null
+
+        when:
+        workDir.resolve(OutfilesListing.NAME).text = LISTING
+        then:
+        OutfilesListing.read(workDir).size() == 5
+
+        when:
+        workDir.resolve(OutfilesListing.NAME).text = ''
+        def listing = OutfilesListing.read(workDir)
+        then:
+        listing.size() == 0
+        listing.resolve(workDir.resolve('out.txt'), workDir) == null
+
+        cleanup:
+        workDir?.deleteDir()
+    }
+
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package nextflow.file
+
+import java.nio.file.FileSystemLoopException
+import java.nio.file.FileVisitOption
+import java.nio.file.FileVisitResult
+import java.nio.file.Files
+import java.nio.file.Path
+import java.nio.file.SimpleFileVisitor
+import java.nio.file.attribute.BasicFileAttributes
+
+import spock.lang.Specification
+
+class ParallelFileWalkerTest extends Specification {
+
+    static class CollectVisitor extends SimpleFileVisitor<Path> {
+        Path base
+        List<String> dirs = Collections.synchronizedList([])
+        List<String> files = Collections.synchronizedList([])
+        List<String> loops = Collections.synchronizedList([])
+        Set<String> skip = []
+
+        @Override
+        FileVisitResult preVisitDirectory(Path dir, BasicFileAttributes attrs) throws IOException {
+            final path = base.relativize(dir).toString()
+            dirs << path
+            return path in skip ? FileVisitResult.SKIP_SUBTREE : FileVisitResult.CONTINUE
+        }
+
+        @Override
+        FileVisitResult visitFile(Path file, BasicFileAttributes attrs) throws IOException {
+            files << base.relativize(file).toString()
+            return FileVisitResult.CONTINUE
+        }
+
+        @Override
+        FileVisitResult visitFileFailed(Path file, IOException exc) throws IOException {
+            if( exc instanceof FileSystemLoopException ) {
+                loops << base.relativize(file).toString()
+                return FileVisitResult.SKIP_SUBTREE
+            }
+            throw exc
+        }
+    }
+
+    def 'should walk file tree' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        for( int i=0; i<5; i++ ) {
+            folder.resolve("dir$i/sub").mkdirs()
+            folder.resolve("dir$i/file.txt").text = 'x'
+            folder.resolve("dir$i/sub/file.txt").text = 'y'
+        }
+        folder.resolve('root.txt').text = 'z'
+        and:
+        def visitor = new CollectVisitor(base: folder, skip: ['dir4'] as Set)
+
+        when:
+        ParallelFileWalker.walkFileTree(folder, EnumSet.noneOf(FileVisitOption), 4, visitor)
+        then:
+        visitor.dirs.sort() == ['', 'dir0', 'dir0/sub', 'dir1', 'dir1/sub', 'dir2', 'dir2/sub', 'dir3', 'dir3/sub', 'dir4']
+        visitor.files.sort() == ['dir0/file.txt', 'dir0/sub/file.txt', 'dir1/file.txt', 'dir1/sub/file.txt', 'dir2/file.txt', 'dir2/sub/file.txt', 'dir3/file.txt', 'dir3/sub/file.txt', 'root.txt']
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+    def 'should detect loops when following links' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        folder.resolve('a/b').mkdirs()
+        folder.resolve('a/b/file.txt').text = 'x'
+        Files.createSymbolicLink(folder.resolve('a/b/loop'), folder.resolve('a'))
+        and:
+        def visitor = new CollectVisitor(base: folder)
+
+        when:
+        ParallelFileWalker.walkFileTree(folder, EnumSet.of(FileVisitOption.FOLLOW_LINKS), 2, visitor)
+        then:
+        visitor.dirs.sort() == ['', 'a', 'a/b']
+        visitor.files == ['a/b/file.txt']
+        visitor.loops == ['a/b/loop']
+
+        when:
+        visitor = new CollectVisitor(base: folder)
+        ParallelFileWalker.walkFileTree(folder, EnumSet.noneOf(FileVisitOption), 2, visitor)
+        then:
+        visitor.dirs.sort() == ['', 'a', 'a/b']
+        visitor.files.sort() == ['a/b/file.txt', 'a/b/loop']
+        visitor.loops == []
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+    def 'should propagate visitor errors' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        folder.resolve('a').mkdirs()
+        folder.resolve('a/file.txt').text = 'x'
+        and:
+        def visitor = Mock(SimpleFileVisitor)
+
+        when:
+        ParallelFileWalker.walkFileTree(folder, EnumSet.noneOf(FileVisitOption), 2, visitor)
+        then:
+        _ * visitor.preVisitDirectory(_,_) >> FileVisitResult.CONTINUE
+        1 * visitor.visitFile(_,_) >> { throw new IOException('Oops') }
+        and:
+        def e = thrown(IOException)
+        e.message == 'Oops'
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+}
@@ -55,6 +55,23 @@ class ThreadsTest extends Specification {
         result.get() == 'done'
     }
 
+    def 'should check virtual operators' () {
+        given:
+        SysEnv.push(ENV)
+
+        expect:
+        Threads.useVirtualOperators() == EXPECTED
+
+        cleanup:
+        SysEnv.pop()
+
+        where:
+        ENV                                         | EXPECTED
+        [:]                                         | false
+        [NXF_ENABLE_VIRTUAL_OPERATORS: 'false']     | false
+        [NXF_ENABLE_VIRTUAL_OPERATORS: 'true']      | true
+    }
+
     def 'should create and start virtual thread' () {
         given:
         SysEnv.push(NXF_ENABLE_VIRTUAL_THREADS: 'true')
@@ -24,6 +24,7 @@ import com.esotericsoftware.kryo.io.Output
 import nextflow.cloud.aws.nio.S3Path
 import groovy.transform.CompileStatic
 import groovy.util.logging.Slf4j
+import nextflow.util.PathDictionary
 import nextflow.util.SerializerRegistrant
 import org.pf4j.Extension
 /**
@@ -46,14 +47,23 @@ class S3PathSerializer extends Serializer<S3Path> implements SerializerRegistran
         final scheme = target.getFileSystem().provider().getScheme()
         final path = target.toString()
         log.trace "S3Path serialization > scheme: $scheme; path: $path"
-        output.writeString(scheme)
-        output.writeString(path)
+        PathDictionary.write(kryo, output, "$scheme://$path".toString())
     }
 
     @Override
     S3Path read(Kryo kryo, Input input, Class<S3Path> type) {
-        final scheme = input.readString()
-        final path = input.readString()
+        String scheme = input.readString()
+        String path
+        if( scheme == null ) {
+            // compact format, see PathDictionary
+            final uri = PathDictionary.read(kryo, input)
+            final p = uri.indexOf('://')
+            scheme = uri.substring(0, p)
+            path = uri.substring(p+3)
+        }
+        else {
+            path = input.readString()
+        }
         if( scheme != 's3' ) throw new IllegalStateException("Unexpected scheme for S3 path -- offending value '$scheme'")
         log.trace "S3Path de-serialization > scheme: $scheme; path: $path"
         return (S3Path) S3PathFactory.create("s3://${path}")
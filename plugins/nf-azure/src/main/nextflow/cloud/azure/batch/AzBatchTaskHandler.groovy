@@ -142,11 +142,13 @@ class AzBatchTaskHandler extends TaskHandler implements FusionAwareTask {
             return
         }
 
-        try {
-            batchService.deleteTask(taskKey)
-        }
-        catch( Exception e ) {
-            log.warn "Unable to cleanup batch task: $taskKey -- see the log file for details", e
+        deferCleanup("batch task: $taskKey") {
+            try {
+                batchService.deleteTask(taskKey)
+            }
+            catch( Exception e ) {
+                log.warn "Unable to cleanup batch task: $taskKey -- see the log file for details", e
+            }
         }
     }
 
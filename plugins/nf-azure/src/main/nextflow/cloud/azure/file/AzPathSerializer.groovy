@@ -23,6 +23,7 @@ import groovy.transform.CompileStatic
 import groovy.util.logging.Slf4j
 import nextflow.cloud.azure.nio.AzPath
 import nextflow.file.FileHelper
+import nextflow.util.PathDictionary
 import nextflow.util.SerializerRegistrant
 
 /**
@@ -37,12 +38,15 @@ class AzPathSerializer extends Serializer<AzPath> implements SerializerRegistran
     @Override
     void write(Kryo kryo, Output output, AzPath path) {
         log.trace "Azure Blob storage path serialisation > path=$path"
-        output.writeString(path.toUriString())
+        PathDictionary.write(kryo, output, path.toUriString())
     }
 
     @Override
     AzPath read(Kryo kryo, Input input, Class<AzPath> type) {
-        final path = input.readString()
+        // a null string marks the compact format, see PathDictionary
+        String path = input.readString()
+        if( path == null )
+            path = PathDictionary.read(kryo, input)
         log.trace "Azure Blob storage path > path=$path"
         return (AzPath)FileHelper.asPath(path)
     }
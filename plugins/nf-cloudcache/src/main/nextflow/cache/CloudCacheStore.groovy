@@ -167,6 +167,11 @@ class CloudCacheStore implements CacheStore {
         }
     }
 
+    @Override
+    boolean eachIndex(String name, Closure action) {
+        return Index.eachEntry(dataPath.resolve("index.$name"), action)
+    }
+
     @Override
     byte[] getEntry(HashCode key) {
         try {
@@ -187,6 +192,14 @@ class CloudCacheStore implements CacheStore {
         getCachePath(key).delete()
     }
 
+    @Override
+    void writeBatch(Map<HashCode,byte[]> entries, Collection<HashCode> deleted) {
+        for( Map.Entry<HashCode,byte[]> entry : entries.entrySet() )
+            putEntry(entry.key, entry.value)
+        for( HashCode key : deleted )
+            deleteEntry(key)
+    }
+
     private Path getCachePath(HashCode key) {
         dataPath.resolve(key.toString())
     }
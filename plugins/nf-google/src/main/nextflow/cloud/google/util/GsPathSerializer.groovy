@@ -24,6 +24,7 @@ import com.google.cloud.storage.contrib.nio.CloudStorageFileSystem
 import com.google.cloud.storage.contrib.nio.CloudStoragePath
 import groovy.transform.CompileStatic
 import groovy.util.logging.Slf4j
+import nextflow.util.PathDictionary
 import nextflow.util.SerializerRegistrant
 import org.pf4j.Extension
 /**
@@ -43,12 +44,15 @@ class GsPathSerializer extends Serializer<CloudStoragePath> implements Serialize
             path = '/' + path
         path = target.bucket() + path
         log.trace "Google CloudStoragePath serialisation > path=$path"
-        output.writeString(path)
+        PathDictionary.write(kryo, output, path)
     }
 
     @Override
     CloudStoragePath read(Kryo kryo, Input input, Class<CloudStoragePath> type) {
-        final path = input.readString()
+        // a null string marks the compact format, see PathDictionary
+        String path = input.readString()
+        if( path == null )
+            path = PathDictionary.read(kryo, input)
         log.trace "Google CloudStoragePath de-serialization > path=$path"
         def uri = CloudStorageFileSystem.URI_SCHEME + '://' + path
         (CloudStoragePath) GsPathFactory.parse(uri)
@@ -19,6 +19,8 @@ package nextflow.cloud.google.util
 import java.nio.file.Path
 import java.nio.file.Paths
 
+import com.esotericsoftware.kryo.io.Input
+import com.esotericsoftware.kryo.io.Output
 import com.google.cloud.storage.contrib.nio.CloudStoragePath
 import nextflow.Global
 import nextflow.Session
@@ -47,4 +49,19 @@ class GsPathSerializerTest extends Specification {
         copy.toUri() == uri
         copy.toUriString() == "gs://my-seq/data/ggal/sample.fq"
     }
+
+    def 'should deserialize a google cloud path in legacy format'() {
+        given:
+        Global.session = Mock(Session) {
+            getConfig() >> [google:[project:'foo', region:'x']]
+        }
+        and:
+        def output = new Output(1024)
+        output.writeString('my-seq/data/ggal/sample.fq')
+
+        when:
+        def copy = new GsPathSerializer().read(KryoHelper.kryo(), new Input(output.toBytes()), CloudStoragePath)
+        then:
+        copy.toUriString() == "gs://my-seq/data/ggal/sample.fq"
+    }
 }
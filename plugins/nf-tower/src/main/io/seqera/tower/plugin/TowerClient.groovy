@@ -54,6 +54,10 @@ class TowerClient implements TraceObserver {
 
     static private final int TASKS_PER_REQUEST = 100
 
+    static private final Duration SPOOL_RETRY_INTERVAL = Duration.of('10 sec')
+
+    static private final Set<String> TERMINAL_STATUS = ['COMPLETED', 'FAILED', 'ABORTED', 'CACHED'] as Set<String>
+
     static private final Duration REQUEST_INTERVAL = Duration.of('1 sec')
 
     static private final Duration ALIVE_INTERVAL = Duration.of('1 min')
@@ -134,6 +138,30 @@ class TowerClient implements TraceObserver {
 
     private TowerArchiver archiver
 
+    private int batchSize = TASKS_PER_REQUEST
+
+    private boolean compression
+
+    private boolean deltaEncoding
+
+    private Duration requestTimeout
+
+    private TowerSpool spool
+
+    /**
+     * The last sent record of each task not yet terminated, used for delta encoding
+     * -- accessed only by the sender thread
+     */
+    private Map<Object,Map<String,Object>> sentRecords = new HashMap<>()
+
+    /**
+     * The records included in the request being sent, committed to {@link #sentRecords}
+     * once the request is delivered -- a {@code null} value marks a terminated task
+     */
+    private Map<Object,Map<String,Object>> pendingRecords = new HashMap<>()
+
+    private long nextSpoolFlush
+
     /**
      * Constructor that consumes a URL and creates
      * a basic HTTP client.
@@ -198,6 +226,36 @@ class TowerClient implements TraceObserver {
 
     String getWorkspaceId() { workspaceId }
 
+    void setBatchSize( int value ) {
+        this.batchSize = value
+    }
+
+    int getBatchSize() { batchSize }
+
+    void setCompression( boolean value ) {
+        this.compression = value
+    }
+
+    boolean getCompression() { compression }
+
+    void setDeltaEncoding( boolean value ) {
+        this.deltaEncoding = value
+    }
+
+    boolean getDeltaEncoding() { deltaEncoding }
+
+    void setRequestTimeout( Duration value ) {
+        this.requestTimeout = value
+    }
+
+    Duration getRequestTimeout() { requestTimeout }
+
+    void setSpool( TowerSpool spool ) {
+        this.spool = spool
+    }
+
+    TowerSpool getSpool() { spool }
+
     /**
      * Check the URL and create an HttpPost() object. If a invalid i.e. protocol is used,
      * the constructor will raise an exception.
@@ -264,7 +322,7 @@ class TowerClient implements TraceObserver {
      */
     @Override
     void onFlowCreate(Session session) {
-        log.debug "Creating Tower observer -- endpoint=$endpoint; requestInterval=$requestInterval; aliveInterval=$aliveInterval; maxRetries=$maxRetries; backOffBase=$backOffBase; backOffDelay=$backOffDelay"
+        log.debug "Creating Tower observer -- endpoint=$endpoint; requestInterval=$requestInterval; aliveInterval=$aliveInterval; maxRetries=$maxRetries; backOffBase=$backOffBase; backOffDelay=$backOffDelay; batchSize=$batchSize; compression=$compression; deltaEncoding=$deltaEncoding; requestTimeout=$requestTimeout; spool=${spool?.dir ?: '-'}"
         
         this.session = session
         this.aggregator = new ResourcesAggregator(session)
@@ -347,6 +405,11 @@ class TowerClient implements TraceObserver {
         httpClient.maxRetries = maxRetries
         httpClient.backOffBase = backOffBase
         httpClient.backOffDelay = backOffDelay
+        httpClient.compression = compression
+        if( requestTimeout ) {
+            httpClient.connectTimeout = requestTimeout.toMillis() as int
+            httpClient.readTimeout = requestTimeout.toMillis() as int
+        }
 
         final req = makeBeginReq(session)
         final resp = sendHttpMessage(urlTraceBegin, req, 'PUT')
@@ -388,6 +451,12 @@ class TowerClient implements TraceObserver {
         events << new ProcessEvent(completed: true)
         // wait the submission of pending events
         sender.join()
+        // last attempt to deliver the spooled requests
+        if( spool != null ) {
+            nextSpoolFlush = 0
+            flushSpool()
+            spool.close()
+        }
         // wait and flush reports content
         reports.flowComplete()
         // notify the workflow completion
@@ -521,15 +590,21 @@ class TowerClient implements TraceObserver {
      * @param payload An additional object to send. Must be of type TraceRecord or Manifest
      */
     protected Response sendHttpMessage(String url, Map payload, String method='POST'){
+        final String json = payload != null ? generator.toJson(payload) : null
+        return sendHttpMessage0(url, json, method)
+    }
+
+    protected Response sendHttpMessage0(String url, String json, String method){
 
         int refreshTries=0
         final currentRefresh = refreshToken ?: env.get('TOWER_REFRESH_TOKEN')
 
         while ( true ) {
             // The actual HTTP request
-            final String json = payload != null ? generator.toJson(payload) : null
-            final String debug = json != null ? JsonOutput.prettyPrint(json).indent() : '-'
-            log.trace "HTTP url=$url; payload:\n${debug}\n"
+            if( log.isTraceEnabled() ) {
+                final String debug = json != null ? JsonOutput.prettyPrint(json).indent() : '-'
+                log.trace "HTTP url=$url; payload:\n${debug}\n"
+            }
             try {
                 if( refreshTries==1 ) {
                     refreshToken(currentRefresh)
@@ -542,6 +617,10 @@ class TowerClient implements TraceObserver {
                 String msg = "Unable to connect to Tower API: ${getHostUrl(url)}"
                 return new Response(0, msg)
             }
+            catch( SocketTimeoutException e ) {
+                String msg = "Tower API request timed out: ${getHostUrl(url)}"
+                return new Response(0, msg)
+            }
             catch (IOException e) {
                 int code = httpClient.responseCode
                 if( code == 401 && ++refreshTries==1 && currentRefresh ) {
@@ -696,16 +775,66 @@ class TowerClient implements TraceObserver {
 
         def payload = new ArrayList(tasks.size())
         for( TraceRecord rec : tasks ) {
-            payload << makeTaskMap0(rec)
+            final record = makeTaskMap0(rec)
+            payload << (deltaEncoding ? makeTaskDelta(record) : record)
         }
 
         final result = new LinkedHashMap(5)
         result.put('tasks', payload)
+        if( deltaEncoding )
+            result.put('delta', true)
         result.put('progress', getWorkflowProgress(true))
         result.instant = Instant.now().toEpochMilli()
         return result
     }
 
+    /**
+     * Delta encode a task record ie. keep only the fields changed since the last record
+     * sent for the same task. The first record of a task is sent in full and the task
+     * state is discarded once it reaches a terminal status.
+     *
+     * The record is compared with the last one successfully delivered, and becomes the
+     * new reference only when the request is delivered, see {@link #commitTaskDeltas(boolean)}
+     *
+     * @param record The task record as returned by {@link #makeTaskMap0(nextflow.trace.TraceRecord)}
+     * @return The record holding the task id and the changed fields
+     */
+    protected Map makeTaskDelta(Map<String,?> record) {
+        final key = record.taskId
+        final terminal = TERMINAL_STATUS.contains(record.status as String)
+        final previous = sentRecords.get(key)
+        pendingRecords.put(key, terminal ? null : new HashMap<String,Object>(record))
+        if( previous == null )
+            return record
+
+        final result = new LinkedHashMap<String,Object>()
+        result.taskId = key
+        for( Map.Entry<String,?> entry : record.entrySet() ) {
+            if( previous.get(entry.key) != entry.value )
+                result.put(entry.key, entry.value)
+        }
+        return result
+    }
+
+    /**
+     * Update the last sent records with the ones included in the last request
+     *
+     * @param delivered
+     *      When {@code false} the request was not delivered, the records are discarded so
+     *      that the next request includes again the fields changed since the last delivered one
+     */
+    protected void commitTaskDeltas(boolean delivered) {
+        if( delivered ) {
+            for( Map.Entry<Object,Map<String,Object>> entry : pendingRecords.entrySet() ) {
+                if( entry.value == null )
+                    sentRecords.remove(entry.key)
+                else
+                    sentRecords.put(entry.key, entry.value)
+            }
+        }
+        pendingRecords.clear()
+    }
+
     protected List getMetricsList() {
         return aggregator.computeSummaryList()
     }
@@ -792,22 +921,29 @@ class TowerClient implements TraceObserver {
     }
 
     protected void sendTasks0(dummy) {
-        final tasks = new HashMap<TaskId, TraceRecord>(TASKS_PER_REQUEST)
+        final tasks = new HashMap<TaskId, TraceRecord>(batchSize)
+        final pending = new ArrayList<ProcessEvent>(batchSize)
         boolean complete = false
         long previous = System.currentTimeMillis()
         final long period = requestInterval.millis
         final long delay = period / 10 as long
 
         while( !complete ) {
-            final ProcessEvent ev = events.poll(delay, TimeUnit.MILLISECONDS)
+            final ProcessEvent head = events.poll(delay, TimeUnit.MILLISECONDS)
+            // drain the events already available up to the batch size
+            if( head ) {
+                pending.add(head)
+                events.drainTo(pending, batchSize-1)
+            }
             // reconcile task events ie. send out only the last event
-            if( ev ) {
+            for( ProcessEvent ev : pending ) {
                 log.trace "Tower event=$ev"
                 if( ev.trace )
                     tasks[ev.trace.taskId] = ev.trace
                 if( ev.completed )
                     complete = true
             }
+            pending.clear()
 
             // check if there's something to send
             final now = System.currentTimeMillis()
@@ -823,11 +959,12 @@ class TowerClient implements TraceObserver {
                 continue
             }
 
-            if( delta > period || tasks.size() >= TASKS_PER_REQUEST || complete ) {
+            if( delta > period || tasks.size() >= batchSize || complete ) {
                 // send
                 final req = makeTasksReq(tasks.values())
-                final resp = sendHttpMessage(urlTraceProgress, req, 'PUT')
-                logHttpResponse(urlTraceProgress, resp)
+                final delivered = sendProgress(req)
+                if( deltaEncoding )
+                    commitTaskDeltas(delivered)
 
                 // clean up for next iteration
                 previous = now
@@ -836,4 +973,65 @@ class TowerClient implements TraceObserver {
         }
     }
 
+    /**
+     * Send a progress request. When the spool is enabled, requests that cannot be delivered
+     * because the endpoint is unreachable or too slow are saved on disk and replayed in order
+     * once the endpoint becomes available again.
+     *
+     * @param req The progress request payload
+     * @return {@code true} when the request has been delivered or spooled to be delivered later
+     */
+    protected boolean sendProgress(Map req) {
+        final json = generator.toJson(req)
+        if( spool == null ) {
+            final resp = sendHttpMessage0(urlTraceProgress, json, 'PUT')
+            logHttpResponse(urlTraceProgress, resp)
+            return isSuccess(resp)
+        }
+
+        // preserve the ordering -- new requests are queued behind the spooled ones
+        if( !spool.isEmpty() && !flushSpool() ) {
+            spool.push(json)
+            return true
+        }
+
+        final resp = sendHttpMessage0(urlTraceProgress, json, 'PUT')
+        if( isRetryable(resp) ) {
+            log.debug "Tower endpoint not available -- spooling progress request; cause: ${resp.message}"
+            spool.push(json)
+            nextSpoolFlush = System.currentTimeMillis() + SPOOL_RETRY_INTERVAL.millis
+            return true
+        }
+        logHttpResponse(urlTraceProgress, resp)
+        return isSuccess(resp)
+    }
+
+    /**
+     * Replay the spooled progress requests
+     *
+     * @return {@code true} when all spooled requests have been delivered
+     */
+    protected boolean flushSpool() {
+        if( System.currentTimeMillis() < nextSpoolFlush )
+            return false
+        while( !spool.isEmpty() ) {
+            final resp = sendHttpMessage0(urlTraceProgress, spool.peek(), 'PUT')
+            if( isRetryable(resp) ) {
+                nextSpoolFlush = System.currentTimeMillis() + SPOOL_RETRY_INTERVAL.millis
+                return false
+            }
+            logHttpResponse(urlTraceProgress, resp)
+            spool.pop()
+        }
+        return true
+    }
+
+    static protected boolean isSuccess(Response resp) {
+        return resp.code >= 200 && resp.code < 300
+    }
+
+    static protected boolean isRetryable(Response resp) {
+        return resp.code == 0 || resp.code >= 500
+    }
+
 }
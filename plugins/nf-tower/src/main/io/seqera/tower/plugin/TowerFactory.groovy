@@ -11,6 +11,8 @@
 
 package io.seqera.tower.plugin
 
+import java.nio.file.Paths
+
 import groovy.transform.CompileStatic
 import groovy.util.logging.Slf4j
 import nextflow.Session
@@ -58,6 +60,16 @@ class TowerFactory implements TraceObserverFactory {
         tower.maxRetries = config.navigate('tower.maxRetries', 5) as int
         tower.backOffBase = config.navigate('tower.backOffBase', SimpleHttpClient.DEFAULT_BACK_OFF_BASE) as int
         tower.backOffDelay = config.navigate('tower.backOffDelay', SimpleHttpClient.DEFAULT_BACK_OFF_DELAY  ) as int
+        // batching, compression and spooling settings
+        tower.batchSize = config.navigate('tower.batchSize', 100) as int
+        tower.compression = config.navigate('tower.compression', false) as boolean
+        tower.deltaEncoding = config.navigate('tower.deltaEncoding', false) as boolean
+        tower.requestTimeout = config.navigate('tower.requestTimeout') as Duration
+        if( config.navigate('tower.spool', false) as boolean ) {
+            final spoolDir = config.navigate('tower.spoolDir') as String
+            final base = spoolDir ? Paths.get(spoolDir) : Paths.get('.nextflow','tower')
+            tower.spool = new TowerSpool(base.resolve(session.uniqueId.toString()))
+        }
         // when 'TOWER_WORKFLOW_ID' is provided in the env, it's a tower made launch
         // therefore the workspace should only be taken from the env
         // otherwise check into the config file and fallback in the env
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2013-2023, Seqera Labs
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * This Source Code Form is "Incompatible With Secondary Licenses", as
+ * defined by the Mozilla Public License, v. 2.0.
+ */
+
+package io.seqera.tower.plugin
+
+import java.nio.file.DirectoryStream
+import java.nio.file.Files
+import java.nio.file.Path
+
+import groovy.transform.CompileStatic
+import groovy.util.logging.Slf4j
+/**
+ * On-disk FIFO spool of the Tower progress requests that could not be delivered
+ * because the endpoint was unreachable or too slow to respond.
+ *
+ * Each request is stored as a separate file named after a monotonic sequence
+ * number, so that requests are replayed in the same order they were created.
+ *
+ * The spool only holds the requests of the current run: they refer to the Tower
+ * workflow created by the run, therefore the files left over by a previous run
+ * with the same session id are deleted when the spool is created, and the requests
+ * still pending when the spool is closed are discarded.
+ */
+@Slf4j
+@CompileStatic
+class TowerSpool {
+
+    private final Path dir
+
+    private final Deque<Path> files = new ArrayDeque<>()
+
+    private long sequence
+
+    TowerSpool(Path dir) {
+        this.dir = dir
+        deleteLeftovers()
+    }
+
+    private void deleteLeftovers() {
+        if( !Files.isDirectory(dir) )
+            return
+        int count = 0
+        try (DirectoryStream<Path> stream = Files.newDirectoryStream(dir, '*.json')) {
+            for( Path file : stream ) {
+                Files.deleteIfExists(file)
+                count++
+            }
+        }
+        if( count )
+            log.debug "Deleted $count Tower request(s) spooled by a previous run in: $dir"
+    }
+
+    Path getDir() { dir }
+
+    /**
+     * @return The number of spooled requests
+     */
+    int size() { files.size() }
+
+    boolean isEmpty() { files.isEmpty() }
+
+    /**
+     * Append a request to the spool
+     *
+     * @param json The request JSON payload
+     */
+    void push(String json) {
+        if( sequence==0 )
+            Files.createDirectories(dir)
+        final file = dir.resolve(String.format('%010d.json', sequence++))
+        file.text = json
+        files.addLast(file)
+        log.trace "Tower spooled request: $file; pending=${files.size()}"
+    }
+
+    /**
+     * @return The JSON payload of the oldest spooled request or {@code null} if the spool is empty
+     */
+    String peek() {
+        final file = files.peekFirst()
+        return file != null ? file.text : null
+    }
+
+    /**
+     * Remove the oldest spooled request
+     */
+    void pop() {
+        final file = files.pollFirst()
+        if( file != null )
+            Files.deleteIfExists(file)
+    }
+
+    /**
+     * Discard the requests not yet delivered and remove the spool directory
+     */
+    void close() {
+        if( files.size() )
+            log.warn "Unable to deliver ${files.size()} Tower request(s) -- pending requests are discarded"
+        try {
+            while( files.size() )
+                pop()
+            if( sequence>0 )
+                Files.deleteIfExists(dir)
+        }
+        catch( IOException e ) {
+            log.debug "Unable to delete Tower spool directory: $dir -- cause: ${e.message ?: e}"
+        }
+    }
+
+}
@@ -15,7 +15,12 @@ import java.nio.file.Files
 import java.time.Instant
 import java.time.OffsetDateTime
 import java.time.ZoneId
+import java.util.zip.GZIPInputStream
 
+import com.sun.net.httpserver.HttpExchange
+import com.sun.net.httpserver.HttpHandler
+import com.sun.net.httpserver.HttpServer
+import groovy.json.JsonSlurper
 import nextflow.Session
 import nextflow.cloud.types.CloudMachineInfo
 import nextflow.cloud.types.PriceModel
@@ -29,6 +34,7 @@ import nextflow.trace.WorkflowStatsObserver
 import nextflow.util.ProcessHelper
 import nextflow.util.SimpleHttpClient
 import spock.lang.Specification
+import spock.lang.Timeout
 /**
  *
  * @author Paolo Di Tommaso <paolo.ditommaso@gmail.com>
@@ -468,4 +474,158 @@ class TowerClientTest extends Specification {
         "local-platform::${ProcessHelper.selfPid()}"    | null          | null        | [TOWER_ALLOW_NEXTFLOW_LOGS:'true']
         'aws-batch::1234z'                              | 'xyz.out'     | 'hola.log'  | [TOWER_ALLOW_NEXTFLOW_LOGS:'true', AWS_BATCH_JOB_ID: '1234z', NXF_OUT_FILE: 'xyz.out', NXF_LOG_FILE: 'hola.log']
     }
+
+    def 'should delta encode task records' () {
+        given:
+        def tower = new TowerClient()
+        tower.deltaEncoding = true
+
+        when:
+        def result = tower.makeTaskDelta([taskId: 1, process: 'foo', status: 'SUBMITTED', submit: 100])
+        tower.commitTaskDeltas(true)
+        then:
+        result == [taskId: 1, process: 'foo', status: 'SUBMITTED', submit: 100]
+
+        when:
+        result = tower.makeTaskDelta([taskId: 1, process: 'foo', status: 'RUNNING', submit: 100, start: 200])
+        tower.commitTaskDeltas(true)
+        then:
+        result == [taskId: 1, status: 'RUNNING', start: 200]
+
+        when:
+        result = tower.makeTaskDelta([taskId: 1, process: 'foo', status: 'COMPLETED', submit: 100, start: 200, complete: 300])
+        tower.commitTaskDeltas(true)
+        then:
+        result == [taskId: 1, status: 'COMPLETED', complete: 300]
+        and:
+        tower.@sentRecords.isEmpty()
+
+        when:
+        result = tower.makeTaskDelta([taskId: 2, process: 'bar', status: 'CACHED'])
+        tower.commitTaskDeltas(true)
+        then:
+        result == [taskId: 2, process: 'bar', status: 'CACHED']
+        tower.@sentRecords.isEmpty()
+    }
+
+    def 'should resend the changed fields when a request is not delivered' () {
+        given:
+        def tower = new TowerClient()
+        tower.deltaEncoding = true
+
+        when:
+        tower.makeTaskDelta([taskId: 1, process: 'foo', status: 'SUBMITTED', submit: 100])
+        tower.commitTaskDeltas(true)
+        def result = tower.makeTaskDelta([taskId: 1, process: 'foo', status: 'RUNNING', submit: 100, start: 200])
+        tower.commitTaskDeltas(false)
+        then:
+        result == [taskId: 1, status: 'RUNNING', start: 200]
+
+        when:
+        // the delta is computed against the last delivered record
+        result = tower.makeTaskDelta([taskId: 1, process: 'foo', status: 'RUNNING', submit: 100, start: 200, cpu: 50])
+        tower.commitTaskDeltas(true)
+        then:
+        result == [taskId: 1, status: 'RUNNING', start: 200, cpu: 50]
+
+        when:
+        // the first record of a task is sent in full until it's delivered
+        result = tower.makeTaskDelta([taskId: 2, process: 'bar', status: 'SUBMITTED'])
+        tower.commitTaskDeltas(false)
+        result = tower.makeTaskDelta([taskId: 2, process: 'bar', status: 'RUNNING'])
+        then:
+        result == [taskId: 2, process: 'bar', status: 'RUNNING']
+    }
+
+    def 'should discard the requests spooled by a previous run' () {
+        given:
+        def folder = Files.createTempDirectory('test')
+        def dir = folder.resolve('spool')
+        Files.createDirectories(dir)
+        dir.resolve('0000000000.json').text = '{"tasks":[]}'
+        dir.resolve('0000000001.json').text = '{"tasks":[]}'
+
+        when:
+        def spool = new TowerSpool(dir)
+        then:
+        spool.isEmpty()
+        Files.list(dir).count() == 0
+
+        when:
+        spool.push('{"tasks":[1]}')
+        spool.push('{"tasks":[2]}')
+        spool.pop()
+        then:
+        spool.size() == 1
+        spool.peek() == '{"tasks":[2]}'
+
+        when:
+        // pending requests are discarded on close
+        spool.close()
+        then:
+        spool.isEmpty()
+        !Files.exists(dir)
+
+        cleanup:
+        folder?.deleteDir()
+    }
+
+    @Timeout(10)
+    def 'should spool progress requests when the endpoint is not available' () {
+        given:
+        def available = false
+        def received = []
+        def server = HttpServer.create(new InetSocketAddress(0), 0)
+        server.createContext('/', new HttpHandler() {
+            @Override
+            void handle(HttpExchange exchange) throws IOException {
+                final body = exchange.requestHeaders.getFirst('Content-Encoding')=='gzip'
+                        ? new GZIPInputStream(exchange.requestBody).text
+                        : exchange.requestBody.text
+                received << new JsonSlurper().parseText(body).tasks[0].taskId
+                final resp = available ? '{}' : '{"message":"Service unavailable"}'
+                exchange.sendResponseHeaders(available ? 200 : 503, resp.bytes.length)
+                exchange.responseBody.withCloseable { it.write(resp.bytes) }
+            }
+        })
+        server.start()
+        and:
+        def folder = Files.createTempDirectory('test')
+        def tower = new TowerClient()
+        tower.@endpoint = "http://localhost:${server.address.port}"
+        tower.@workflowId = 'xyz-123'
+        tower.@httpClient = new SimpleHttpClient().setCompression(true)
+        tower.spool = new TowerSpool(folder.resolve('spool'))
+
+        when:
+        tower.sendProgress([tasks: [[taskId: 1]]])
+        then:
+        received == [1]
+        tower.spool.size() == 1
+
+        when:
+        // the spool is not flushed before the retry interval
+        tower.sendProgress([tasks: [[taskId: 2]]])
+        then:
+        received == [1]
+        tower.spool.size() == 2
+
+        when:
+        available = true
+        tower.@nextSpoolFlush = 0
+        tower.sendProgress([tasks: [[taskId: 3, data: 'x' * 2_000]]])
+        then:
+        received == [1, 1, 2, 3]
+        tower.spool.isEmpty()
+
+        when:
+        tower.spool.close()
+        then:
+        !Files.exists(folder.resolve('spool'))
+
+        cleanup:
+        server?.stop(0)
+        folder?.deleteDir()
+    }
+
 }
@@ -11,7 +11,10 @@
 
 package io.seqera.tower.plugin
 
+import java.nio.file.Paths
+
 import nextflow.Session
+import nextflow.util.Duration
 import spock.lang.Specification
 import spock.lang.Unroll
 
@@ -148,4 +151,33 @@ class TowerFactoryTest extends Specification {
 
     }
 
+    def 'should create with batching and spool options' () {
+        given:
+        def uuid = UUID.randomUUID()
+        def session = Mock(Session) { getUniqueId() >> uuid }
+        def factory = new TowerFactory(env: [TOWER_ACCESS_TOKEN: '123'])
+
+        when:
+        def client = (TowerClient) factory.create(session)[0]
+        then:
+        session.getConfig() >> [tower: [enabled: true]]
+        and:
+        client.batchSize == 100
+        !client.compression
+        !client.deltaEncoding
+        client.requestTimeout == null
+        client.spool == null
+
+        when:
+        client = (TowerClient) factory.create(session)[0]
+        then:
+        session.getConfig() >> [tower: [enabled: true, batchSize: 500, compression: true, deltaEncoding: true, requestTimeout: '30s', spool: true, spoolDir: '/some/dir']]
+        and:
+        client.batchSize == 500
+        client.compression
+        client.deltaEncoding
+        client.requestTimeout == Duration.of('30s')
+        client.spool.dir == Paths.get("/some/dir/$uuid")
+    }
+
 }
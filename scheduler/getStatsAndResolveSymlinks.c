@@ -1,9 +1,15 @@
+#define _GNU_SOURCE
 #include <dirent.h>
+#include <fcntl.h>
 #include <fts.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/vfs.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -15,7 +21,49 @@
 
 #define STACK_MIN_SIZE 1
 
-#define SYMLINK_TARGET_BUFFER_SIZE 500
+#define SYMLINK_TARGET_BUFFER_SIZE PATH_MAX
+
+/*
+ * Scan strategies, picked by the type of the filesystem holding the directory to search:
+ * - fts: the fts traversal stat-ing every entry, used when the filesystem type is unknown
+ * - dtype: stat-free traversal relying on the entry type returned by readdir, for local filesystems
+ * - getdents: traversal reading each directory at once with a large buffer, for NFS, so the entry
+ *   attributes are fetched by a few READDIRPLUS requests instead of a round-trip per entry
+ * - parallel: directories are scanned concurrently by a pool of threads, for Lustre and CephFS,
+ *   to hide the metadata server latency
+ * The strategy can be forced with the NXF_SCAN_STRATEGY environment variable.
+ */
+#define STRATEGY_FTS 0
+#define STRATEGY_DTYPE 1
+#define STRATEGY_GETDENTS 2
+#define STRATEGY_PARALLEL 3
+#define STRATEGY_COUNT 4
+
+static const char * const STRATEGY_NAMES[STRATEGY_COUNT] = { "fts", "dtype", "getdents", "parallel" };
+
+#define STRATEGY_ENV "NXF_SCAN_STRATEGY"
+#define THREADS_ENV "NXF_SCAN_THREADS"
+
+#define NFS_SUPER_MAGIC 0x6969
+#define LUSTRE_SUPER_MAGIC 0x0BD00BD0
+#define CEPH_SUPER_MAGIC 0x00C36400
+#define BEEGFS_SUPER_MAGIC 0x19830326
+#define GPFS_SUPER_MAGIC 0x47504653
+
+#define DIRENT_BUFFER_SIZE (32 * 1024)
+#define NFS_DIRENT_BUFFER_SIZE (1024 * 1024)
+
+#define DEFAULT_SCAN_THREADS 8
+#define MAX_SCAN_THREADS 64
+
+// max number of nested symbolic links followed, as the kernel does when resolving a path
+#define MAX_FOLLOW_DEPTH 40
+
+#define TYPE_DIRECTORY "directory"
+#define TYPE_REGULAR_FILE "regular file"
+#define TYPE_SYMBOLIC_LINK "symbolic link"
+#define TYPE_NON_LOCAL_DIRECTORY "non-local directory"
+#define TYPE_UNKNOWN "unknown"
 
 struct symlink {
     char * src;
@@ -29,7 +77,7 @@ struct stack {
 };
 
 struct stack * newStack(int size) {
-    struct stack * ptr = (struct stack *) malloc(sizeof(struct stack *));
+    struct stack * ptr = (struct stack *) malloc(sizeof(struct stack));
     ptr->top = -1;
     ptr->items = (struct symlink *) malloc(sizeof(struct symlink) * size);
     ptr->size = size;
@@ -87,13 +135,20 @@ void deleteStack(struct stack * ptr) {
 
 int collectFileInformation(char * const * dir_to_search, const int version,
     const char * const local_dir,
-    const char * const result_filename);
+    const char * const result_filename,
+    int * strategy);
+int chooseStrategy(const char * const dir, const int version);
 int getFullDescr(char * const * dir,
     const char * const local_dir,
     FILE * file_ptr);
 int getShortDescrAndTimestamp(char * const * dir,
     const char * const local_dir,
     FILE * file_ptr);
+int writeTimestampHeader(const char * const dir, FILE * file_ptr);
+int scanFileInformation(const char * const dir, const int version,
+    const char * const local_dir,
+    const int strategy,
+    FILE * file_ptr);
 
 
 int main(int arc, char * const argv[]) {
@@ -119,7 +174,8 @@ int main(int arc, char * const argv[]) {
         ? SHORT_DESCR_WITH_TIMESTAMP : FULL_DESCR;
     const char * const result_filename = argv++[0];
     const char * const local_dir = argv++[0];
-    int rc = collectFileInformation(argv, version, local_dir, result_filename);
+    int strategy = STRATEGY_FTS;
+    int rc = collectFileInformation(argv, version, local_dir, result_filename, &strategy);
 
     if ((gettimeofday_rc = clock_gettime(CLOCK_REALTIME, &end_time)) != 0) {
         fprintf(stderr, "Error getting the time of day\n");
@@ -127,14 +183,16 @@ int main(int arc, char * const argv[]) {
     }
     long long int start = start_time.tv_sec * 1000000000 + start_time.tv_nsec;
     long long int end = end_time.tv_sec * 1000000000 + end_time.tv_nsec;
-    printf("%lli\n", (end - start) / 1000000);
+    // the elapsed time is followed by the scan strategy used
+    printf("%lli %s\n", (end - start) / 1000000, STRATEGY_NAMES[strategy]);
 
     return rc;
 }
 
 int collectFileInformation(char * const * dir_to_search, const int version,
     const char * const local_dir, 
-    const char * const result_filename) {
+    const char * const result_filename,
+    int * strategy) {
 
     DIR* dir_ptr = opendir(local_dir);
     if (dir_ptr) {
@@ -157,7 +215,13 @@ int collectFileInformation(char * const * dir_to_search, const int version,
         fprintf(stderr, "Error opening the file %s\n", result_filename);
         return -1;
     }
+    *strategy = chooseStrategy(dir_to_search[0], version);
     int rc;
+    if (*strategy != STRATEGY_FTS) {
+        rc = scanFileInformation(dir_to_search[0], version, local_dir, *strategy, file_ptr);
+        fclose(file_ptr);
+        return rc;
+    }
     switch (version) {
         case FULL_DESCR:
             rc = getFullDescr(dir_to_search, local_dir, file_ptr);
@@ -295,15 +359,10 @@ int getShortDescrAndTimestamp(char * const * dir,
     const char * const local_dir,
     FILE * file_ptr) {
 
-    struct timespec time_now;
-    int gettimeofday_rc;
-    if ((gettimeofday_rc = clock_gettime(CLOCK_REALTIME, &time_now)) != 0) {
-        fprintf(stderr, "Error getting the time of day\n");
-        return gettimeofday_rc;
-    } 
-    fprintf(file_ptr, "%li%li\n", time_now.tv_sec, time_now.tv_nsec);
-
-    fprintf(file_ptr, "%s\n", dir[0]);
+    int header_rc;
+    if ((header_rc = writeTimestampHeader(dir[0], file_ptr)) != 0) {
+        return header_rc;
+    }
 
     int prefix_len = strlen(dir[0]);
     if (dir[0][prefix_len-1] != '/') {
@@ -350,8 +409,8 @@ int getShortDescrAndTimestamp(char * const * dir,
                 break;
             case FTS_SL:
                 file_type = "symbolic link";
-                int bytes_written = readlink(ptr->fts_path, symlink_target_path, SYMLINK_TARGET_BUFFER_SIZE);
-                symlink_target_path[bytes_written] = '\0';
+                int bytes_written = readlink(ptr->fts_path, symlink_target_path, SYMLINK_TARGET_BUFFER_SIZE - 1);
+                symlink_target_path[bytes_written > 0 ? bytes_written : 0] = '\0';
                 // realpath(ptr->fts_path, symlink_target_path);
                 if (symlink_target_path == NULL) {
                     strcpy(symlink_target_path, "");
@@ -423,3 +482,530 @@ int getShortDescrAndTimestamp(char * const * dir,
     fts_close(fts_ptr);
     return 0;
 }
+
+int writeTimestampHeader(const char * const dir, FILE * file_ptr) {
+    struct timespec time_now;
+    int gettimeofday_rc;
+    if ((gettimeofday_rc = clock_gettime(CLOCK_REALTIME, &time_now)) != 0) {
+        fprintf(stderr, "Error getting the time of day\n");
+        return gettimeofday_rc;
+    }
+    fprintf(file_ptr, "%li%li\n", time_now.tv_sec, time_now.tv_nsec);
+
+    fprintf(file_ptr, "%s\n", dir);
+    return 0;
+}
+
+int chooseStrategy(const char * const dir, const int version) {
+    const char * const forced = getenv(STRATEGY_ENV);
+    if (forced != NULL && forced[0] != '\0') {
+        for (int i = 0; i < STRATEGY_COUNT; i++) {
+            if (strcmp(forced, STRATEGY_NAMES[i]) == 0) {
+                return i;
+            }
+        }
+        fprintf(stderr, "Warning: unknown scan strategy '%s'\n", forced);
+    }
+
+    struct statfs fs;
+    if (statfs(dir, &fs) != 0) {
+        return STRATEGY_FTS;
+    }
+    switch ((unsigned long) fs.f_type) {
+        case NFS_SUPER_MAGIC:
+            return STRATEGY_GETDENTS;
+        case LUSTRE_SUPER_MAGIC:
+        case CEPH_SUPER_MAGIC:
+        case BEEGFS_SUPER_MAGIC:
+        case GPFS_SUPER_MAGIC:
+            return STRATEGY_PARALLEL;
+        default:
+            // the entry type returned by readdir is enough to describe the input files,
+            // while the output files description requires the stat of each entry
+            return version == SHORT_DESCR_WITH_TIMESTAMP ? STRATEGY_DTYPE : STRATEGY_FTS;
+    }
+}
+
+/*
+ * Directory traversal used by the dtype, getdents and parallel strategies.
+ * It produces the same records as the fts based traversal, the entries of a directory
+ * are listed at once with getdents64 and described relatively to the directory descriptor.
+ */
+
+struct scan_dirent64 {
+    ino64_t d_ino;
+    off64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+struct dir_listing {
+    char * names;
+    size_t names_len;
+    size_t names_size;
+    size_t * offsets;
+    unsigned char * types;
+    size_t count;
+    size_t size;
+};
+
+struct dir_job {
+    char * path;
+    // the resolved path of the directory when reached through a followed symbolic link
+    char * real;
+    int depth;
+    struct dir_job * next;
+};
+
+struct scan_state {
+    char * buffer;
+    FILE * out;
+    // the subdirectories found by the current job of a parallel scan
+    struct dir_job * deferred;
+};
+
+struct scan_ctx;
+
+typedef int (* descend_fn)(struct scan_ctx * ctx, struct scan_state * state,
+    const char * path, const char * real, int depth);
+
+struct scan_ctx {
+    const char * root;
+    const char * local_dir;
+    int version;
+    int need_stat;
+    int prefix_len;
+    size_t buffer_size;
+    descend_fn descend;
+    FILE * out;
+    // parallel scan state
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct dir_job * jobs;
+    int pending;
+    int failed;
+};
+
+int scanDirectory(struct scan_ctx * ctx, struct scan_state * state,
+    const char * path, const char * real, int depth);
+
+char * joinPath(const char * parent, const char * name) {
+    size_t parent_len = strlen(parent);
+    int has_slash = parent_len > 0 && parent[parent_len - 1] == '/';
+    size_t name_len = strlen(name);
+    char * result = (char *) malloc(parent_len + name_len + 2);
+    if (result == NULL) {
+        return NULL;
+    }
+    memcpy(result, parent, parent_len);
+    if (!has_slash) {
+        result[parent_len++] = '/';
+    }
+    memcpy(result + parent_len, name, name_len + 1);
+    return result;
+}
+
+void freeListing(struct dir_listing * listing) {
+    free(listing->names);
+    free(listing->offsets);
+    free(listing->types);
+}
+
+int addListingEntry(struct dir_listing * listing, const char * name, unsigned char type) {
+    size_t name_len = strlen(name) + 1;
+    if (listing->names_len + name_len > listing->names_size) {
+        size_t size = listing->names_size ? listing->names_size * 2 : 4096;
+        while (size < listing->names_len + name_len) {
+            size *= 2;
+        }
+        char * names = (char *) realloc(listing->names, size);
+        if (names == NULL) {
+            return -1;
+        }
+        listing->names = names;
+        listing->names_size = size;
+    }
+    if (listing->count == listing->size) {
+        size_t size = listing->size ? listing->size * 2 : 64;
+        size_t * offsets = (size_t *) realloc(listing->offsets, sizeof(size_t) * size);
+        if (offsets == NULL) {
+            return -1;
+        }
+        listing->offsets = offsets;
+        unsigned char * types = (unsigned char *) realloc(listing->types, size);
+        if (types == NULL) {
+            return -1;
+        }
+        listing->types = types;
+        listing->size = size;
+    }
+    memcpy(listing->names + listing->names_len, name, name_len);
+    listing->offsets[listing->count] = listing->names_len;
+    listing->types[listing->count] = type;
+    listing->names_len += name_len;
+    listing->count++;
+    return 0;
+}
+
+int listDirectory(int dir_fd, char * buffer, size_t buffer_size, struct dir_listing * listing) {
+    for (;;) {
+        long bytes_read = syscall(SYS_getdents64, dir_fd, buffer, buffer_size);
+        if (bytes_read < 0) {
+            return -1;
+        }
+        if (bytes_read == 0) {
+            return 0;
+        }
+        for (long pos = 0; pos < bytes_read;) {
+            struct scan_dirent64 * entry = (struct scan_dirent64 *) (buffer + pos);
+            pos += entry->d_reclen;
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+                continue;
+            }
+            if (addListingEntry(listing, entry->d_name, entry->d_type) != 0) {
+                return -1;
+            }
+        }
+    }
+}
+
+unsigned char modeToType(mode_t mode) {
+    if (S_ISDIR(mode)) return DT_DIR;
+    if (S_ISREG(mode)) return DT_REG;
+    if (S_ISLNK(mode)) return DT_LNK;
+    return DT_UNKNOWN;
+}
+
+void writeRecord(struct scan_ctx * ctx, FILE * out, const char * path, int exists,
+    const char * target, const char * file_type, const struct stat * st) {
+
+    if (ctx->version == FULL_DESCR) {
+        fprintf(
+            out,
+            "%s;%i;%s;%li;%s;%li%li;%li%li;%li%li\n",
+            path,
+            exists,
+            target,
+            (long) st->st_size,
+            file_type,
+            st->st_ctim.tv_sec, st->st_ctim.tv_nsec,
+            st->st_atim.tv_sec, st->st_atim.tv_nsec,
+            st->st_mtim.tv_sec, st->st_mtim.tv_nsec
+        );
+    } else {
+        fprintf(out, "%s;%i;%s;%s\n", path + ctx->prefix_len, exists, target, file_type);
+    }
+}
+
+// check whether the directory is the target of the link or one of its subdirectories
+int isWithin(const char * dir, const char * target) {
+    if (dir == NULL) {
+        return 0;
+    }
+    size_t target_len = strlen(target);
+    return strncmp(dir, target, target_len) == 0
+        && (dir[target_len] == '/' || dir[target_len] == '\0');
+}
+
+int scanEntry(struct scan_ctx * ctx, struct scan_state * state, int dir_fd,
+    const char * name, unsigned char type,
+    const char * path, const char * real, int depth) {
+
+    struct stat st;
+    memset(&st, 0, sizeof(st));
+    if (ctx->need_stat || type == DT_UNKNOWN) {
+        // entries vanished in the meantime are reported as unknown, as done by fts
+        type = fstatat(dir_fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0 ? modeToType(st.st_mode) : DT_UNKNOWN;
+    }
+
+    char target[SYMLINK_TARGET_BUFFER_SIZE];
+    target[0] = '\0';
+    const char * file_type;
+    int exists = 1;
+    int is_dir = 0;
+    int follow = 0;
+    switch (type) {
+        case DT_DIR:
+            file_type = TYPE_DIRECTORY;
+            is_dir = 1;
+            break;
+        case DT_REG:
+            file_type = TYPE_REGULAR_FILE;
+            break;
+        case DT_LNK:
+            file_type = TYPE_SYMBOLIC_LINK;
+            if (ctx->version == FULL_DESCR) {
+                realpath(path, target);
+            } else {
+                ssize_t bytes_written = readlinkat(dir_fd, name, target, sizeof(target) - 1);
+                target[bytes_written > 0 ? bytes_written : 0] = '\0';
+            }
+            // relative targets are resolved from the link directory, as fts changes into it
+            exists = 1 + faccessat(dir_fd, target, F_OK, 0); // test for file existence
+            if (!exists) {
+                break;
+            }
+            struct stat target_file_stat;
+            int stat_rv;
+            if ((stat_rv = fstatat(dir_fd, target, &target_file_stat, 0)) != 0) {
+                fprintf(stderr, "Error reading the file %s\n", target);
+                return stat_rv;
+            }
+            if (S_ISDIR(target_file_stat.st_mode)) {
+                // if target is not local, we skip it
+                if (strncmp(target, ctx->local_dir, strlen(ctx->local_dir)) != 0) {
+                    file_type = TYPE_NON_LOCAL_DIRECTORY;
+                    break;
+                }
+                file_type = TYPE_DIRECTORY;
+                // if target is within the directory we are searching, we skip it,
+                // to prevent searching a directory more than once
+                if (strncmp(target, ctx->root, strlen(ctx->root)) == 0) {
+                    break;
+                }
+                follow = 1;
+            } else if (S_ISREG(target_file_stat.st_mode)) {
+                file_type = TYPE_REGULAR_FILE;
+            }
+            break;
+
+        default:
+            file_type = TYPE_UNKNOWN;
+            break;
+    }
+    // the entries reached through a followed link are reported with their resolved path
+    if (!follow && real != NULL && strcmp(file_type, TYPE_SYMBOLIC_LINK) != 0) {
+        snprintf(target, sizeof(target), "%s", real);
+    }
+    writeRecord(ctx, state->out, path, exists, target, file_type, &st);
+
+    if (is_dir) {
+        return ctx->descend(ctx, state, path, real, depth);
+    }
+    // do not follow links pointing to a directory being searched, fts reports them as cycles
+    if (follow && depth < MAX_FOLLOW_DEPTH && !isWithin(real, target)) {
+        return ctx->descend(ctx, state, path, target, depth + 1);
+    }
+    return 0;
+}
+
+int scanDirectory(struct scan_ctx * ctx, struct scan_state * state,
+    const char * path, const char * real, int depth) {
+
+    int dir_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) {
+        // unreadable directories are reported but not traversed
+        return 0;
+    }
+    struct dir_listing listing;
+    memset(&listing, 0, sizeof(listing));
+    if (listDirectory(dir_fd, state->buffer, ctx->buffer_size, &listing) != 0) {
+        fprintf(stderr, "Error traversing the directory %s\n", path);
+    }
+
+    int rc = 0;
+    for (size_t i = 0; i < listing.count && rc == 0; i++) {
+        const char * name = listing.names + listing.offsets[i];
+        char * child_path = joinPath(path, name);
+        char * child_real = real != NULL ? joinPath(real, name) : NULL;
+        if (child_path == NULL || (real != NULL && child_real == NULL)) {
+            fprintf(stderr, "Error allocating memory\n");
+            rc = -1;
+        } else {
+            rc = scanEntry(ctx, state, dir_fd, name, listing.types[i], child_path, child_real, depth);
+        }
+        free(child_path);
+        free(child_real);
+    }
+    freeListing(&listing);
+    close(dir_fd);
+    return rc;
+}
+
+int descendInline(struct scan_ctx * ctx, struct scan_state * state,
+    const char * path, const char * real, int depth) {
+    return scanDirectory(ctx, state, path, real, depth);
+}
+
+struct dir_job * newJob(const char * path, const char * real, int depth) {
+    struct dir_job * job = (struct dir_job *) malloc(sizeof(struct dir_job));
+    if (job == NULL) {
+        return NULL;
+    }
+    job->path = strdup(path);
+    job->real = real != NULL ? strdup(real) : NULL;
+    job->depth = depth;
+    job->next = NULL;
+    return job;
+}
+
+void freeJob(struct dir_job * job) {
+    free(job->path);
+    free(job->real);
+    free(job);
+}
+
+// subdirectories are queued once the records of the current directory have been written
+int deferDirectory(struct scan_ctx * ctx, struct scan_state * state,
+    const char * path, const char * real, int depth) {
+    // the context is required by the descend_fn signature only
+    (void) ctx;
+    struct dir_job * job = newJob(path, real, depth);
+    if (job == NULL) {
+        fprintf(stderr, "Error allocating memory\n");
+        return -1;
+    }
+    job->next = state->deferred;
+    state->deferred = job;
+    return 0;
+}
+
+void * scanWorker(void * arg) {
+    struct scan_ctx * ctx = (struct scan_ctx *) arg;
+    struct scan_state state;
+    state.buffer = (char *) malloc(ctx->buffer_size);
+    state.deferred = NULL;
+    char * chunk = NULL;
+    size_t chunk_len = 0;
+    for (;;) {
+        pthread_mutex_lock(&ctx->lock);
+        while (ctx->jobs == NULL && ctx->pending > 0 && !ctx->failed) {
+            pthread_cond_wait(&ctx->cond, &ctx->lock);
+        }
+        if (ctx->jobs == NULL || ctx->failed) {
+            pthread_mutex_unlock(&ctx->lock);
+            break;
+        }
+        struct dir_job * job = ctx->jobs;
+        ctx->jobs = job->next;
+        pthread_mutex_unlock(&ctx->lock);
+
+        // the records of a directory are collected in memory and written at once
+        int rc = -1;
+        state.out = state.buffer != NULL ? open_memstream(&chunk, &chunk_len) : NULL;
+        if (state.out != NULL) {
+            rc = scanDirectory(ctx, &state, job->path, job->real, job->depth);
+            fclose(state.out);
+        }
+
+        pthread_mutex_lock(&ctx->lock);
+        if (rc != 0) {
+            ctx->failed = 1;
+        } else if (chunk_len > 0) {
+            fwrite(chunk, 1, chunk_len, ctx->out);
+        }
+        while (state.deferred != NULL) {
+            struct dir_job * next = state.deferred->next;
+            state.deferred->next = ctx->jobs;
+            ctx->jobs = state.deferred;
+            ctx->pending++;
+            state.deferred = next;
+        }
+        ctx->pending--;
+        pthread_cond_broadcast(&ctx->cond);
+        pthread_mutex_unlock(&ctx->lock);
+
+        free(chunk);
+        chunk = NULL;
+        chunk_len = 0;
+        freeJob(job);
+    }
+    free(state.buffer);
+    return NULL;
+}
+
+int scanThreads() {
+    const char * const value = getenv(THREADS_ENV);
+    int threads = value != NULL ? atoi(value) : DEFAULT_SCAN_THREADS;
+    if (threads < 1) {
+        return DEFAULT_SCAN_THREADS;
+    }
+    return threads > MAX_SCAN_THREADS ? MAX_SCAN_THREADS : threads;
+}
+
+int scanParallel(struct scan_ctx * ctx) {
+    ctx->descend = deferDirectory;
+    ctx->jobs = newJob(ctx->root, NULL, 0);
+    if (ctx->jobs == NULL) {
+        fprintf(stderr, "Error allocating memory\n");
+        return -1;
+    }
+    ctx->pending = 1;
+    ctx->failed = 0;
+    pthread_mutex_init(&ctx->lock, NULL);
+    pthread_cond_init(&ctx->cond, NULL);
+
+    // the calling thread is one of the workers
+    int threads = scanThreads();
+    pthread_t workers[MAX_SCAN_THREADS];
+    int started = 0;
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, scanWorker, ctx) == 0) {
+            started++;
+        }
+    }
+    scanWorker(ctx);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    while (ctx->jobs != NULL) {
+        struct dir_job * next = ctx->jobs->next;
+        freeJob(ctx->jobs);
+        ctx->jobs = next;
+    }
+    pthread_cond_destroy(&ctx->cond);
+    pthread_mutex_destroy(&ctx->lock);
+    return ctx->failed ? -1 : 0;
+}
+
+int scanFileInformation(const char * const dir, const int version,
+    const char * const local_dir,
+    const int strategy,
+    FILE * file_ptr) {
+
+    struct scan_ctx ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.root = dir;
+    ctx.local_dir = local_dir;
+    ctx.version = version;
+    ctx.need_stat = version == FULL_DESCR;
+    ctx.buffer_size = strategy == STRATEGY_GETDENTS ? NFS_DIRENT_BUFFER_SIZE : DIRENT_BUFFER_SIZE;
+    ctx.out = file_ptr;
+
+    if (version == FULL_DESCR) {
+        struct stat st;
+        if (lstat(dir, &st) != 0) {
+            fprintf(stderr, "Error reading the file %s\n", dir);
+            return -1;
+        }
+        writeRecord(&ctx, file_ptr, dir, 1, "", TYPE_DIRECTORY, &st);
+    } else {
+        int header_rc;
+        if ((header_rc = writeTimestampHeader(dir, file_ptr)) != 0) {
+            return header_rc;
+        }
+        ctx.prefix_len = strlen(dir);
+        if (dir[ctx.prefix_len - 1] != '/') {
+            ctx.prefix_len++;
+        }
+    }
+
+    if (strategy == STRATEGY_PARALLEL) {
+        return scanParallel(&ctx);
+    }
+
+    ctx.descend = descendInline;
+    struct scan_state state;
+    state.buffer = (char *) malloc(ctx.buffer_size);
+    state.out = file_ptr;
+    state.deferred = NULL;
+    if (state.buffer == NULL) {
+        fprintf(stderr, "Error allocating memory\n");
+        return -1;
+    }
+    int rc = scanDirectory(&ctx, &state, dir, NULL, 0);
+    free(state.buffer);
+    return rc;
+}